@@ -0,0 +1,89 @@
+/*
+ *  This file is covered by the Ruby license. See LICENSE.txt for more details.
+ *
+ *  Copyright (C) 2007-2012 Noam Chitayat. All rights reserved.
+ */
+
+#ifndef ATOMIC_H
+#define ATOMIC_H
+
+#ifdef _MSC_VER
+   #include <intrin.h>
+#endif
+
+/**
+ * Atomic operations on integers shared between threads, built on the compiler's
+ * intrinsics (since neither C++98 nor SDL 1.2 provides any).
+ * Every operation is a full memory barrier.
+ *
+ * @author Noam Chitayat
+ */
+class Atomic
+{
+   public:
+      /**
+       * Replace a value if it still holds the expected value.
+       *
+       * @param target The value to replace.
+       * @param expected The value that the target is expected to hold.
+       * @param desired The value to replace the target with.
+       *
+       * @return The value that the target held before the operation (the target was replaced iff this equals expected).
+       */
+      static long compareAndSwap(volatile long* target, long expected, long desired)
+      {
+#ifdef _MSC_VER
+         return _InterlockedCompareExchange(target, desired, expected);
+#else
+         return __sync_val_compare_and_swap(target, expected, desired);
+#endif
+      }
+
+      /**
+       * Add to a value.
+       *
+       * @param target The value to add to.
+       * @param amount The amount to add.
+       *
+       * @return The value after the addition.
+       */
+      static long add(volatile long* target, long amount)
+      {
+#ifdef _MSC_VER
+         return _InterlockedExchangeAdd(target, amount) + amount;
+#else
+         return __sync_add_and_fetch(target, amount);
+#endif
+      }
+
+      /**
+       * Read a value, so that anything written before it was stored is visible afterwards.
+       *
+       * @param source The value to read.
+       *
+       * @return The value.
+       */
+      static long load(volatile long* source)
+      {
+         return compareAndSwap(source, 0, 0);
+      }
+
+      /**
+       * Write a value, so that anything written before it is visible to whoever loads it.
+       *
+       * @param target The value to write.
+       * @param value The value to write.
+       */
+      static void store(volatile long* target, long value)
+      {
+#ifdef _MSC_VER
+         _InterlockedExchange(target, value);
+#else
+         __sync_synchronize();
+         *target = value;
+         __sync_synchronize();
+#endif
+      }
+};
+
+#endif
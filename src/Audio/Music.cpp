@@ -5,6 +5,7 @@
  */
 
 #include "Music.h"
+#include "GraphicsUtil.h"
 #include "DebugUtils.h"
 
 const int debugFlag = DEBUG_AUDIO;
@@ -17,6 +18,13 @@ Music::Music(ResourceKey name) : Resource(name)
 
 void Music::load(const std::string& path)
 {
+   if(GraphicsUtil::isHeadless())
+   {
+      // The audio device is not opened in headless mode, so the music stays silent
+      music = NULL;
+      return;
+   }
+
    music = Mix_LoadMUS(path.c_str());
 
    if(music == NULL)
@@ -6,12 +6,15 @@
 
 #include "Sound.h"
 #include "Task.h"
+#include "GraphicsUtil.h"
+#include "JobSystem.h"
 
 #include "DebugUtils.h"
 
 const int debugFlag = DEBUG_AUDIO;
 
 std::map<int, Sound*> Sound::playingList;
+std::map<int, int> Sound::staleCompletions;
 
 bool Sound::ownsChannel(Sound* sound, int channel)
 {
@@ -20,25 +23,62 @@ bool Sound::ownsChannel(Sound* sound, int channel)
 
 void Sound::channelFinished(int channel)
 {
-   DEBUG("Channel %d finished playing.", channel);
+   DEBUG_VERBOSE("Channel %d finished playing.", channel);
+
+   // This usually runs on the audio thread, so the sound is finished later on the main thread
+   if(!JobSystem::post(&Sound::completeChannel, NULL, channel))
+   {
+      DEBUG("Unable to post the completion of channel %d.", channel);
+   }
+}
+
+void Sound::completeChannel(void* context, int channel)
+{
+   if(staleCompletions[channel] > 0)
+   {
+      // The sound that played on this channel was already finished on the main thread
+      --staleCompletions[channel];
+      return;
+   }
+
    Sound* finishedSound = playingList[channel];
+   playingList[channel] = NULL;
 
    if(finishedSound != NULL)
-   {  finishedSound->finished();
+   {
+      finishedSound->finished();
    }
 }
 
+void Sound::finishEarly(int channel)
+{
+   Sound* finishedSound = playingList[channel];
+   playingList[channel] = NULL;
+   ++staleCompletions[channel];
+   finishedSound->finished();
+}
+
 Sound::Sound(ResourceKey name) : Resource(name), playingChannel(-1)
 {
 }
 
 void Sound::load(const std::string& path)
 {
+   if(GraphicsUtil::isHeadless())
+   {
+      // The audio device is not opened in headless mode, so playing the sound finishes right away
+      sound = NULL;
+      return;
+   }
+
    /**
     * \todo This should only be called once. Move it into initialization code.
     */
    Mix_ChannelFinished(&Sound::channelFinished);
 
+   // Create the job system now, so that the channel callbacks never have to
+   JobSystem::getInstance();
+
    DEBUG("Loading WAV %s", path.c_str());
    sound = Mix_LoadWAV(path.c_str());
 
@@ -68,12 +108,18 @@ void Sound::play(Task* task)
       return;
    }
 
-   playingChannel = Mix_PlayChannel(-1, sound, 0);
-   if(playingChannel == -1)
+   const int channel = Mix_PlayChannel(-1, sound, 0);
+   if(channel == -1)
    {
       DEBUG("There was a problem playing the sound ""%s"": %s", getResourceName().c_str(), Mix_GetError());
    }
+   else if(playingList[channel] != NULL)
+   {
+      // The channel finished playing another sound, but its completion hasn't been handled yet
+      finishEarly(channel);
+   }
 
+   playingChannel = channel;
    playingList[playingChannel] = this;
    playTask = task;
 #endif
@@ -89,7 +135,7 @@ void Sound::stop()
 
 void Sound::finished()
 {
-   DEBUG("Sound finished.");
+   DEBUG_VERBOSE("Sound finished.");
    if(playTask)
    {
       playTask->signal();
@@ -105,7 +151,9 @@ Sound::~Sound()
    {
       if(ownsChannel(this, playingChannel))
       {
+         // The channel's completion is handled after this sound is gone, so finish the sound now
          stop();
+         finishEarly(playingChannel);
       }
 
       Mix_FreeChunk(sound);
@@ -40,9 +40,38 @@ class Sound : public Resource
     */
    static bool ownsChannel(Sound* sound, int channel);
 
-   /** A callback used when a channel is released and its sound is done playing. */
+   /**
+    * The number of completions queued for each channel whose sounds were already
+    * finished early, which have to be skipped when they reach the main thread.
+    */
+   static std::map<int, int> staleCompletions;
+
+   /**
+    * A callback used when a channel is released and its sound is done playing.
+    * Called by SDL_mixer (usually on the audio thread), so it only posts the
+    * channel's completion to the main thread.
+    *
+    * @param channel The channel that finished playing.
+    */
    static void channelFinished(int channel);
 
+   /**
+    * Finish the sound that played on a channel. Run on the main thread once the
+    * completion posted by channelFinished reaches it.
+    *
+    * @param context Unused.
+    * @param channel The channel that finished playing.
+    */
+   static void completeChannel(void* context, int channel);
+
+   /**
+    * Finish the sound that played on a channel before the channel's completion
+    * reaches the main thread, and skip the completion when it does.
+    *
+    * @param channel A channel that finished playing, or was halted.
+    */
+   static void finishEarly(int channel);
+
    /** A Task object used to signal waiting coroutines when this sound object is done playing. */
    Task* playTask;
 
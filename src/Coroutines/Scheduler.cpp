@@ -7,6 +7,7 @@
 #include "Scheduler.h"
 #include "Task.h"
 #include "Thread.h"
+#include "Tracer.h"
 #include "DebugUtils.h"
 
 const int debugFlag = DEBUG_SCHEDULER;
@@ -50,13 +51,13 @@ bool Scheduler::hasRunningThread()
 
 int Scheduler::block(Task* pendingTask)
 {
-   DEBUG("Blocking thread %d on task %d...", runningThread->getId(), pendingTask->getTaskId());
+   DEBUG_VERBOSE("Blocking thread %d on task %d...", runningThread->getId(), pendingTask->getTaskId());
 
    // Find the thread in the ready list
    if(readyThreads.find(runningThread) != readyThreads.end())
    {
       // If the thread is in the ready list, push it into the finished thread list
-      DEBUG("Putting thread %d in the finish list", runningThread->getId());
+      DEBUG_VERBOSE("Putting thread %d in the finish list", runningThread->getId());
       finishedThreads.push(runningThread);
       printFinishedQueue();
 
@@ -68,18 +69,18 @@ int Scheduler::block(Task* pendingTask)
       T_T("Attempting to block a thread that isn't ready/running!");
    }
 
-   DEBUG("Yielding: %d", runningThread->getId());
+   DEBUG_VERBOSE("Yielding: %d", runningThread->getId());
    return runningThread->yield();
 }
 
 void Scheduler::taskDone(TaskId finishedTask)
 {
-   DEBUG("Task %d finished.", finishedTask);
+   DEBUG_VERBOSE("Task %d finished.", finishedTask);
 
    Thread* resumingThread = blockedThreads[finishedTask];
    if(resumingThread)
    {
-      DEBUG("Putting thread %d on resume list...", resumingThread->getId());
+      DEBUG_VERBOSE("Putting thread %d on resume list...", resumingThread->getId());
 
       // Put the resumed thread onto the unstarted stack
       unstartedThreads.insert(resumingThread);
@@ -91,13 +92,13 @@ void Scheduler::taskDone(TaskId finishedTask)
 
 int Scheduler::join(Thread* thread)
 {
-   DEBUG("Joining thread %d on thread %d...", runningThread->getId(), thread->getId());
+   DEBUG_VERBOSE("Joining thread %d on thread %d...", runningThread->getId(), thread->getId());
 
    // Find the thread in the ready list
    if(readyThreads.find(runningThread) != readyThreads.end())
    {
       // If the thread is in the ready list, push it into the finished thread list
-      DEBUG("Putting thread %d in the finish list", runningThread->getId());
+      DEBUG_VERBOSE("Putting thread %d in the finish list", runningThread->getId());
       finishedThreads.push(runningThread);
       printFinishedQueue();
 
@@ -109,7 +110,7 @@ int Scheduler::join(Thread* thread)
       T_T("Attempting to suspend a thread that isn't ready/running!");
    }
 
-   DEBUG("Yielding: %d", runningThread->getId());
+   DEBUG_VERBOSE("Yielding: %d", runningThread->getId());
    return runningThread->yield();
 }
 
@@ -122,7 +123,7 @@ void Scheduler::threadDone(Thread* thread)
    if(resumingThread)
    {
       // If there is such a thread, put it on the unstarted thread list again
-      DEBUG("Putting thread %d on resume list...", resumingThread->getId());
+      DEBUG_VERBOSE("Putting thread %d on resume list...", resumingThread->getId());
       unstartedThreads.insert(resumingThread);
 
       // Clear the joining thread out of the joining list
@@ -135,7 +136,7 @@ void Scheduler::finished(Thread* thread)
    // Check for any joins on this thread, then push it onto the finished
    // thread list
    threadDone(thread);
-   DEBUG("Putting thread %d in the finish list", thread->getId());
+   DEBUG_VERBOSE("Putting thread %d in the finish list", thread->getId());
    printFinishedQueue();
    finishedThreads.push(thread);
    deletedThreads.push(thread);
@@ -143,6 +144,8 @@ void Scheduler::finished(Thread* thread)
 
 void Scheduler::runThreads(long timePassed)
 {
+   TRACE_ZONE("Scheduler::runThreads");
+
    // If there are any threads on the unstarted list, then put them all into
    // the ready list and clear the unstarted list
    if(!unstartedThreads.empty())
@@ -160,7 +163,11 @@ void Scheduler::runThreads(long timePassed)
       try
       {
          // Run/resume the thread
-         bool scriptIsFinished = runningThread->resume(timePassed);
+         bool scriptIsFinished;
+         {
+            TRACE_ZONE("Thread::resume");
+            scriptIsFinished = runningThread->resume(timePassed);
+         }
    
          if(scriptIsFinished)
          {
@@ -185,7 +192,7 @@ void Scheduler::runThreads(long timePassed)
    while(!finishedThreads.empty())
    {
       Thread* thread = finishedThreads.front();
-      DEBUG("Removing thread %d from ready list...", thread->getId());
+      DEBUG_VERBOSE("Removing thread %d from ready list...", thread->getId());
 
       readyThreads.erase(thread);
       finishedThreads.pop();
@@ -195,7 +202,7 @@ void Scheduler::runThreads(long timePassed)
    while(!deletedThreads.empty())
    {
       Thread* thread = deletedThreads.front();
-      DEBUG("Deleting thread %d", thread->getId());
+      DEBUG_VERBOSE("Deleting thread %d", thread->getId());
       delete thread;
       deletedThreads.pop();
    }
@@ -5,26 +5,217 @@
  */
 
 #include "DebugUtils.h"
+#include "LockFreeQueue.h"
+#include <SDL.h>
 #include <stdio.h>
 #include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
 
-long DebugUtils::debugFlags = DEBUG_ALL;
+#ifdef _MSC_VER
+   #define vsnprintf _vsnprintf
+#endif
+
+volatile long DebugUtils::debugFlags = DEBUG_ALL;
+
+/** The longest message (including the terminating null) that can be queued for the log thread. */
+static const int MAX_MESSAGE_LENGTH = 512;
+
+/** How long (in ms) the log thread waits for more messages after writing the queued ones. */
+static const int LOG_THREAD_INTERVAL = 10;
+
+/** A message queued for the log thread. */
+struct LogMessage
+{
+   /** The text of the message (null-terminated). */
+   char text[MAX_MESSAGE_LENGTH];
+};
+
+/** The messages waiting for the log thread to write them. */
+static LockFreeQueue<LogMessage, 1024> logQueue;
+
+/** The number of messages dropped because the queue was full, since the last report. */
+static volatile long droppedMessages = 0;
+
+/** The log thread, or NULL if it isn't running. */
+static SDL_Thread* logThread = NULL;
+
+/** 1 while the log thread should keep running, 0 once it should stop. */
+static volatile long logThreadRunning = 0;
+
+/** Maps the name of a debug flag (as set from the debug console) to the flag. */
+struct DebugFlagName
+{
+   /** The name of the flag. */
+   const char* name;
+
+   /** The flag. */
+   long flag;
+};
+
+static const DebugFlagName FLAG_NAMES[] =
+{
+   { "main", DEBUG_MAIN },
+   { "exec_stack", DEBUG_EXEC_STACK },
+   { "game_state", DEBUG_GAME_STATE },
+   { "graphics", DEBUG_GRAPHICS },
+   { "edwt", DEBUG_EDWT },
+   { "title", DEBUG_TITLE },
+   { "tile_eng", DEBUG_TILE_ENG },
+   { "menu", DEBUG_MENU },
+   { "battle_eng", DEBUG_BATTLE_ENG },
+   { "overworld", DEBUG_OVERWORLD },
+   { "dia_contr", DEBUG_DIA_CONTR },
+   { "res_load", DEBUG_RES_LOAD },
+   { "script_eng", DEBUG_SCRIPT_ENG },
+   { "audio", DEBUG_AUDIO },
+   { "scheduler", DEBUG_SCHEDULER },
+   { "npc", DEBUG_NPC },
+   { "pathfinder", DEBUG_PATHFINDER },
+   { "sprite", DEBUG_SPRITE },
+   { "player", DEBUG_PLAYER },
+   { "entity_grid", DEBUG_ENTITY_GRID },
+   { "messaging", DEBUG_MESSAGING },
+   { "all", DEBUG_ALL }
+};
 
 void DebugUtils::print(long flag, std::string str)
 {
-   if(debugFlags & flag) fprintf(stderr, "%s", str.c_str());
+   if(debugFlags & flag) write(str.c_str());
 }
 
 void DebugUtils::print(long flag, const char* fmt, ...)
 {
    if(debugFlags & flag)
    {
+      // Leave room for the newline
+      char message[MAX_MESSAGE_LENGTH];
       va_list argp;
       va_start(argp, fmt);
-      vfprintf(stderr, fmt, argp);
-      fprintf(stderr, "\n");
+      const int length = vsnprintf(message, MAX_MESSAGE_LENGTH - 1, fmt, argp);
       va_end(argp);
+
+      if(length < 0 || length >= MAX_MESSAGE_LENGTH - 1)
+      {
+         // The message is too long to queue, so print it right away instead of cutting it off
+         va_start(argp, fmt);
+         vfprintf(stderr, fmt, argp);
+         fprintf(stderr, "\n");
+         va_end(argp);
+         return;
+      }
+
+      message[length] = '\n';
+      message[length + 1] = '\0';
+      write(message);
+   }
+}
+
+void DebugUtils::write(const char* message)
+{
+   if(Atomic::load(&logThreadRunning) == 0)
+   {
+      fputs(message, stderr);
+      return;
+   }
+
+   const size_t length = strlen(message);
+   if(length >= size_t(MAX_MESSAGE_LENGTH))
+   {
+      fputs(message, stderr);
+      return;
+   }
+
+   LogMessage logMessage;
+   memcpy(logMessage.text, message, length + 1);
+   if(!logQueue.push(logMessage))
+   {
+      Atomic::add(&droppedMessages, 1);
+   }
+}
+
+void DebugUtils::drainQueue()
+{
+   LogMessage logMessage;
+   while(logQueue.pop(logMessage))
+   {
+      fputs(logMessage.text, stderr);
+   }
+
+   const long dropped = Atomic::load(&droppedMessages);
+   if(dropped > 0)
+   {
+      Atomic::add(&droppedMessages, -dropped);
+      fprintf(stderr, "(%ld debug messages were dropped because the log queue was full.)\n", dropped);
+   }
+}
+
+int DebugUtils::runLogThread(void* data)
+{
+   while(Atomic::load(&logThreadRunning) != 0)
+   {
+      drainQueue();
+      SDL_Delay(LOG_THREAD_INTERVAL);
+   }
+
+   return 0;
+}
+
+void DebugUtils::startLogThread()
+{
+   static bool stopRegistered = false;
+   if(logThread != NULL) return;
+
+   Atomic::store(&logThreadRunning, 1);
+   logThread = SDL_CreateThread(runLogThread, NULL);
+   if(logThread == NULL)
+   {
+      // Without a log thread, messages are printed directly
+      Atomic::store(&logThreadRunning, 0);
+      return;
    }
+
+   if(!stopRegistered)
+   {
+      atexit(stopLogThread);
+      stopRegistered = true;
+   }
+}
+
+void DebugUtils::stopLogThread()
+{
+   if(logThread == NULL) return;
+
+   Atomic::store(&logThreadRunning, 0);
+   SDL_WaitThread(logThread, NULL);
+   logThread = NULL;
+
+   // Write whatever was queued while the log thread was finishing
+   drainQueue();
+}
+
+bool DebugUtils::setFlagEnabled(const std::string& name, bool enabled)
+{
+   const unsigned int numFlags = sizeof(FLAG_NAMES) / sizeof(FLAG_NAMES[0]);
+   for(unsigned int i = 0; i < numFlags; ++i)
+   {
+      if(name == FLAG_NAMES[i].name)
+      {
+         const long flag = FLAG_NAMES[i].flag;
+         long flags = Atomic::load(&debugFlags);
+         for(;;)
+         {
+            const long newFlags = enabled ? (flags | flag) : (flags & ~flag);
+            const long previousFlags = Atomic::compareAndSwap(&debugFlags, flags, newFlags);
+            if(previousFlags == flags) break;
+            flags = previousFlags;
+         }
+
+         return true;
+      }
+   }
+
+   return false;
 }
 
 void DebugUtils::pause()
@@ -10,6 +10,15 @@
 #include <string>
 #include "Exception.h"
 
+// The severities of debug statements
+#define DEBUG_LEVEL_VERBOSE 0    // Statements in hot code (per path node, per audio channel, per thread switch)
+#define DEBUG_LEVEL_NORMAL  1    // Everything else
+
+// Debug statements below this severity are stripped out at compile time
+#ifndef DEBUG_MIN_LEVEL
+   #define DEBUG_MIN_LEVEL DEBUG_LEVEL_NORMAL
+#endif
+
 // Make a nice easy access macro for debug statements in the code
 #ifdef DEBUG_MODE
    #define DEBUG(x, ...) DebugUtils::print(debugFlag, x, ## __VA_ARGS__)
@@ -19,6 +28,12 @@
    #define DEBUG_PAUSE
 #endif
 
+#if defined(DEBUG_MODE) && DEBUG_MIN_LEVEL <= DEBUG_LEVEL_VERBOSE
+   #define DEBUG_VERBOSE(x, ...) DebugUtils::print(debugFlag, x, ## __VA_ARGS__)
+#else
+   #define DEBUG_VERBOSE(x, ...)
+#endif
+
 #ifndef __PRETTY_FUNCTION__
    #define __PRETTY_FUNCTION__ __FILE__
 #endif
@@ -59,6 +74,11 @@
  *  Also implements functionality for reading program args and setting
  *  debug flags appropriately.
  *
+ *  While the log thread runs, printing only formats the message into a lock-free
+ *  queue, and the log thread writes the queued messages to the error log.
+ *  That way, debug output doesn't stall the thread being debugged (and distort its timing).
+ *  If the queue is full, messages are dropped, and the number of dropped messages is logged later.
+ *
  *  @author Noam Chitayat
  */
 class DebugUtils
@@ -67,9 +87,53 @@ class DebugUtils
     * Debug flags to output on. This variable controls which components of
     * the game will actually output when DEBUG is used.
     */
-   static long debugFlags;
+   static volatile long debugFlags;
+
+   /**
+    * Queue a message for the log thread, or print it right away if the log thread isn't running.
+    *
+    * @param message The message to print.
+    */
+   static void write(const char* message);
+
+   /**
+    * Writes the queued messages to the error log until the log thread is stopped.
+    *
+    * @param data Unused.
+    *
+    * @return 0.
+    */
+   static int runLogThread(void* data);
+
+   /**
+    * Write all the queued messages to the error log.
+    */
+   static void drainQueue();
 
    public:
+      /**
+       * Start writing debug output on a separate thread.
+       * The thread is stopped automatically when the program exits.
+       */
+      static void startLogThread();
+
+      /**
+       * Write any queued messages and stop the log thread.
+       * Debug output is written directly to the error log again afterwards.
+       */
+      static void stopLogThread();
+
+      /**
+       * Turn the debug output of a component on or off.
+       *
+       * @param name The name of the component's debug flag, without the DEBUG_ prefix
+       *             (such as "pathfinder" or "script_eng"), or "all" for every component.
+       * @param enabled true iff the component's debug output should be printed.
+       *
+       * @return true iff there is a debug flag with the given name.
+       */
+      static bool setFlagEnabled(const std::string& name, bool enabled);
+
       /**
        * Print a string to the error log if the associated debug flag is active
        *
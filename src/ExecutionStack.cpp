@@ -8,9 +8,17 @@
 #include "GraphicsUtil.h"
 #include "DebugUtils.h"
 #include "GameState.h"
+#include "InputBuffer.h"
+#include "FrameTelemetry.h"
+#include "JobSystem.h"
+#include <SDL.h>
 
 const int debugFlag = DEBUG_EXEC_STACK;
 
+ExecutionStack::ExecutionStack() : previousTime(0), accumulatedTime(0), tickIndex(0), tickCount(0)
+{
+}
+
 ExecutionStack::~ExecutionStack()
 {
    // Delete all states on the stack
@@ -33,18 +41,115 @@ void ExecutionStack::pushState(GameState* newState)
    newState->activate();
 }
 
+void ExecutionStack::restartClock()
+{
+   previousTime = SDL_GetTicks();
+   accumulatedTime = 0;
+}
+
+long ExecutionStack::getNextTickLength() const
+{
+   // Tick n of every second spans from n*1000/60 ms to (n+1)*1000/60 ms, rounded down
+   return ((tickIndex + 1) * 1000) / TICKS_PER_SECOND - (tickIndex * 1000) / TICKS_PER_SECOND;
+}
+
+void ExecutionStack::finishTick()
+{
+   tickIndex = (tickIndex + 1) % TICKS_PER_SECOND;
+   ++tickCount;
+}
+
+bool ExecutionStack::isEmpty() const
+{
+   return stateStack.empty();
+}
+
+unsigned long ExecutionStack::getTickCount() const
+{
+   return tickCount;
+}
+
+unsigned long ExecutionStack::simulate(unsigned long numTicks)
+{
+   unsigned long ticksRun = 0;
+   while(ticksRun < numTicks && !stateStack.empty())
+   {
+      InputBuffer::getInstance()->pollEvents(tickCount);
+      JobSystem::getInstance()->runContinuations();
+
+      bool stateActive;
+      {
+         FrameTelemetry::Scope logicScope(FrameTelemetry::LOGIC);
+         stateActive = stateStack.top()->advanceFrame(getNextTickLength());
+      }
+
+      finishTick();
+      ++ticksRun;
+
+      if(!stateActive)
+      {
+         popState();
+         if(!stateStack.empty())
+         {
+            stateStack.top()->activate();
+         }
+      }
+   }
+
+   return ticksRun;
+}
+
 void ExecutionStack::execute()
 {
+   restartClock();
+
    while(!stateStack.empty())
    {
       GameState* currentState = stateStack.top();
-      if(currentState->advanceFrame())
+
+      const unsigned long frameStart = SDL_GetTicks();
+      const unsigned long frameStartMicroseconds = FrameTelemetry::getMicroseconds();
+      long frameTime = frameStart - previousTime;
+      previousTime = frameStart;
+      if(frameTime > MAX_FRAME_TIME)
       {
-         // The state is still active, so draw its results
-         GraphicsUtil::getInstance()->clearBuffer();
-         currentState->drawFrame();
+         DEBUG("Frame took %ld ms; skipping ahead.", frameTime);
+         frameTime = MAX_FRAME_TIME;
       }
-      else
+
+      accumulatedTime += frameTime * TICKS_PER_SECOND;
+
+      // Collect all the input that arrived since the last frame, for the ticks to handle in order.
+      // A replay is polled before every tick instead, since the recorded events belong to
+      // specific ticks and the frames of the replay don't line up with the recorded frames.
+      InputBuffer* inputBuffer = InputBuffer::getInstance();
+      const bool replaying = inputBuffer->isReplaying();
+      if(!replaying)
+      {
+         inputBuffer->pollEvents(tickCount);
+      }
+
+      // Handle what finished on the workers and the audio thread since the last frame,
+      // before the logic (and the script threads waiting on it) runs
+      JobSystem::getInstance()->runContinuations();
+
+      // Step through the state logic in fixed ticks, so that the simulation
+      // does not depend on how quickly frames are drawn
+      bool stateActive = true;
+      while(stateActive && accumulatedTime >= 1000 && stateStack.top() == currentState)
+      {
+         if(replaying)
+         {
+            inputBuffer->pollEvents(tickCount);
+         }
+
+         FrameTelemetry::Scope logicScope(FrameTelemetry::LOGIC);
+         stateActive = currentState->advanceFrame(getNextTickLength());
+         accumulatedTime -= 1000;
+         finishTick();
+      }
+
+      if(!stateActive)
       {
          // Delete the current state if it is finished, then
          // reactivate the state below it.
@@ -53,6 +158,28 @@ void ExecutionStack::execute()
          {
             stateStack.top()->activate();
          }
+
+         restartClock();
+      }
+      else if(stateStack.top() != currentState)
+      {
+         // A new state was pushed during the logic step, so it takes over from the next frame
+         restartClock();
+      }
+      else
+      {
+         // The state is still active, so draw its results partway between the last two ticks
+         GraphicsUtil::getInstance()->clearBuffer();
+         currentState->drawFrame(float(accumulatedTime) / 1000);
+
+         FrameTelemetry::getInstance()->addSample(FrameTelemetry::FRAME, FrameTelemetry::getMicroseconds() - frameStartMicroseconds);
+
+         // Sleep instead of spinning through frames that would not show anything new
+         const unsigned long frameDuration = SDL_GetTicks() - frameStart;
+         if(frameDuration < (unsigned long)MIN_FRAME_TIME)
+         {
+            SDL_Delay(MIN_FRAME_TIME - frameDuration);
+         }
       }
    }
 }
@@ -28,12 +28,63 @@ class ExecutionStack
     */
    std::stack<GameState*> stateStack;
 
+   /** The number of logic steps (ticks) the game states run per second. */
+   static const long TICKS_PER_SECOND = 60;
+
+   /** The minimum time (in ms) between drawn frames, which caps the frame rate at about 60 frames per second. */
+   static const long MIN_FRAME_TIME = 16;
+
+   /**
+    * The maximum time (in ms) that the game loop will catch up on after a slow frame.
+    * Without a limit, one long stall would make the states run many ticks back to back
+    * without drawing, which would stall the game even further.
+    */
+   static const long MAX_FRAME_TIME = 250;
+
+   /** The time (in ms) when the current frame started. */
+   unsigned long previousTime;
+
+   /**
+    * The time accumulated but not yet simulated, in thousandths of a tick
+    * (so that the 1000/60 ms ticks can be counted exactly, without rounding errors building up).
+    */
+   long accumulatedTime;
+
+   /** The index of the next tick within the current second. */
+   long tickIndex;
+
+   /** The number of ticks run since the game started. */
+   unsigned long tickCount;
+
+   /**
+    * Record that a tick has run.
+    */
+   void finishTick();
+
    /**
     * Remove and delete the most recent state pushed on the stack.
     */
    void popState();
 
+   /**
+    * Start timing from the current moment, dropping any time that was not simulated yet.
+    * Called whenever the state at the top of the stack changes, since states can take a long time
+    * to load and there is no point in making the new state catch up on the loading time.
+    */
+   void restartClock();
+
+   /**
+    * @return The length (in ms) of the next tick. Since a tick does not last a whole number of milliseconds,
+    *         tick lengths vary between 16 and 17 ms so that 60 ticks always add up to exactly one second.
+    */
+   long getNextTickLength() const;
+
    public:
+      /**
+       * Constructor.
+       */
+      ExecutionStack();
+
 
       /**
        * Destructor.
@@ -52,12 +103,36 @@ class ExecutionStack
 
       /**
        * Execute the game loop.
-       * Step through the state logic. If the logic returns true
-       * then the state is not ready to terminate, so run its draw step.
+       * Step through the state logic in fixed ticks, running as many ticks as it takes to
+       * catch up with the time that passed since the last frame. If the logic returns true
+       * then the state is not ready to terminate, so run its draw step, interpolating between the
+       * last two ticks by how much time is left over. Then sleep away the rest of the frame.
        * Otherwise, pop the stack and activate the next most recent state.
        * Keep going until there are no more states, and then quit.
        */
       void execute();
+
+      /**
+       * Run the state logic for a number of ticks as fast as possible, without drawing,
+       * sleeping or reading the clock. The ticks follow the same pattern of lengths as in
+       * execute(), so given the same input, a simulation always gives the same results.
+       * Finished states are popped as in execute().
+       *
+       * @param numTicks The number of ticks to run.
+       *
+       * @return The number of ticks that ran before the stack ran out of states.
+       */
+      unsigned long simulate(unsigned long numTicks);
+
+      /**
+       * @return true iff there are no states left on the stack.
+       */
+      bool isEmpty() const;
+
+      /**
+       * @return The number of ticks run since the game started.
+       */
+      unsigned long getTickCount() const;
 };
 
 #endif
@@ -0,0 +1,203 @@
+/*
+ *  This file is covered by the Ruby license. See LICENSE.txt for more details.
+ *
+ *  Copyright (C) 2007-2012 Noam Chitayat. All rights reserved.
+ */
+
+#include "FrameTelemetry.h"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <vector>
+#include <math.h>
+
+#ifdef _WIN32
+   #include <windows.h>
+#else
+   #include <sys/time.h>
+#endif
+
+#include "DebugUtils.h"
+const int debugFlag = DEBUG_EXEC_STACK;
+
+const char* const FrameTelemetry::PHASE_NAMES[FrameTelemetry::PHASE_COUNT] =
+{
+   "frame", "logic", "scheduler", "input", "player", "grid", "npcs", "draw", "gui", "flip", "latency"
+};
+
+FrameTelemetry::Scope::Scope(Phase phase) : phase(phase), startTime(getMicroseconds())
+{
+}
+
+FrameTelemetry::Scope::~Scope()
+{
+   FrameTelemetry::getInstance()->addSample(phase, getMicroseconds() - startTime);
+}
+
+void FrameTelemetry::initialize()
+{
+   for(int phase = 0; phase < PHASE_COUNT; ++phase)
+   {
+      nextSample[phase] = 0;
+      sampleCount[phase] = 0;
+   }
+
+   overlayVisible = false;
+}
+
+void FrameTelemetry::finish()
+{
+   if(!dumpPath.empty())
+   {
+      dump(dumpPath);
+   }
+}
+
+unsigned long FrameTelemetry::getMicroseconds()
+{
+#ifdef _WIN32
+   LARGE_INTEGER frequency;
+   LARGE_INTEGER counter;
+   QueryPerformanceFrequency(&frequency);
+   QueryPerformanceCounter(&counter);
+
+   // Split the conversion so that the multiplication can't overflow
+   const LONGLONG seconds = counter.QuadPart / frequency.QuadPart;
+   const LONGLONG remainder = counter.QuadPart % frequency.QuadPart;
+   return (unsigned long)(seconds * 1000000 + remainder * 1000000 / frequency.QuadPart);
+#else
+   timeval now;
+   gettimeofday(&now, NULL);
+   return (unsigned long)now.tv_sec * 1000000 + now.tv_usec;
+#endif
+}
+
+const char* FrameTelemetry::getPhaseName(Phase phase)
+{
+   return PHASE_NAMES[phase];
+}
+
+bool FrameTelemetry::findPhase(const std::string& name, Phase& phase)
+{
+   for(int i = 0; i < PHASE_COUNT; ++i)
+   {
+      if(name == PHASE_NAMES[i])
+      {
+         phase = Phase(i);
+         return true;
+      }
+   }
+
+   return false;
+}
+
+void FrameTelemetry::addSample(Phase phase, unsigned long microseconds)
+{
+   samples[phase][nextSample[phase]] = microseconds / 1000.0f;
+   nextSample[phase] = (nextSample[phase] + 1) % WINDOW_SIZE;
+   if(sampleCount[phase] < WINDOW_SIZE)
+   {
+      ++sampleCount[phase];
+   }
+}
+
+FrameTelemetry::Summary FrameTelemetry::summarize(Phase phase) const
+{
+   Summary summary;
+   summary.samples = sampleCount[phase];
+   if(summary.samples == 0)
+   {
+      summary.p50 = summary.p95 = summary.p99 = summary.max = 0.0f;
+      return summary;
+   }
+
+   // Sorting a copy of the window is cheap enough, since summaries are only requested a few times per second
+   std::vector<float> sorted(samples[phase], samples[phase] + summary.samples);
+   std::sort(sorted.begin(), sorted.end());
+
+   // Nearest-rank percentiles: the smallest sample that the given fraction of the samples are at or below
+   summary.p50 = sorted[(unsigned int)ceilf(summary.samples * 0.50f) - 1];
+   summary.p95 = sorted[(unsigned int)ceilf(summary.samples * 0.95f) - 1];
+   summary.p99 = sorted[(unsigned int)ceilf(summary.samples * 0.99f) - 1];
+   summary.max = sorted.back();
+
+   return summary;
+}
+
+std::string FrameTelemetry::getReport() const
+{
+   std::ostringstream report;
+   report << std::fixed << std::setprecision(2);
+
+   for(int phase = 0; phase < PHASE_COUNT; ++phase)
+   {
+      const Summary summary = summarize(Phase(phase));
+      report << PHASE_NAMES[phase] << ": p50 " << summary.p50 << " p95 " << summary.p95
+             << " p99 " << summary.p99 << " max " << summary.max << " ms";
+
+      if(phase + 1 < PHASE_COUNT)
+      {
+         report << std::endl;
+      }
+   }
+
+   return report.str();
+}
+
+void FrameTelemetry::toggleOverlay()
+{
+   overlayVisible = !overlayVisible;
+}
+
+bool FrameTelemetry::isOverlayVisible() const
+{
+   return overlayVisible;
+}
+
+void FrameTelemetry::setDumpPath(const std::string& path)
+{
+   dumpPath = path;
+}
+
+void FrameTelemetry::dump(const std::string& path) const
+{
+   std::ofstream output(path.c_str());
+   if(!output)
+   {
+      DEBUG("Unable to dump frame telemetry to %s.", path.c_str());
+      return;
+   }
+
+   output << std::fixed << std::setprecision(3);
+
+   const std::string jsonExtension = ".json";
+   const bool json = path.size() >= jsonExtension.size()
+         && path.compare(path.size() - jsonExtension.size(), jsonExtension.size(), jsonExtension) == 0;
+
+   if(json)
+   {
+      output << "{" << std::endl;
+      for(int phase = 0; phase < PHASE_COUNT; ++phase)
+      {
+         const Summary summary = summarize(Phase(phase));
+         output << "   \"" << PHASE_NAMES[phase] << "\": { \"samples\": " << summary.samples
+                << ", \"p50\": " << summary.p50 << ", \"p95\": " << summary.p95
+                << ", \"p99\": " << summary.p99 << ", \"max\": " << summary.max << " }"
+                << (phase + 1 < PHASE_COUNT ? "," : "") << std::endl;
+      }
+      output << "}" << std::endl;
+   }
+   else
+   {
+      output << "phase,samples,p50_ms,p95_ms,p99_ms,max_ms" << std::endl;
+      for(int phase = 0; phase < PHASE_COUNT; ++phase)
+      {
+         const Summary summary = summarize(Phase(phase));
+         output << PHASE_NAMES[phase] << "," << summary.samples << "," << summary.p50 << ","
+                << summary.p95 << "," << summary.p99 << "," << summary.max << std::endl;
+      }
+   }
+
+   DEBUG("Dumped frame telemetry to %s.", path.c_str());
+}
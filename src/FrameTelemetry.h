@@ -0,0 +1,215 @@
+/*
+ *  This file is covered by the Ruby license. See LICENSE.txt for more details.
+ *
+ *  Copyright (C) 2007-2012 Noam Chitayat. All rights reserved.
+ */
+
+#ifndef FRAME_TELEMETRY_H
+#define FRAME_TELEMETRY_H
+
+#include "Singleton.h"
+#include <string>
+
+/**
+ * Measures how long each phase of a frame takes, so that slow frames can be blamed
+ * on the phase responsible for them.
+ *
+ * The most recent samples of every phase are kept in a rolling window, which is
+ * summarized into percentiles (p50/p95/p99) and a maximum on request.
+ * The summaries can be shown over the game (toggled with F3), printed from the debug
+ * console, and dumped to a CSV or JSON file when the game exits.
+ *
+ * Note: This class is a singleton.
+ *
+ * @author Noam Chitayat
+ */
+class FrameTelemetry : public Singleton<FrameTelemetry>
+{
+   public:
+      /** The measured phases of a frame. */
+      enum Phase
+      {
+         /** Everything done in a frame, except for sleeping until the next one. */
+         FRAME,
+
+         /** One logic tick of the active game state. */
+         LOGIC,
+
+         /** The script threads run by the tile engine scheduler during a tick. */
+         SCHEDULER,
+
+         /** The input events handled by the tile engine during a tick. */
+         INPUT,
+
+         /** The player character's movement during a tick. */
+         PLAYER,
+
+         /** The entity grid's logic during a tick. */
+         ENTITY_GRID,
+
+         /** The NPCs' movement during a tick. */
+         NPCS,
+
+         /** Drawing the active game state. */
+         DRAW,
+
+         /** Drawing the GUI widgets and screen transitions. */
+         GUI,
+
+         /** Flipping the finished frame to the screen. */
+         FLIP,
+
+         /** The time from draining a key press to the tick that first responds to it (see InputBuffer). */
+         INPUT_LATENCY,
+
+         /** The number of phases. */
+         PHASE_COUNT
+      };
+
+      /** A summary of the recent samples of a phase (times in ms). */
+      struct Summary
+      {
+         /** The number of samples summarized. */
+         unsigned int samples;
+
+         /** The median time. */
+         float p50;
+
+         /** The time that 95% of the samples finished within. */
+         float p95;
+
+         /** The time that 99% of the samples finished within. */
+         float p99;
+
+         /** The longest time. */
+         float max;
+      };
+
+      /**
+       * Times a phase from construction until destruction, and adds the time as a sample.
+       *
+       * @author Noam Chitayat
+       */
+      class Scope
+      {
+         /** The phase being timed. */
+         Phase phase;
+
+         /** The time (in microseconds) when the phase started. */
+         unsigned long startTime;
+
+         public:
+            /**
+             * Constructor. Starts timing a phase.
+             *
+             * @param phase The phase to time.
+             */
+            Scope(Phase phase);
+
+            /**
+             * Destructor. Adds the time since construction as a sample of the phase.
+             */
+            ~Scope();
+      };
+
+   private:
+      /** The number of recent samples kept for each phase (about 10 seconds of frames). */
+      static const unsigned int WINDOW_SIZE = 600;
+
+      /** The names of the phases, as shown in reports and dumps. */
+      static const char* const PHASE_NAMES[PHASE_COUNT];
+
+      /** The rolling window of samples (in ms) for each phase. */
+      float samples[PHASE_COUNT][WINDOW_SIZE];
+
+      /** The index in the window where the next sample of each phase goes. */
+      unsigned int nextSample[PHASE_COUNT];
+
+      /** The number of samples in the window of each phase. */
+      unsigned int sampleCount[PHASE_COUNT];
+
+      /** true iff the summaries should be shown over the game. */
+      bool overlayVisible;
+
+      /** The path of the file to dump the summaries to on exit (empty if none). */
+      std::string dumpPath;
+
+   protected:
+      /**
+       * Initializes empty windows with the overlay hidden.
+       */
+      void initialize();
+
+      /**
+       * Dumps the summaries to the dump path, if one was set.
+       */
+      void finish();
+
+   public:
+      /**
+       * @return A high resolution time (in microseconds) for measuring intervals.
+       *         The time wraps around, so only the differences between times are meaningful.
+       */
+      static unsigned long getMicroseconds();
+
+      /**
+       * @param phase A phase.
+       *
+       * @return The name of the phase.
+       */
+      static const char* getPhaseName(Phase phase);
+
+      /**
+       * @param name The name of a phase.
+       * @param phase Returned as the phase with the given name.
+       *
+       * @return true iff there is a phase with the given name.
+       */
+      static bool findPhase(const std::string& name, Phase& phase);
+
+      /**
+       * Add a sample to the window of a phase, replacing the oldest sample if the window is full.
+       *
+       * @param phase The measured phase.
+       * @param microseconds How long the phase took.
+       */
+      void addSample(Phase phase, unsigned long microseconds);
+
+      /**
+       * @param phase The phase to summarize.
+       *
+       * @return A summary of the recent samples of the phase.
+       */
+      Summary summarize(Phase phase) const;
+
+      /**
+       * @return The summaries of all the phases as text, with one line per phase.
+       */
+      std::string getReport() const;
+
+      /**
+       * Show or hide the summaries over the game.
+       */
+      void toggleOverlay();
+
+      /**
+       * @return true iff the summaries should be shown over the game.
+       */
+      bool isOverlayVisible() const;
+
+      /**
+       * Set the file to dump the summaries to when the game exits.
+       *
+       * @param path The path of the file. Paths ending in ".json" are dumped as JSON, and others as CSV.
+       */
+      void setDumpPath(const std::string& path);
+
+      /**
+       * Dump the summaries of all the phases to a file.
+       *
+       * @param path The path of the file. Paths ending in ".json" are dumped as JSON, and others as CSV.
+       */
+      void dump(const std::string& path) const;
+};
+
+#endif
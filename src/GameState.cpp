@@ -6,6 +6,8 @@
 
 #include "GameState.h"
 #include "GraphicsUtil.h"
+#include "InputBuffer.h"
+#include "FrameTelemetry.h"
 #include <SDL.h>
 #include "Container.h"
 #include "DebugConsoleWindow.h"
@@ -16,7 +18,7 @@ const int debugFlag = DEBUG_GAME_STATE;
 GameState::GameState(ExecutionStack& executionStack) : executionStack(executionStack), internalContainer(true)
 {
    top = new edwt::Container();
-   top->setDimension(gcn::Rectangle(0, 0, GraphicsUtil::getInstance()->getWidth(), GraphicsUtil::getInstance()->getHeight()));
+   top->setDimension(gcn::Rectangle(0, 0, GraphicsUtil::width, GraphicsUtil::height));
    top->setOpaque(false);
    top->setEnabled(true);
 }
@@ -27,36 +29,73 @@ GameState::GameState(ExecutionStack& executionStack, edwt::Container* container)
 
 void GameState::activate()
 {
-   GraphicsUtil::getInstance()->setInterface(top);
+   if(!GraphicsUtil::isHeadless())
+   {
+      GraphicsUtil::getInstance()->setInterface(top);
+   }
+
    finished = false;
 }
 
-bool GameState::advanceFrame()
+bool GameState::advanceFrame(long timePassed)
 {
-   GraphicsUtil::getInstance()->stepGUI();
-   return step();
+   InputBuffer::getInstance()->beginTick();
+
+   // Without a display, there is no GUI to run and no transition to show
+   if(!GraphicsUtil::isHeadless())
+   {
+      GraphicsUtil::getInstance()->stepGUI();
+      GraphicsUtil::getInstance()->stepTransition(timePassed);
+   }
+
+   return step(timePassed);
 }
 
 void GameState::handleEvent(SDL_Event& event)
 {
-   GraphicsUtil::getInstance()->pushInput(event);
+   if(event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_F3)
+   {
+      FrameTelemetry::getInstance()->toggleOverlay();
+      return;
+   }
+
+   if(!GraphicsUtil::isHeadless())
+   {
+      GraphicsUtil::getInstance()->pushInput(event);
+   }
 }
 
-void GameState::drawFrame()
+void GameState::drawFrame(float interpolation)
 {
-   draw();
+   {
+      FrameTelemetry::Scope drawScope(FrameTelemetry::DRAW);
+      draw(interpolation);
+   }
+
+   {
+      FrameTelemetry::Scope guiScope(FrameTelemetry::GUI);
+      GraphicsUtil::getInstance()->drawGUI();
 
-   GraphicsUtil::getInstance()->drawGUI();
+      // Screen transitions are drawn over everything else
+      GraphicsUtil::getInstance()->drawTransition();
+   }
 
-   // Make sure everything is displayed on screen
-   GraphicsUtil::getInstance()->flipScreen();
+   {
+      // Make sure everything is displayed on screen
+      FrameTelemetry::Scope flipScope(FrameTelemetry::FLIP);
+      GraphicsUtil::getInstance()->flipScreen();
+   }
 }
 
 GameState::~GameState()
 {
    if(internalContainer)
    {
-      GraphicsUtil::getInstance()->setInterface(NULL);
+      if(!GraphicsUtil::isHeadless())
+      {
+         GraphicsUtil::getInstance()->setInterface(NULL);
+      }
+
       delete top;
    }
 }
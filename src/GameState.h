@@ -63,11 +63,13 @@ class GameState
       GameState(ExecutionStack& executionStack, edwt::Container* container);
 
       /**
-       * Runs the state's logic processing
+       * Runs the state's logic processing for one tick.
+       *
+       * @param timePassed The length of the tick (in ms).
        *
        * @return true iff the state is not finished
        */
-      virtual bool step() = 0;
+      virtual bool step(long timePassed) = 0;
 
       /**
        * Does common event handling that is required across all game states.
@@ -79,8 +81,11 @@ class GameState
       /**
        * Runs the state's graphic and interface processing.
        * Afterwards, draws widgets, flips the buffer.
+       *
+       * @param interpolation How far (from 0 to 1) the drawn frame is between the last tick and the next one.
+       *                      States with moving objects can use it to draw them partway between their last two positions.
        */
-      virtual void draw() = 0;
+      virtual void draw(float interpolation) = 0;
 
    public:
       /**
@@ -91,19 +96,23 @@ class GameState
       virtual void activate();
 
       /**
-       * Called every frame in order to trigger logic processing in the game state
+       * Called every tick in order to trigger logic processing in the game state
        * that is at the top of the execution stack.
        * Generic logic that happens in every game state (such as GUI logic) should go in here.
+       *
+       * @param timePassed The length of the tick (in ms).
        */
-      virtual bool advanceFrame();
+      virtual bool advanceFrame(long timePassed);
 
    
       /**
        * Called every frame in order to trigger drawing the game state
        * that is at the top of the execution stack.
        * Generic drawing code that is performed in every game state (such as drawing GUI and flipping the buffer) should go in here.
+       *
+       * @param interpolation How far (from 0 to 1) the drawn frame is between the last tick and the next one.
        */
-      virtual void drawFrame();
+      virtual void drawFrame(float interpolation);
 
       /**
        * Destructor.
@@ -16,19 +16,57 @@
 #include "guichan/opengl/openglsdlimageloader.hpp"
 #include "Container.h"
 #include "Size.h"
+#include "OpenGLGraphics.h"
 #include "OpenGLTTF.h"
+#include "RenderTexture.h"
+#include "TextBox.h"
+#include "FrameTelemetry.h"
+#include "Tracer.h"
+#include <algorithm>
 
 #include "DebugUtils.h"
 
 const int debugFlag = DEBUG_GRAPHICS;
 
 SDL_Surface* GraphicsUtil::screen = NULL;
+bool GraphicsUtil::headless = false;
+
+/**
+ * The width and height (in pixels) of the GUI cache and the cross-fade snapshot;
+ * the smallest power of two that fits the screen.
+ */
+static const unsigned int GUI_CACHE_SIZE = 1024;
+
+/** The number of frames between refreshes of the frame telemetry overlay (refreshing redraws the whole GUI cache). */
+static const unsigned int STATS_OVERLAY_REFRESH_FRAMES = 30;
+
+void GraphicsUtil::setHeadless(bool enabled)
+{
+   headless = enabled;
+}
+
+bool GraphicsUtil::isHeadless()
+{
+   return headless;
+}
 
 void GraphicsUtil::initialize()
 {
    currentXOffset = 0;
    currentYOffset = 0;
 
+   stateChanges = 0;
+   skippedStateChanges = 0;
+   lastFrameStateChanges = 0;
+   lastFrameSkippedStateChanges = 0;
+   frameCount = 0;
+   invalidateRenderState();
+
+   transitionType = NO_TRANSITION;
+   transitionTime = 0;
+   transitionDuration = 0;
+   transitionSnapshot = 0;
+
    initSDL();
    initGuichan();
 }
@@ -58,6 +96,9 @@ void GraphicsUtil::initSDL()
    // Enable the OpenGL double buffer
    SDL_GL_SetAttribute(SDL_GL_DOUBLEBUFFER, 0);
 
+   // The tile engine orders sprites and foreground tiles with a depth buffer
+   SDL_GL_SetAttribute(SDL_GL_DEPTH_SIZE, 16);
+
    // On exit, run the SDL cleanup
    atexit (SDL_Quit);
  
@@ -75,6 +116,13 @@ void GraphicsUtil::initSDL()
    // Sprites drawn to screen replace whatever is behind them (tiles, background)
    glTexEnvf(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_REPLACE);
 
+   // Alpha testing only ever discards (nearly) transparent pixels, so the
+   // test function is set once and only the test itself is toggled
+   glAlphaFunc(GL_GREATER, 0.1f);
+
+   // Blended pixels are mixed with the pixels behind them by their alpha
+   glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
    // Set up the viewport and reset the projection matrix
    glViewport(0, 0, width, height);
    glMatrixMode(GL_PROJECTION);
@@ -108,7 +156,7 @@ void GraphicsUtil::initGuichan()
    // The ImageLoader in use is static and must be set to be
    // able to load images
    gcn::Image::setImageLoader(imageLoader);
-   graphics = new gcn::OpenGLGraphics();
+   graphics = new edwt::OpenGLGraphics();
    graphics->setTargetPlane(800, 600);
 
    input = new gcn::SDLInput();
@@ -137,12 +185,52 @@ void GraphicsUtil::initGuichan()
 
    // The global font is static and must be set.
    gcn::Widget::setGlobalFont(font);
+
+   // The frame telemetry overlay stays hidden until it is toggled on
+   statsOverlay = new edwt::TextBox();
+   statsOverlay->setEditable(false);
+   statsOverlay->setFocusable(false);
+   statsOverlay->setPosition(8, 8);
+   statsOverlay->setVisible(false);
+   guiContainer->add(statsOverlay);
+
+   // The GUI can only be cached if its transparency can be drawn into a texture
+   guiCache = NULL;
+   guiRedraws = 0;
+   if(RenderTexture::isSupported() && edwt::OpenGLGraphics::isPremultipliedAlphaSupported())
+   {
+      guiCache = new RenderTexture(shapes::Size(GUI_CACHE_SIZE, GUI_CACHE_SIZE));
+   }
 }
 
 void GraphicsUtil::flipScreen()
 {
+   TRACE_ZONE("GraphicsUtil::flipScreen");
    glFlush();
    SDL_GL_SwapBuffers();
+   finishFrameStats();
+   edwt::OpenGLTrueTypeFont::finishFrame();
+}
+
+void GraphicsUtil::finishFrameStats()
+{
+   lastFrameStateChanges = stateChanges;
+   lastFrameSkippedStateChanges = skippedStateChanges;
+   stateChanges = 0;
+   skippedStateChanges = 0;
+
+   // Report the counters every 600 frames (about 10 seconds)
+   if(++frameCount % 600 == 0)
+   {
+      DEBUG("Render state changes last frame: %u sent, %u skipped.",
+            lastFrameStateChanges, lastFrameSkippedStateChanges);
+
+      if(guiCache != NULL)
+      {
+         DEBUG("GUI redrawn in %u of the last 600 frames.", guiRedraws);
+         guiRedraws = 0;
+      }
+   }
 }
 
 int GraphicsUtil::getWidth()
@@ -184,23 +272,123 @@ void GraphicsUtil::stepGUI()
 
 void GraphicsUtil::drawGUI()
 {
-   // Draw the GUI to buffer
-   gui->draw();
+   TRACE_ZONE("GraphicsUtil::drawGUI");
+
+   // Widgets draw text with blended edges, which alpha testing would cut off.
+   // Guichan restores any other state it changes with glPopAttrib.
+   setAlphaTestEnabled(false);
+
+   updateStatsOverlay();
+
+   if(guiCache == NULL)
+   {
+      // Draw the GUI to buffer
+      gui->draw();
+   }
+   else
+   {
+      if(guiContainer->isDirty())
+      {
+         redrawGUICache();
+      }
+
+      drawGUICache();
+   }
 
    // Update the screen
    SDL_GL_SwapBuffers();
 }
 
+void GraphicsUtil::updateStatsOverlay()
+{
+   const bool overlayVisible = FrameTelemetry::getInstance()->isOverlayVisible();
+   if(overlayVisible != statsOverlay->isVisible())
+   {
+      statsOverlay->setVisible(overlayVisible);
+   }
+   else if(!overlayVisible || frameCount % STATS_OVERLAY_REFRESH_FRAMES != 0)
+   {
+      return;
+   }
+
+   if(overlayVisible)
+   {
+      statsOverlay->setText(FrameTelemetry::getInstance()->getReport());
+
+      // Game states add their containers after the overlay, so keep moving it back in front
+      guiContainer->moveToTop(statsOverlay);
+   }
+}
+
+void GraphicsUtil::redrawGUICache()
+{
+   guiCache->beginDrawing();
+
+   // Guichan sets up its own screen-sized projection, so confine it to
+   // the bottom-left (screen-sized) corner of the cache
+   glViewport(0, 0, width, height);
+
+   graphics->setPremultipliedAlpha(true);
+   gui->draw();
+   graphics->setPremultipliedAlpha(false);
+
+   guiCache->endDrawing();
+
+   // Guichan binds its textures directly
+   invalidateRenderState();
+
+   guiContainer->clearDirty();
+   ++guiRedraws;
+}
+
+void GraphicsUtil::drawGUICache()
+{
+   // The GUI was drawn upside-down, so its top is at t = height / GUI_CACHE_SIZE
+   const float right = float(width) / GUI_CACHE_SIZE;
+   const float top = float(height) / GUI_CACHE_SIZE;
+
+   glPushAttrib(GL_ENABLE_BIT | GL_COLOR_BUFFER_BIT);
+   glDisable(GL_DEPTH_TEST);
+   glEnable(GL_TEXTURE_2D);
+
+   // The colors in the cache are already weighted by their coverage
+   glEnable(GL_BLEND);
+   glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+
+   glMatrixMode(GL_MODELVIEW);
+   glPushMatrix();
+   glLoadIdentity();
+
+   guiCache->bind();
+
+   glBegin(GL_QUADS);
+      glTexCoord2f(0.0f, top); glVertex3f(0.0f, 0.0f, 0.0f);
+      glTexCoord2f(right, top); glVertex3f((float)width, 0.0f, 0.0f);
+      glTexCoord2f(right, 0.0f); glVertex3f((float)width, (float)height, 0.0f);
+      glTexCoord2f(0.0f, 0.0f); glVertex3f(0.0f, (float)height, 0.0f);
+   glEnd();
+
+   glPopMatrix();
+   glPopAttrib();
+}
+
 void GraphicsUtil::pushInput(SDL_Event event)
 {
+   // Input can change how widgets look (hovering, focus, caret movement, selection)
+   // without going through their setters, so the whole GUI is redrawn
+   guiContainer->markDirty();
+
    input->pushInput(event);
 }
 
 void GraphicsUtil::clearBuffer()
 {
    glMatrixMode(GL_MODELVIEW);
-   glClear(GL_COLOR_BUFFER_BIT);
+   glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
    glLoadIdentity();
+
+   // Textures may have been created (and bound) since the last frame
+   invalidateRenderState();
 }
 
 void GraphicsUtil::setOffset(int xOffset, int yOffset)
@@ -217,48 +405,255 @@ void GraphicsUtil::resetOffset()
    currentYOffset = 0;
 }
 
+void GraphicsUtil::setDepthTestEnabled(bool enabled)
+{
+   if(enabled)
+   {
+      glEnable(GL_DEPTH_TEST);
+
+      // Ties go to the pixel drawn last, as they would without depth testing
+      glDepthFunc(GL_LEQUAL);
+   }
+   else
+   {
+      glDisable(GL_DEPTH_TEST);
+   }
+}
+
+void GraphicsUtil::setDepthWriteEnabled(bool enabled)
+{
+   glDepthMask(enabled ? GL_TRUE : GL_FALSE);
+}
+
+void GraphicsUtil::setCapabilityEnabled(unsigned int capability, bool enabled, RenderState& state)
+{
+   const RenderState newState = enabled ? STATE_ENABLED : STATE_DISABLED;
+   if(state == newState)
+   {
+      ++skippedStateChanges;
+      return;
+   }
+
+   if(enabled)
+   {
+      glEnable(capability);
+   }
+   else
+   {
+      glDisable(capability);
+   }
+
+   state = newState;
+   ++stateChanges;
+}
+
+void GraphicsUtil::bindTexture(GLuint textureHandle)
+{
+   if(textureKnown && boundTexture == textureHandle)
+   {
+      ++skippedStateChanges;
+      return;
+   }
+
+   glBindTexture(GL_TEXTURE_2D, textureHandle);
+   boundTexture = textureHandle;
+   textureKnown = true;
+   ++stateChanges;
+}
+
+void GraphicsUtil::setAlphaTestEnabled(bool enabled)
+{
+   setCapabilityEnabled(GL_ALPHA_TEST, enabled, alphaTestState);
+}
+
+void GraphicsUtil::setAlphaTestOpaqueOnly(bool opaqueOnly)
+{
+   const RenderState newState = opaqueOnly ? STATE_ENABLED : STATE_DISABLED;
+   if(alphaOpaqueOnlyState == newState)
+   {
+      ++skippedStateChanges;
+      return;
+   }
+
+   if(opaqueOnly)
+   {
+      glAlphaFunc(GL_GEQUAL, 1.0f);
+   }
+   else
+   {
+      glAlphaFunc(GL_GREATER, 0.1f);
+   }
+
+   alphaOpaqueOnlyState = newState;
+   ++stateChanges;
+}
+
+void GraphicsUtil::setBlendEnabled(bool enabled)
+{
+   setCapabilityEnabled(GL_BLEND, enabled, blendState);
+}
+
+void GraphicsUtil::setColor(float red, float green, float blue, float alpha)
+{
+   if(colorKnown && currentColor[0] == red && currentColor[1] == green
+         && currentColor[2] == blue && currentColor[3] == alpha)
+   {
+      ++skippedStateChanges;
+      return;
+   }
+
+   glColor4f(red, green, blue, alpha);
+   currentColor[0] = red;
+   currentColor[1] = green;
+   currentColor[2] = blue;
+   currentColor[3] = alpha;
+   colorKnown = true;
+   ++stateChanges;
+}
+
+void GraphicsUtil::invalidateRenderState()
+{
+   textureKnown = false;
+   colorKnown = false;
+   alphaTestState = STATE_UNKNOWN;
+   blendState = STATE_UNKNOWN;
+   alphaOpaqueOnlyState = STATE_UNKNOWN;
+}
+
+unsigned int GraphicsUtil::getStateChangeCount() const
+{
+   return lastFrameStateChanges;
+}
+
+unsigned int GraphicsUtil::getSkippedStateChangeCount() const
+{
+   return lastFrameSkippedStateChanges;
+}
+
 void GraphicsUtil::FadeToColor(float red, float green, float blue, int delay)
 {
-   long time = SDL_GetTicks();
-   float alpha = 0.0f;
-
+   transitionType = FADE_TO_COLOR;
+   transitionColor[0] = red;
+   transitionColor[1] = green;
+   transitionColor[2] = blue;
+   transitionTime = 0;
+   transitionDuration = delay;
+}
+
+void GraphicsUtil::crossFade(int delay)
+{
+   if(transitionSnapshot == 0)
+   {
+      glGenTextures(1, &transitionSnapshot);
+      bindTexture(transitionSnapshot);
+
+      // The snapshot is drawn pixel for pixel
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+      glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, GUI_CACHE_SIZE, GUI_CACHE_SIZE, 0, GL_RGB, GL_UNSIGNED_BYTE, NULL);
+   }
+   else
+   {
+      bindTexture(transitionSnapshot);
+   }
+
+   // The screen is single-buffered, so it still holds the last frame that was drawn
+   glCopyTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, 0, 0, width, height);
+
+   transitionType = CROSS_FADE;
+   transitionTime = 0;
+   transitionDuration = delay;
+}
+
+void GraphicsUtil::stepTransition(long timePassed)
+{
+   if(transitionType == NO_TRANSITION) return;
+
+   transitionTime = std::min(transitionTime + timePassed, transitionDuration);
+
+   // A finished cross-fade has nothing left to draw, but a finished fade keeps covering the screen
+   if(transitionType == CROSS_FADE && transitionTime == transitionDuration)
+   {
+      transitionType = NO_TRANSITION;
+   }
+}
+
+void GraphicsUtil::drawTransition()
+{
+   if(transitionType == NO_TRANSITION) return;
+   TRACE_ZONE("GraphicsUtil::drawTransition");
+
+   const float progress = transitionDuration > 0 ? float(transitionTime) / transitionDuration : 1.0f;
+
+   // Alpha testing would discard the transition quad until it is more than 10% opaque
+   setAlphaTestEnabled(false);
+
    glPushAttrib(GL_ENABLE_BIT | GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-   glBlendFunc(GL_SRC_ALPHA,GL_ONE_MINUS_SRC_ALPHA);
+   glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
    glEnable(GL_BLEND);
    glDisable(GL_DEPTH_TEST);
-   glDisable(GL_TEXTURE_2D);
 
-   for (;;)
+   glMatrixMode(GL_MODELVIEW);
+   glPushMatrix();
+   glLoadIdentity();
+
+   if(transitionType == FADE_TO_COLOR)
    {
+      glDisable(GL_TEXTURE_2D);
+      setColor(transitionColor[0], transitionColor[1], transitionColor[2], progress);
+
       glBegin(GL_QUADS);
-         glColor4f(red, green, blue, alpha);
          glVertex3f( 0.0f,         0.0f,          0.0f);
          glVertex3f( (float)width, 0.0f,          0.0f);
          glVertex3f( (float)width, (float)height, 0.0f);
          glVertex3f( 0.0f,         (float)height, 0.0f);
       glEnd();
+   }
+   else
+   {
+      // The snapshot was copied upside-down, so its top is at t = height / GUI_CACHE_SIZE
+      const float right = float(width) / GUI_CACHE_SIZE;
+      const float top = float(height) / GUI_CACHE_SIZE;
 
-      GraphicsUtil::getInstance()->flipScreen();
- 
-      long timePassed = SDL_GetTicks() - time;
-      alpha = ((timePassed*1.0f)/delay);
+      // Modulate the snapshot by the drawing color so that it can be faded out
+      glTexEnvf(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
+      setColor(1.0f, 1.0f, 1.0f, 1.0f - progress);
+      bindTexture(transitionSnapshot);
 
-      //We're done when alpha reaches 1.0
-      if (alpha >= 1.0f)
-      {
-         glColor3f(1.0f,1.0f,1.0f);
-         break;
-      }
+      glBegin(GL_QUADS);
+         glTexCoord2f(0.0f, top); glVertex3f(0.0f, 0.0f, 0.0f);
+         glTexCoord2f(right, top); glVertex3f((float)width, 0.0f, 0.0f);
+         glTexCoord2f(right, 0.0f); glVertex3f((float)width, (float)height, 0.0f);
+         glTexCoord2f(0.0f, 0.0f); glVertex3f(0.0f, (float)height, 0.0f);
+      glEnd();
+
+      glTexEnvf(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_REPLACE);
    }
 
+   setColor(1.0f, 1.0f, 1.0f);
+
+   glPopMatrix();
    glPopAttrib();
 }
 
+bool GraphicsUtil::isTransitionFinished() const
+{
+   return transitionType == NO_TRANSITION || transitionTime == transitionDuration;
+}
+
 void GraphicsUtil::finish()
 {
+   delete guiCache;
+
+   if(transitionSnapshot != 0)
+   {
+      glDeleteTextures(1, &transitionSnapshot);
+   }
+
    //Destroys some Guichan stuff
    delete font;
+   delete statsOverlay;
    delete guiContainer;
    delete gui;
    delete imageLoader;
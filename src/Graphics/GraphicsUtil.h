@@ -15,7 +15,6 @@ union SDL_Event;
 namespace gcn
 {
    class SDLInput;
-   class OpenGLGraphics;
    class OpenGLSDLImageLoader;
    class Gui;
    class Container;
@@ -24,9 +23,13 @@ namespace gcn
 namespace edwt
 {
    class Container;
+   class OpenGLGraphics;
    class OpenGLTrueTypeFont;
+   class TextBox;
 };
 
+class RenderTexture;
+
 namespace shapes
 {
    struct Size;
@@ -47,11 +50,14 @@ class GraphicsUtil : public Singleton<GraphicsUtil>
    /** The screen surface */    
    static SDL_Surface* screen;
 
+   /** true iff the game runs without a display, audio or OpenGL context. */
+   static bool headless;
+
    /** The Guichan SDL input driver */
    gcn::SDLInput* input;
 
    /** The Guichan OpenGL Graphics driver */
-   gcn::OpenGLGraphics* graphics;
+   edwt::OpenGLGraphics* graphics;
 
    /** The Guichan OpenGL image loader (for loading images via SDL) */
    gcn::OpenGLSDLImageLoader* imageLoader;
@@ -68,12 +74,126 @@ class GraphicsUtil : public Singleton<GraphicsUtil>
    /** The global default font */
    edwt::OpenGLTrueTypeFont* font;
 
+   /** Shows the frame telemetry over everything else, while the telemetry overlay is toggled on. */
+   edwt::TextBox* statsOverlay;
+
+   /**
+    * The last drawing of the GUI, which is drawn to the screen until a widget changes.
+    * NULL if the GUI can't be drawn into a texture, in which case it is drawn every frame.
+    */
+   RenderTexture* guiCache;
+
+   /** The number of times the GUI was drawn into the cache since the last report. */
+   unsigned int guiRedraws;
+
    /** The x-offset to draw at (in pixels). */
    int currentXOffset;
 
    /** The y-offset to draw at (in pixels). */
    int currentYOffset;
 
+   /** The known state of a GL capability or setting. */
+   enum RenderState
+   {
+      /** The state is unknown, so the next change must be sent to OpenGL. */
+      STATE_UNKNOWN,
+      STATE_DISABLED,
+      STATE_ENABLED
+   };
+
+   /** The texture bound to GL_TEXTURE_2D. Only valid if textureKnown is true. */
+   GLuint boundTexture;
+
+   /** true iff the bound texture is known. */
+   bool textureKnown;
+
+   /** The state of alpha testing. */
+   RenderState alphaTestState;
+
+   /** The state of alpha blending. */
+   RenderState blendState;
+
+   /** Whether the alpha test only passes fully opaque pixels (enabled) or any pixel with an alpha above 0.1 (disabled). */
+   RenderState alphaOpaqueOnlyState;
+
+   /** The current drawing color (RGBA). Only valid if colorKnown is true. */
+   float currentColor[4];
+
+   /** true iff the current drawing color is known. */
+   bool colorKnown;
+
+   /** The number of render state changes sent to OpenGL during the current frame. */
+   unsigned int stateChanges;
+
+   /** The number of redundant render state changes dropped during the current frame. */
+   unsigned int skippedStateChanges;
+
+   /** The number of render state changes sent to OpenGL during the last frame. */
+   unsigned int lastFrameStateChanges;
+
+   /** The number of redundant render state changes dropped during the last frame. */
+   unsigned int lastFrameSkippedStateChanges;
+
+   /** The number of frames flipped to the screen. */
+   unsigned int frameCount;
+
+   /** The kinds of screen transition that can be drawn over the frame. */
+   enum TransitionType
+   {
+      /** Nothing is drawn over the frame. */
+      NO_TRANSITION,
+
+      /** The frame is covered by a color that becomes more opaque over time. */
+      FADE_TO_COLOR,
+
+      /** The frame is covered by a snapshot of an earlier frame that becomes more transparent over time. */
+      CROSS_FADE
+   };
+
+   /** The screen transition in progress. */
+   TransitionType transitionType;
+
+   /** The color that the screen fades to (RGB). */
+   float transitionColor[3];
+
+   /** The time (in ms) that the transition has been running for. */
+   long transitionTime;
+
+   /** The time (in ms) that the transition takes. */
+   long transitionDuration;
+
+   /** A copy of the screen (in the bottom-left corner of the texture) to cross-fade from, or 0 if none was taken yet. */
+   GLuint transitionSnapshot;
+
+   /**
+    * Enable or disable a GL capability, unless it is already in the requested state.
+    *
+    * @param capability The GL capability to change.
+    * @param enabled true iff the capability should be enabled.
+    * @param state The known state of the capability, which is updated.
+    */
+   void setCapabilityEnabled(unsigned int capability, bool enabled, RenderState& state);
+
+   /**
+    * Record the render state counters of the frame that just ended and reset them.
+    */
+   void finishFrameStats();
+
+   /**
+    * Show or hide the frame telemetry overlay, and refresh its text twice a second while it is shown.
+    */
+   void updateStatsOverlay();
+
+   /**
+    * Draw the GUI widgets into the GUI cache.
+    */
+   void redrawGUICache();
+
+   /**
+    * Draw the GUI cache over the screen as a single textured quad.
+    */
+   void drawGUICache();
+
    /**
     * Initializes SDL audio and video bindings
     * Initializes SDL mixer and TTF libraries
@@ -105,6 +225,22 @@ class GraphicsUtil : public Singleton<GraphicsUtil>
       virtual void finish();
 
    public:
+      /**
+       * Run the game without a display, audio or OpenGL context, so that the game
+       * logic can be simulated on machines without a display (such as build servers).
+       * In headless mode, the GraphicsUtil instance must never be created: textures only load
+       * their sizes, sounds and music are silent, and game states are never drawn.
+       * This must be set before any resources are loaded.
+       *
+       * @param enabled true iff the game should run headless.
+       */
+      static void setHeadless(bool enabled);
+
+      /**
+       * @return true iff the game runs without a display, audio or OpenGL context.
+       */
+      static bool isHeadless();
+
       /** The screen width (currently HARDCODED) */
       static const unsigned int width = 800;
    
@@ -139,7 +275,9 @@ class GraphicsUtil : public Singleton<GraphicsUtil>
       void stepGUI();
    
       /**
-       * Draw GUI widgets to the screen
+       * Draw GUI widgets to the screen.
+       * If render textures are supported, the widgets are only drawn again
+       * when one of them has changed; otherwise, the previous drawing is reused.
        */
       void drawGUI();
 
@@ -165,8 +303,86 @@ class GraphicsUtil : public Singleton<GraphicsUtil>
        */
       void resetOffset();
 
+      /**
+       * Enables or disables depth testing. While depth testing is enabled,
+       * pixels are only drawn over pixels of equal or lower depth.
+       *
+       * @param enabled true iff depth testing should be enabled.
+       */
+      void setDepthTestEnabled(bool enabled);
+
+      /**
+       * Enables or disables writes to the depth buffer. Depth writes must be
+       * enabled again before the buffers are cleared.
+       *
+       * @param enabled true iff drawn pixels should update the depth buffer.
+       */
+      void setDepthWriteEnabled(bool enabled);
+
+      /**
+       * Bind a texture to GL_TEXTURE_2D, unless it is already bound.
+       *
+       * @param textureHandle The GL handle of the texture to bind.
+       */
+      void bindTexture(GLuint textureHandle);
+
+      /**
+       * Enables or disables alpha testing, unless it is already in the requested state.
+       * While alpha testing is enabled, pixels with an alpha of 0.1 or less are not drawn.
+       *
+       * @param enabled true iff alpha testing should be enabled.
+       */
+      void setAlphaTestEnabled(bool enabled);
+
+      /**
+       * Choose which pixels pass the alpha test, unless it already passes them.
+       * Normally, pixels with an alpha above 0.1 pass; in opaque-only mode,
+       * only pixels with an alpha of 1 pass.
+       *
+       * @param opaqueOnly true iff only fully opaque pixels should pass the alpha test.
+       */
+      void setAlphaTestOpaqueOnly(bool opaqueOnly);
+
+      /**
+       * Enables or disables alpha blending, unless it is already in the requested state.
+       * Blended pixels are mixed with the pixels behind them by their alpha.
+       *
+       * @param enabled true iff alpha blending should be enabled.
+       */
+      void setBlendEnabled(bool enabled);
+
+      /**
+       * Set the drawing color, unless it is already the current color.
+       *
+       * @param red   The amount of red   (0.0f <= red <= 1.0f)
+       * @param green The amount of green (0.0f <= green <= 1.0f)
+       * @param blue  The amount of blue  (0.0f <= blue <= 1.0f)
+       * @param alpha The opacity         (0.0f <= alpha <= 1.0f)
+       */
+      void setColor(float red, float green, float blue, float alpha = 1.0f);
+
+      /**
+       * Forget the tracked render state, so that the next change of each state
+       * is sent to OpenGL. This must be called after any code changes the
+       * texture binding, alpha testing (or its function), blending or color without going
+       * through GraphicsUtil (and without restoring them through glPopAttrib).
+       */
+      void invalidateRenderState();
+
+      /**
+       * @return The number of render state changes sent to OpenGL during the last frame.
+       */
+      unsigned int getStateChangeCount() const;
+
+      /**
+       * @return The number of redundant render state changes dropped during the last frame.
+       */
+      unsigned int getSkippedStateChangeCount() const;
+
       /** 
-       *  Graphical effect: Fade to a specific colour in a specified time period
+       *  Graphical effect: Fade to a specific colour in a specified time period.
+       *  The fade is drawn over every frame as game time passes, and the screen
+       *  stays covered by the colour until another transition starts.
        *
        *  @param red   The amount of red   (0.0f <= red <= 1.0f)
        *  @param green The amount of green (0.0f <= green <= 1.0f)
@@ -174,9 +390,35 @@ class GraphicsUtil : public Singleton<GraphicsUtil>
        *  @param delay The amount of time taken for the fade (in milliseconds)
        */
       void FadeToColor(float red, float green, float blue, int delay);
+
+      /**
+       *  Graphical effect: Fade from the frame currently on screen to the frames drawn after it.
+       *  The screen is copied right away, so the game can load or change what is drawn
+       *  (for instance, the map) right after starting the cross-fade.
+       *
+       *  @param delay The amount of time taken for the fade (in milliseconds)
+       */
+      void crossFade(int delay);
+
+      /**
+       * Advance the screen transition in progress, if any.
+       *
+       * @param timePassed The amount of time that passed (in milliseconds).
+       */
+      void stepTransition(long timePassed);
+
+      /**
+       * Draw the screen transition in progress (if any) over the frame.
+       */
+      void drawTransition();
+
+      /**
+       * @return true iff no screen transition is running (a finished fade still covers the screen).
+       */
+      bool isTransitionFinished() const;
    
       /**
-       * Clear the color buffers and reset the model matrix
+       * Clear the color and depth buffers and reset the model matrix
        * \todo Come up with a better name for this (though that suggestion indicates that this method may not be good design).
        */
       void clearBuffer();
@@ -0,0 +1,172 @@
+/*
+ *  This file is covered by the Ruby license. See LICENSE.txt for more details.
+ *
+ *  Copyright (C) 2007-2012 Noam Chitayat. All rights reserved.
+ */
+
+#include "RenderTexture.h"
+#include <SDL.h>
+#include "SDL_opengl.h"
+#include "GraphicsUtil.h"
+#include <string.h>
+
+#include "DebugUtils.h"
+
+const int debugFlag = DEBUG_GRAPHICS;
+
+static bool extensionLoaded = false;
+static bool extensionSupported = false;
+
+static PFNGLGENFRAMEBUFFERSEXTPROC genFramebuffers = NULL;
+static PFNGLDELETEFRAMEBUFFERSEXTPROC deleteFramebuffers = NULL;
+static PFNGLBINDFRAMEBUFFEREXTPROC bindFramebuffer = NULL;
+static PFNGLFRAMEBUFFERTEXTURE2DEXTPROC framebufferTexture2D = NULL;
+static PFNGLCHECKFRAMEBUFFERSTATUSEXTPROC checkFramebufferStatus = NULL;
+static PFNGLGENRENDERBUFFERSEXTPROC genRenderbuffers = NULL;
+static PFNGLDELETERENDERBUFFERSEXTPROC deleteRenderbuffers = NULL;
+static PFNGLBINDRENDERBUFFEREXTPROC bindRenderbuffer = NULL;
+static PFNGLRENDERBUFFERSTORAGEEXTPROC renderbufferStorage = NULL;
+static PFNGLFRAMEBUFFERRENDERBUFFEREXTPROC framebufferRenderbuffer = NULL;
+
+bool RenderTexture::isSupported()
+{
+   if(!extensionLoaded)
+   {
+      extensionLoaded = true;
+
+      if(GraphicsUtil::isHeadless())
+      {
+         // There is no GL context to ask
+         return false;
+      }
+
+      const char* extensions = reinterpret_cast<const char*>(glGetString(GL_EXTENSIONS));
+      if(extensions == NULL || strstr(extensions, "GL_EXT_framebuffer_object") == NULL)
+      {
+         DEBUG("Framebuffer objects are not supported; render textures are disabled.");
+         return false;
+      }
+
+      genFramebuffers = (PFNGLGENFRAMEBUFFERSEXTPROC)SDL_GL_GetProcAddress("glGenFramebuffersEXT");
+      deleteFramebuffers = (PFNGLDELETEFRAMEBUFFERSEXTPROC)SDL_GL_GetProcAddress("glDeleteFramebuffersEXT");
+      bindFramebuffer = (PFNGLBINDFRAMEBUFFEREXTPROC)SDL_GL_GetProcAddress("glBindFramebufferEXT");
+      framebufferTexture2D = (PFNGLFRAMEBUFFERTEXTURE2DEXTPROC)SDL_GL_GetProcAddress("glFramebufferTexture2DEXT");
+      checkFramebufferStatus = (PFNGLCHECKFRAMEBUFFERSTATUSEXTPROC)SDL_GL_GetProcAddress("glCheckFramebufferStatusEXT");
+      genRenderbuffers = (PFNGLGENRENDERBUFFERSEXTPROC)SDL_GL_GetProcAddress("glGenRenderbuffersEXT");
+      deleteRenderbuffers = (PFNGLDELETERENDERBUFFERSEXTPROC)SDL_GL_GetProcAddress("glDeleteRenderbuffersEXT");
+      bindRenderbuffer = (PFNGLBINDRENDERBUFFEREXTPROC)SDL_GL_GetProcAddress("glBindRenderbufferEXT");
+      renderbufferStorage = (PFNGLRENDERBUFFERSTORAGEEXTPROC)SDL_GL_GetProcAddress("glRenderbufferStorageEXT");
+      framebufferRenderbuffer = (PFNGLFRAMEBUFFERRENDERBUFFEREXTPROC)SDL_GL_GetProcAddress("glFramebufferRenderbufferEXT");
+
+      extensionSupported = genFramebuffers != NULL && deleteFramebuffers != NULL
+            && bindFramebuffer != NULL && framebufferTexture2D != NULL
+            && checkFramebufferStatus != NULL && genRenderbuffers != NULL
+            && deleteRenderbuffers != NULL && bindRenderbuffer != NULL
+            && renderbufferStorage != NULL && framebufferRenderbuffer != NULL;
+
+      DEBUG("Render textures %s.", extensionSupported ? "enabled" : "disabled");
+   }
+
+   return extensionSupported;
+}
+
+RenderTexture::RenderTexture(const shapes::Size& size, bool withDepthBuffer) : depthBufferHandle(0), previousFramebuffer(0), size(size)
+{
+   glGenTextures(1, &textureHandle);
+   glBindTexture(GL_TEXTURE_2D, textureHandle);
+   GraphicsUtil::getInstance()->invalidateRenderState();
+
+   // Render textures are drawn back pixel for pixel, so no filtering is needed
+   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+   glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, size.width, size.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+
+   genFramebuffers(1, &framebufferHandle);
+   bindFramebuffer(GL_FRAMEBUFFER_EXT, framebufferHandle);
+   framebufferTexture2D(GL_FRAMEBUFFER_EXT, GL_COLOR_ATTACHMENT0_EXT, GL_TEXTURE_2D, textureHandle, 0);
+
+   if(withDepthBuffer)
+   {
+      genRenderbuffers(1, &depthBufferHandle);
+      bindRenderbuffer(GL_RENDERBUFFER_EXT, depthBufferHandle);
+      renderbufferStorage(GL_RENDERBUFFER_EXT, GL_DEPTH_COMPONENT24, size.width, size.height);
+      framebufferRenderbuffer(GL_FRAMEBUFFER_EXT, GL_DEPTH_ATTACHMENT_EXT, GL_RENDERBUFFER_EXT, depthBufferHandle);
+      bindRenderbuffer(GL_RENDERBUFFER_EXT, 0);
+   }
+
+   if(checkFramebufferStatus(GL_FRAMEBUFFER_EXT) != GL_FRAMEBUFFER_COMPLETE_EXT)
+   {
+      DEBUG("Incomplete framebuffer for %dx%d render texture.", size.width, size.height);
+   }
+
+   bindFramebuffer(GL_FRAMEBUFFER_EXT, 0);
+}
+
+void RenderTexture::beginDrawing()
+{
+   // Render textures can be drawn into while drawing into another render texture
+   glGetIntegerv(GL_FRAMEBUFFER_BINDING_EXT, &previousFramebuffer);
+   bindFramebuffer(GL_FRAMEBUFFER_EXT, framebufferHandle);
+
+   glPushAttrib(GL_VIEWPORT_BIT);
+   glViewport(0, 0, size.width, size.height);
+
+   // Use the same top-down orthogonal projection as the screen
+   glMatrixMode(GL_PROJECTION);
+   glPushMatrix();
+   glLoadIdentity();
+   gluOrtho2D(0.0f, (float)size.width, (float)size.height, 0.0f);
+
+   glMatrixMode(GL_MODELVIEW);
+   glPushMatrix();
+   glLoadIdentity();
+
+   glClear(depthBufferHandle != 0 ? GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT : GL_COLOR_BUFFER_BIT);
+}
+
+void RenderTexture::endDrawing()
+{
+   glMatrixMode(GL_PROJECTION);
+   glPopMatrix();
+
+   glMatrixMode(GL_MODELVIEW);
+   glPopMatrix();
+
+   glPopAttrib();
+
+   bindFramebuffer(GL_FRAMEBUFFER_EXT, previousFramebuffer);
+}
+
+void RenderTexture::readPixels(std::vector<unsigned char>& pixels)
+{
+   pixels.resize(size.width * size.height * 4);
+
+   GLint boundFramebuffer;
+   glGetIntegerv(GL_FRAMEBUFFER_BINDING_EXT, &boundFramebuffer);
+   bindFramebuffer(GL_FRAMEBUFFER_EXT, framebufferHandle);
+
+   glPixelStorei(GL_PACK_ALIGNMENT, 1);
+   glReadPixels(0, 0, size.width, size.height, GL_RGBA, GL_UNSIGNED_BYTE, &pixels[0]);
+
+   bindFramebuffer(GL_FRAMEBUFFER_EXT, boundFramebuffer);
+}
+
+void RenderTexture::bind()
+{
+   GraphicsUtil::getInstance()->bindTexture(textureHandle);
+}
+
+const shapes::Size& RenderTexture::getSize() const
+{
+   return size;
+}
+
+RenderTexture::~RenderTexture()
+{
+   deleteFramebuffers(1, &framebufferHandle);
+   if(depthBufferHandle != 0)
+   {
+      deleteRenderbuffers(1, &depthBufferHandle);
+   }
+   glDeleteTextures(1, &textureHandle);
+}
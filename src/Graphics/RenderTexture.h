@@ -0,0 +1,95 @@
+/*
+ *  This file is covered by the Ruby license. See LICENSE.txt for more details.
+ *
+ *  Copyright (C) 2007-2012 Noam Chitayat. All rights reserved.
+ */
+
+#ifndef RENDER_TEXTURE_H
+#define RENDER_TEXTURE_H
+
+#include "Size.h"
+#include <vector>
+
+typedef unsigned int GLuint;
+typedef int GLint;
+
+/**
+ * A texture that can be drawn into, backed by an OpenGL framebuffer object.
+ * Render textures are used to cache drawing results that rarely change, so
+ * that they can be redrawn later as a single textured quad.
+ *
+ * Framebuffer objects are an extension in the OpenGL versions we target, so
+ * callers must check isSupported() before creating any render textures.
+ *
+ * @author Noam Chitayat
+ */
+class RenderTexture
+{
+   /** The texture handle */
+   GLuint textureHandle;
+
+   /** The framebuffer object that draws into the texture */
+   GLuint framebufferHandle;
+
+   /** The depth buffer of the framebuffer object (0 if it has none) */
+   GLuint depthBufferHandle;
+
+   /** The framebuffer that was bound when drawing began, restored when drawing ends */
+   GLint previousFramebuffer;
+
+   /** Texture size (in pixels) */
+   shapes::Size size;
+
+   public:
+      /**
+       * Loads the framebuffer object extension functions, if they haven't been loaded yet.
+       *
+       * @return true iff the OpenGL implementation supports render textures.
+       */
+      static bool isSupported();
+
+      /**
+       * Constructor.
+       *
+       * @param size The size (in pixels) of the texture.
+       * @param withDepthBuffer true iff drawing into the texture needs depth testing.
+       */
+      RenderTexture(const shapes::Size& size, bool withDepthBuffer = false);
+
+      /**
+       * Redirect all drawing to the (cleared) texture, with the texture's
+       * top-left corner at the origin.
+       */
+      void beginDrawing();
+
+      /**
+       * Resume drawing to whatever was drawn to before beginDrawing was called
+       * (the screen, or another render texture).
+       */
+      void endDrawing();
+
+      /**
+       * Read back the contents of the texture.
+       *
+       * @param pixels Filled with the RGBA bytes of the texture, bottom row first.
+       */
+      void readPixels(std::vector<unsigned char>& pixels);
+
+      /**
+       * Bind the texture for drawing. Note that, as with any texture the
+       * framebuffer draws into, the top row of the drawing is at t = 1.
+       */
+      void bind();
+
+      /**
+       * @return The size (in pixels) of the texture.
+       */
+      const shapes::Size& getSize() const;
+
+      /**
+       * Destructor.
+       */
+      ~RenderTexture();
+};
+
+#endif
@@ -25,6 +25,14 @@ Texture::Texture(const std::string& imagePath)
    size.width = image->w;
    size.height = image->h;
 
+   if(GraphicsUtil::isHeadless())
+   {
+      // Without a GL context, only the size of the image is needed (to lay out sprite frames and tiles)
+      textureHandle = 0;
+      SDL_FreeSurface(image);
+      return;
+   }
+
    // Create the texture
    DEBUG("Generating texture...");
    glGenTextures(1, &textureHandle);
@@ -36,6 +44,10 @@ Texture::Texture(const std::string& imagePath)
    DEBUG("Binding GL texture");
    glBindTexture(GL_TEXTURE_2D, textureHandle);
 
+   // The new handle may have belonged to a deleted texture that is still
+   // tracked as bound, so the tracked binding can no longer be trusted
+   GraphicsUtil::getInstance()->invalidateRenderState();
+
    // Add Linear filtering for the texture
    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
@@ -63,7 +75,7 @@ Texture::Texture(const std::string& imagePath)
 
 void Texture::bind()
 {
-   glBindTexture(GL_TEXTURE_2D, textureHandle);
+   GraphicsUtil::getInstance()->bindTexture(textureHandle);
 }
 
 const shapes::Size& Texture::getSize()
@@ -73,5 +85,8 @@ const shapes::Size& Texture::getSize()
 
 Texture::~Texture()
 {
-   glDeleteTextures(1, &textureHandle);
+   if(textureHandle != 0)
+   {
+      glDeleteTextures(1, &textureHandle);
+   }
 }
@@ -0,0 +1,173 @@
+/*
+ *  This file is covered by the Ruby license. See LICENSE.txt for more details.
+ *
+ *  Copyright (C) 2007-2012 Noam Chitayat. All rights reserved.
+ */
+
+#include "InputBuffer.h"
+#include "InputRecording.h"
+#include "DebugConsoleWindow.h"
+#include "FrameTelemetry.h"
+#include <string>
+
+#include "DebugUtils.h"
+const int debugFlag = DEBUG_GAME_STATE;
+
+void InputBuffer::initialize()
+{
+   head = 0;
+   count = 0;
+   recording = NULL;
+   replay = NULL;
+
+   for(int key = 0; key < SDLK_LAST; ++key)
+   {
+      keysDown[key] = false;
+      keysPressed[key] = false;
+      pressTimes[key] = 0;
+      pressPending[key] = false;
+   }
+}
+
+void InputBuffer::finish()
+{
+}
+
+bool InputBuffer::pushEvent(const SDL_Event& event, unsigned long drainTime)
+{
+   if(count == CAPACITY)
+   {
+      return false;
+   }
+
+   InputEvent& inputEvent = events[(head + count) % CAPACITY];
+   inputEvent.event = event;
+   inputEvent.drainTime = drainTime;
+   ++count;
+   return true;
+}
+
+void InputBuffer::pollEvents(unsigned long tick)
+{
+   const unsigned long drainTime = FrameTelemetry::getMicroseconds();
+   SDL_Event event;
+
+   if(replay != NULL)
+   {
+      while(SDL_PollEvent(&event))
+      {
+         if(event.type == SDL_QUIT)
+         {
+            pushEvent(event, drainTime);
+         }
+         else if(event.type == SDL_USEREVENT && event.user.code == DEBUG_CONSOLE_EVENT)
+         {
+            // The replayed keys type the debug console commands again, but the recording already has them
+            delete (std::string*)event.user.data1;
+         }
+      }
+
+      while(count < CAPACITY && replay->playEvent(tick, event))
+      {
+         pushEvent(event, drainTime);
+      }
+
+      return;
+   }
+
+   while(count < CAPACITY)
+   {
+      if(!SDL_PollEvent(&event))
+      {
+         return;
+      }
+
+      if(recording != NULL)
+      {
+         recording->addEvent(tick, event);
+      }
+
+      pushEvent(event, drainTime);
+   }
+
+   DEBUG("Input buffer is full; leaving the remaining events in the SDL queue.");
+}
+
+void InputBuffer::startRecording(InputRecording* inputRecording)
+{
+   recording = inputRecording;
+}
+
+void InputBuffer::startReplay(InputRecording* inputRecording)
+{
+   replay = inputRecording;
+}
+
+bool InputBuffer::isReplaying() const
+{
+   return replay != NULL;
+}
+
+void InputBuffer::beginTick()
+{
+   for(int key = 0; key < SDLK_LAST; ++key)
+   {
+      keysPressed[key] = false;
+   }
+}
+
+bool InputBuffer::popEvent(SDL_Event& event)
+{
+   if(count == 0)
+   {
+      return false;
+   }
+
+   const InputEvent& inputEvent = events[head];
+   event = inputEvent.event;
+   trackKeys(inputEvent);
+
+   head = (head + 1) % CAPACITY;
+   --count;
+   return true;
+}
+
+void InputBuffer::trackKeys(const InputEvent& inputEvent)
+{
+   const SDL_Event& event = inputEvent.event;
+   switch(event.type)
+   {
+      case SDL_KEYDOWN:
+      {
+         const SDLKey key = event.key.keysym.sym;
+         keysDown[key] = true;
+         keysPressed[key] = true;
+         pressTimes[key] = inputEvent.drainTime;
+         pressPending[key] = true;
+         break;
+      }
+      case SDL_KEYUP:
+      {
+         keysDown[event.key.keysym.sym] = false;
+         break;
+      }
+      default:
+      {
+         break;
+      }
+   }
+}
+
+bool InputBuffer::isKeyDown(SDLKey key) const
+{
+   return keysDown[key] || keysPressed[key];
+}
+
+void InputBuffer::reportKeyResponse(SDLKey key)
+{
+   if(pressPending[key])
+   {
+      pressPending[key] = false;
+      FrameTelemetry::getInstance()->addSample(FrameTelemetry::INPUT_LATENCY, FrameTelemetry::getMicroseconds() - pressTimes[key]);
+   }
+}
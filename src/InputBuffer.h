@@ -0,0 +1,176 @@
+/*
+ *  This file is covered by the Ruby license. See LICENSE.txt for more details.
+ *
+ *  Copyright (C) 2007-2012 Noam Chitayat. All rights reserved.
+ */
+
+#ifndef INPUT_BUFFER_H
+#define INPUT_BUFFER_H
+
+#include "Singleton.h"
+#include <SDL.h>
+
+class InputRecording;
+
+/**
+ * Collects the input events of the game so that the game states can handle
+ * them in order, one logic tick at a time.
+ *
+ * Once per frame, the execution stack drains all the pending SDL events into
+ * a ring buffer, stamping each one with the time it was drained. During each
+ * logic tick, the active game state pops the buffered events in the order they
+ * happened, so the first tick of a frame handles all the events collected for
+ * that frame. The buffer also keeps track of which keys are held down
+ * according to the events handled so far, so that movement follows the same
+ * ordered stream of events instead of sampling the keyboard whenever a tick runs.
+ * A key that is pressed and released between two ticks still counts as held
+ * during the next tick, so short taps are never lost.
+ *
+ * When a tick responds to a key press (e.g. by moving the player character), the
+ * time since the press was drained is added to the frame telemetry as the input
+ * latency. SDL 1.2 doesn't timestamp its events, so the time they were drained is
+ * the earliest known time that they arrived.
+ *
+ * The events can also be recorded along with the ticks they arrived in, or
+ * played back from a recording instead of coming from SDL (see InputRecording).
+ *
+ * Note: This class is a singleton.
+ *
+ * @author Noam Chitayat
+ */
+class InputBuffer : public Singleton<InputBuffer>
+{
+   /**
+    * The maximum number of buffered events. Once the buffer is full, further events
+    * are left in the SDL event queue until the game states catch up.
+    */
+   static const unsigned int CAPACITY = 256;
+
+   /** An input event, along with the time it was drained from SDL. */
+   struct InputEvent
+   {
+      /** The event. */
+      SDL_Event event;
+
+      /** The time (in microseconds) when the event was drained. */
+      unsigned long drainTime;
+   };
+
+   /** The ring buffer of input events. */
+   InputEvent events[CAPACITY];
+
+   /** The index of the oldest buffered event. */
+   unsigned int head;
+
+   /** The number of buffered events. */
+   unsigned int count;
+
+   /** true iff the key is held down, according to the events popped so far. */
+   bool keysDown[SDLK_LAST];
+
+   /** true iff the key was pressed by an event popped during the current tick. */
+   bool keysPressed[SDLK_LAST];
+
+   /** The time (in microseconds) when the latest press of the key was drained. */
+   unsigned long pressTimes[SDLK_LAST];
+
+   /** true iff the latest press of the key hasn't been responded to yet. */
+   bool pressPending[SDLK_LAST];
+
+   /** The recording to add incoming events to, or NULL if input isn't being recorded. */
+   InputRecording* recording;
+
+   /** The recording to play events back from instead of SDL, or NULL if input isn't being replayed. */
+   InputRecording* replay;
+
+   /**
+    * Add an event to the end of the buffer, unless the buffer is full.
+    *
+    * @param event The event to add.
+    * @param drainTime The time (in microseconds) when the event was drained.
+    *
+    * @return true iff the event was added.
+    */
+   bool pushEvent(const SDL_Event& event, unsigned long drainTime);
+
+   /**
+    * Update the key states with an event that was just popped.
+    *
+    * @param inputEvent The popped event.
+    */
+   void trackKeys(const InputEvent& inputEvent);
+
+   protected:
+      /**
+       * Initializes an empty buffer with all keys released.
+       */
+      void initialize();
+
+      /**
+       * Cleans up the buffer.
+       */
+      void finish();
+
+   public:
+      /**
+       * Drain all the pending SDL events into the buffer (or as many as fit).
+       * Called once per frame, before the logic ticks of the frame run (or before
+       * every tick during a replay, so that each recorded event arrives at its own tick).
+       * During a replay, the recorded events are played back instead, and live input is ignored
+       * (except for closing the game window).
+       *
+       * @param tick The number of the next logic tick to run.
+       */
+      void pollEvents(unsigned long tick);
+
+      /**
+       * Start adding every event that arrives to a recording.
+       *
+       * @param inputRecording The recording to add events to (owned by the caller), or NULL to stop recording.
+       */
+      void startRecording(InputRecording* inputRecording);
+
+      /**
+       * Start playing events back from a recording, instead of collecting them from SDL.
+       *
+       * @param inputRecording The recording to play back (owned by the caller), or NULL to stop the replay.
+       */
+      void startReplay(InputRecording* inputRecording);
+
+      /**
+       * @return true iff events are being played back from a recording.
+       */
+      bool isReplaying() const;
+
+      /**
+       * Start handling the events of a new logic tick, which forgets the key presses of the last tick.
+       */
+      void beginTick();
+
+      /**
+       * Pop the oldest buffered event.
+       *
+       * @param event Returned as the popped event.
+       *
+       * @return true iff there was an event to pop.
+       */
+      bool popEvent(SDL_Event& event);
+
+      /**
+       * @param key The key to check.
+       *
+       * @return true iff the key is held down, or was pressed during the current tick.
+       */
+      bool isKeyDown(SDLKey key) const;
+
+      /**
+       * Report that the game has responded to the latest press of a key, adding the time
+       * since the press was drained to the frame telemetry as the input latency.
+       * Only the first response to each press is measured.
+       *
+       * @param key The key that was responded to.
+       */
+      void reportKeyResponse(SDLKey key);
+};
+
+#endif
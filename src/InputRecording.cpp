@@ -0,0 +1,297 @@
+/*
+ *  This file is covered by the Ruby license. See LICENSE.txt for more details.
+ *
+ *  Copyright (C) 2007-2012 Noam Chitayat. All rights reserved.
+ */
+
+#include "InputRecording.h"
+#include "DebugConsoleWindow.h"
+#include <fstream>
+#include <sstream>
+
+#include "DebugUtils.h"
+const int debugFlag = DEBUG_MAIN;
+
+/** The first line of every recording file, identifying the file format and its version. */
+static const std::string FILE_HEADER = "EDEN-INPUT-RECORDING 2";
+
+/**
+ * Read a "<name> <value>" header line of a recording.
+ *
+ * @param input The recording file.
+ * @param name The expected name of the header line.
+ *
+ * @return The value of the header line (the rest of the line after the name and a space).
+ */
+static std::string readHeaderLine(std::istream& input, const std::string& name)
+{
+   std::string line;
+   if(!std::getline(input, line) || line.compare(0, name.size(), name) != 0)
+   {
+      T_T("Input recording is missing its " + name + " line.");
+   }
+
+   return line.size() > name.size() ? line.substr(name.size() + 1) : "";
+}
+
+unsigned long InputRecording::hashFile(const std::string& path)
+{
+   std::ifstream input(path.c_str(), std::ios::binary);
+   if(!input)
+   {
+      T_T("Unable to read saved game for input recording: " + path);
+   }
+
+   // 32-bit FNV-1a
+   unsigned long hash = 2166136261UL;
+   char byte;
+   while(input.get(byte))
+   {
+      hash = ((hash ^ (unsigned char)byte) * 16777619UL) & 0xFFFFFFFFUL;
+   }
+
+   return hash;
+}
+
+InputRecording::InputRecording(const std::string& chapterName, const std::string& playerDataPath, unsigned int seed)
+   : chapterName(chapterName), playerDataPath(playerDataPath), playerDataHash(0), seed(seed), numTicks(0), nextAction(0)
+{
+   if(!playerDataPath.empty())
+   {
+      playerDataHash = hashFile(playerDataPath);
+   }
+}
+
+InputRecording::InputRecording(const std::string& path) : nextAction(0)
+{
+   std::ifstream input(path.c_str());
+   std::string line;
+   if(!input || !std::getline(input, line) || line != FILE_HEADER)
+   {
+      T_T("Unable to load input recording: " + path);
+   }
+
+   chapterName = readHeaderLine(input, "chapter");
+   playerDataPath = readHeaderLine(input, "savegame");
+   std::istringstream(readHeaderLine(input, "savegamehash")) >> std::hex >> playerDataHash;
+
+   // Replaying from a different saved game would silently diverge from the recording
+   if(!playerDataPath.empty() && hashFile(playerDataPath) != playerDataHash)
+   {
+      T_T("The saved game " + playerDataPath + " has changed since the input recording was made: " + path);
+   }
+   std::istringstream(readHeaderLine(input, "seed")) >> seed;
+   std::istringstream(readHeaderLine(input, "ticks")) >> numTicks;
+
+   while(std::getline(input, line))
+   {
+      if(line.empty()) continue;
+
+      std::istringstream fields(line);
+      Action action;
+      std::string kind;
+      fields >> action.tick >> kind;
+
+      SDL_Event& event = action.event;
+      if(kind == "key")
+      {
+         int down, sym, mod, unicode, scancode;
+         fields >> down >> sym >> mod >> unicode >> scancode;
+         event.type = down ? SDL_KEYDOWN : SDL_KEYUP;
+         event.key.state = down ? SDL_PRESSED : SDL_RELEASED;
+         event.key.keysym.sym = SDLKey(sym);
+         event.key.keysym.mod = SDLMod(mod);
+         event.key.keysym.unicode = Uint16(unicode);
+         event.key.keysym.scancode = Uint8(scancode);
+      }
+      else if(kind == "motion")
+      {
+         int state, x, y, xrel, yrel;
+         fields >> state >> x >> y >> xrel >> yrel;
+         event.type = SDL_MOUSEMOTION;
+         event.motion.state = Uint8(state);
+         event.motion.x = Uint16(x);
+         event.motion.y = Uint16(y);
+         event.motion.xrel = Sint16(xrel);
+         event.motion.yrel = Sint16(yrel);
+      }
+      else if(kind == "button")
+      {
+         int down, button, x, y;
+         fields >> down >> button >> x >> y;
+         event.type = down ? SDL_MOUSEBUTTONDOWN : SDL_MOUSEBUTTONUP;
+         event.button.state = down ? SDL_PRESSED : SDL_RELEASED;
+         event.button.button = Uint8(button);
+         event.button.x = Uint16(x);
+         event.button.y = Uint16(y);
+      }
+      else if(kind == "quit")
+      {
+         event.type = SDL_QUIT;
+      }
+      else if(kind == "script")
+      {
+         event.type = SDL_USEREVENT;
+         event.user.code = DEBUG_CONSOLE_EVENT;
+         event.user.data1 = NULL;
+         event.user.data2 = NULL;
+
+         // The script is the rest of the line after the separating space
+         fields.get();
+         std::getline(fields, action.script);
+      }
+      else
+      {
+         T_T("Unknown event in input recording: " + line);
+      }
+
+      if(fields.fail())
+      {
+         T_T("Malformed event in input recording: " + line);
+      }
+
+      actions.push_back(action);
+   }
+
+   DEBUG("Loaded input recording of %lu ticks with %u events.", numTicks, (unsigned int)actions.size());
+}
+
+void InputRecording::addEvent(unsigned long tick, const SDL_Event& event)
+{
+   Action action;
+   action.tick = tick;
+   action.event = event;
+
+   switch(event.type)
+   {
+      case SDL_KEYDOWN:
+      case SDL_KEYUP:
+      case SDL_MOUSEMOTION:
+      case SDL_MOUSEBUTTONDOWN:
+      case SDL_MOUSEBUTTONUP:
+      case SDL_QUIT:
+      {
+         break;
+      }
+      case SDL_USEREVENT:
+      {
+         if(event.user.code != DEBUG_CONSOLE_EVENT) return;
+
+         // The event only points to the script, so keep a copy of the script itself
+         action.script = *(std::string*)event.user.data1;
+         break;
+      }
+      default:
+      {
+         return;
+      }
+   }
+
+   actions.push_back(action);
+}
+
+bool InputRecording::playEvent(unsigned long tick, SDL_Event& event)
+{
+   if(nextAction == actions.size() || actions[nextAction].tick > tick)
+   {
+      return false;
+   }
+
+   const Action& action = actions[nextAction];
+   ++nextAction;
+
+   event = action.event;
+   if(event.type == SDL_USEREVENT)
+   {
+      // Whoever handles the debug console event deletes the script
+      event.user.data1 = new std::string(action.script);
+   }
+
+   return true;
+}
+
+void InputRecording::setTickCount(unsigned long ticks)
+{
+   numTicks = ticks;
+}
+
+void InputRecording::save(const std::string& path) const
+{
+   std::ofstream output(path.c_str());
+   if(!output)
+   {
+      T_T("Unable to save input recording: " + path);
+   }
+
+   output << FILE_HEADER << std::endl;
+   output << "chapter " << chapterName << std::endl;
+   output << "savegame " << playerDataPath << std::endl;
+   output << "savegamehash " << std::hex << playerDataHash << std::dec << std::endl;
+   output << "seed " << seed << std::endl;
+   output << "ticks " << numTicks << std::endl;
+
+   for(std::vector<Action>::const_iterator iter = actions.begin(); iter != actions.end(); ++iter)
+   {
+      const SDL_Event& event = iter->event;
+      output << iter->tick << " ";
+
+      switch(event.type)
+      {
+         case SDL_KEYDOWN:
+         case SDL_KEYUP:
+         {
+            output << "key " << (event.type == SDL_KEYDOWN) << " " << int(event.key.keysym.sym) << " "
+                   << int(event.key.keysym.mod) << " " << int(event.key.keysym.unicode) << " "
+                   << int(event.key.keysym.scancode);
+            break;
+         }
+         case SDL_MOUSEMOTION:
+         {
+            output << "motion " << int(event.motion.state) << " " << event.motion.x << " " << event.motion.y
+                   << " " << event.motion.xrel << " " << event.motion.yrel;
+            break;
+         }
+         case SDL_MOUSEBUTTONDOWN:
+         case SDL_MOUSEBUTTONUP:
+         {
+            output << "button " << (event.type == SDL_MOUSEBUTTONDOWN) << " " << int(event.button.button)
+                   << " " << event.button.x << " " << event.button.y;
+            break;
+         }
+         case SDL_QUIT:
+         {
+            output << "quit";
+            break;
+         }
+         case SDL_USEREVENT:
+         {
+            output << "script " << iter->script;
+            break;
+         }
+      }
+
+      output << std::endl;
+   }
+
+   DEBUG("Saved input recording of %lu ticks with %u events to %s.", numTicks, (unsigned int)actions.size(), path.c_str());
+}
+
+const std::string& InputRecording::getChapterName() const
+{
+   return chapterName;
+}
+
+const std::string& InputRecording::getPlayerDataPath() const
+{
+   return playerDataPath;
+}
+
+unsigned int InputRecording::getSeed() const
+{
+   return seed;
+}
+
+unsigned long InputRecording::getTickCount() const
+{
+   return numTicks;
+}
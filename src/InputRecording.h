@@ -0,0 +1,148 @@
+/*
+ *  This file is covered by the Ruby license. See LICENSE.txt for more details.
+ *
+ *  Copyright (C) 2007-2012 Noam Chitayat. All rights reserved.
+ */
+
+#ifndef INPUT_RECORDING_H
+#define INPUT_RECORDING_H
+
+#include <string>
+#include <vector>
+#include <SDL.h>
+
+/**
+ * A recording of a tile engine session, with everything needed to play the session back exactly:
+ * the chapter and saved game it started from, the seed of the random number generator,
+ * and every input event along with the logic tick that it reached the game in.
+ *
+ * Since the game logic runs in fixed ticks, feeding the same events into the
+ * InputBuffer at the same ticks reproduces the session exactly, whether it is played
+ * back at real speed on screen or as fast as possible without a display.
+ * That makes recordings useful as repeatable benchmarks.
+ *
+ * The saved game itself isn't copied into the recording; instead, the recording keeps
+ * a hash of the file, and refuses to play back if the file has changed since.
+ *
+ * Recordings are saved as text, with a header followed by one event per line.
+ * Only keyboard, mouse, quit and debug console events are recorded, since those are
+ * the only events that the game states respond to.
+ *
+ * @author Noam Chitayat
+ */
+class InputRecording
+{
+   /** A recorded input event. */
+   struct Action
+   {
+      /** The logic tick that the event reached the game in. */
+      unsigned long tick;
+
+      /** The event. */
+      SDL_Event event;
+
+      /** The script entered in the debug console (for debug console events only). */
+      std::string script;
+   };
+
+   /** The name of the chapter that the session started. */
+   std::string chapterName;
+
+   /** The path of the saved game that the session started from (empty if none). */
+   std::string playerDataPath;
+
+   /** The hash of the saved game's contents (0 if there is no saved game). */
+   unsigned long playerDataHash;
+
+   /** The seed of the random number generator. */
+   unsigned int seed;
+
+   /** The number of logic ticks that the session ran for. */
+   unsigned long numTicks;
+
+   /** The recorded events, in order. */
+   std::vector<Action> actions;
+
+   /** The index of the next event to play back. */
+   unsigned int nextAction;
+
+   /**
+    * @param path The path of a file.
+    *
+    * @return The FNV-1a hash of the file's contents.
+    */
+   static unsigned long hashFile(const std::string& path);
+
+   public:
+      /**
+       * Constructor. Starts an empty recording.
+       *
+       * @param chapterName The name of the chapter that the session starts.
+       * @param playerDataPath The path of the saved game that the session starts from (empty if none).
+       * @param seed The seed of the random number generator.
+       */
+      InputRecording(const std::string& chapterName, const std::string& playerDataPath, unsigned int seed);
+
+      /**
+       * Constructor. Loads a saved recording, and checks that the saved game
+       * it started from hasn't changed since it was recorded.
+       *
+       * @param path The path of the recording file.
+       */
+      InputRecording(const std::string& path);
+
+      /**
+       * Add an event to the recording.
+       *
+       * @param tick The logic tick that the event reached the game in.
+       * @param event The event. Events of types that aren't recorded are ignored.
+       */
+      void addEvent(unsigned long tick, const SDL_Event& event);
+
+      /**
+       * Play back the next event recorded up to the given tick.
+       * Debug console events are played back with a new copy of their script.
+       *
+       * @param tick The current logic tick.
+       * @param event Returned as the played back event.
+       *
+       * @return true iff there was an event to play back.
+       */
+      bool playEvent(unsigned long tick, SDL_Event& event);
+
+      /**
+       * Set the length of the session.
+       *
+       * @param ticks The number of logic ticks that the session ran for.
+       */
+      void setTickCount(unsigned long ticks);
+
+      /**
+       * Save the recording.
+       *
+       * @param path The path of the recording file.
+       */
+      void save(const std::string& path) const;
+
+      /**
+       * @return The name of the chapter that the session started.
+       */
+      const std::string& getChapterName() const;
+
+      /**
+       * @return The path of the saved game that the session started from (empty if none).
+       */
+      const std::string& getPlayerDataPath() const;
+
+      /**
+       * @return The seed of the random number generator.
+       */
+      unsigned int getSeed() const;
+
+      /**
+       * @return The number of logic ticks that the session ran for.
+       */
+      unsigned long getTickCount() const;
+};
+
+#endif
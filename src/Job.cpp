@@ -0,0 +1,35 @@
+/*
+ *  This file is covered by the Ruby license. See LICENSE.txt for more details.
+ *
+ *  Copyright (C) 2007-2012 Noam Chitayat. All rights reserved.
+ */
+
+#include "Job.h"
+#include "Atomic.h"
+
+Job::Job() : pendingDependencies(1), finished(0), owned(true)
+{
+}
+
+void Job::addDependency(Job* prerequisite)
+{
+   prerequisite->dependents.push_back(this);
+   Atomic::add(&pendingDependencies, 1);
+}
+
+void Job::complete()
+{
+}
+
+bool Job::isFinished() const
+{
+   return Atomic::load(const_cast<volatile long*>(&finished)) != 0;
+}
+
+Job::~Job()
+{
+}
+
+void BarrierJob::run()
+{
+}
@@ -0,0 +1,100 @@
+/*
+ *  This file is covered by the Ruby license. See LICENSE.txt for more details.
+ *
+ *  Copyright (C) 2007-2012 Noam Chitayat. All rights reserved.
+ */
+
+#ifndef JOB_H
+#define JOB_H
+
+#include <vector>
+
+class JobSystem;
+
+/**
+ * A unit of work that the JobSystem runs on one of its worker threads.
+ *
+ * A job may depend on other jobs, in which case it only runs once all of them
+ * have finished running. When a job is done, the main thread completes it during
+ * its next call to JobSystem::runContinuations, so that the results of the work
+ * can be handed to the rest of the engine (which is not thread-safe).
+ *
+ * Subclasses implement run() with the work itself, which must not touch any
+ * engine state that the main thread could be using at the same time.
+ *
+ * @author Noam Chitayat
+ */
+class Job
+{
+   friend class JobSystem;
+
+   /** The jobs waiting on this one to finish. */
+   std::vector<Job*> dependents;
+
+   /**
+    * The number of prerequisites that haven't finished yet, plus one until the job is started.
+    * The job is queued to run once this reaches zero.
+    */
+   volatile long pendingDependencies;
+
+   /** Nonzero once the job has finished running. */
+   volatile long finished;
+
+   /** true iff the job system deletes the job once it has been completed. */
+   bool owned;
+
+   protected:
+      /**
+       * Perform the work of the job. Called on a worker thread (or on the main thread
+       * while it waits for a job).
+       */
+      virtual void run() = 0;
+
+      /**
+       * Hand the results of the job to the rest of the engine. Called on the main
+       * thread after the job has finished running, unless its caller kept ownership
+       * of it. Does nothing by default.
+       */
+      virtual void complete();
+
+   public:
+      /**
+       * Constructor.
+       */
+      Job();
+
+      /**
+       * Make this job wait for another job to finish before it runs.
+       * Must be called before either job is started.
+       *
+       * @param prerequisite The job that has to finish first.
+       */
+      void addDependency(Job* prerequisite);
+
+      /**
+       * @return true iff the job has finished running.
+       */
+      bool isFinished() const;
+
+      /**
+       * Destructor.
+       */
+      virtual ~Job();
+};
+
+/**
+ * A job with no work of its own, which finishes once all of its prerequisites have finished.
+ * Waiting for a barrier waits for all of its prerequisites at once.
+ *
+ * @author Noam Chitayat
+ */
+class BarrierJob : public Job
+{
+   protected:
+      /**
+       * Does nothing.
+       */
+      void run();
+};
+
+#endif
@@ -0,0 +1,331 @@
+/*
+ *  This file is covered by the Ruby license. See LICENSE.txt for more details.
+ *
+ *  Copyright (C) 2007-2012 Noam Chitayat. All rights reserved.
+ */
+
+#include "JobSystem.h"
+#include "Job.h"
+#include "Tracer.h"
+#include <SDL.h>
+#include <SDL_thread.h>
+
+#ifdef _WIN32
+   #include <windows.h>
+#else
+   #include <unistd.h>
+#endif
+
+#include "DebugUtils.h"
+const int debugFlag = DEBUG_MAIN;
+
+void JobSystem::initialize()
+{
+   // The main thread keeps a core busy on its own, and helps with the jobs whenever it waits for one
+   const unsigned int coreCount = getCoreCount();
+   const unsigned int workerCount = coreCount > 1 ? coreCount - 1 : 1;
+
+   jobsAvailable = SDL_CreateSemaphore(0);
+   running = 1;
+   nextWorker = 0;
+   queuedJobCompletions = 0;
+   unfinishedJobs = 0;
+
+   for(unsigned int i = 0; i < workerCount; ++i)
+   {
+      Worker* worker = new Worker();
+      worker->jobSystem = this;
+      worker->index = i;
+      worker->lock = SDL_CreateMutex();
+      workers.push_back(worker);
+   }
+
+   // Only start the threads once every worker exists, since any of them may be stolen from
+   for(std::vector<Worker*>::iterator iter = workers.begin(); iter != workers.end(); ++iter)
+   {
+      (*iter)->thread = SDL_CreateThread(runWorker, *iter);
+   }
+
+   DEBUG("Started %d job workers for %d cores.", workerCount, coreCount);
+}
+
+void JobSystem::finish()
+{
+   Atomic::store(&running, 0);
+
+   // Wake every worker, so that each one sees that it has to stop
+   for(unsigned int i = 0; i < workers.size(); ++i)
+   {
+      SDL_SemPost(jobsAvailable);
+   }
+
+   for(std::vector<Worker*>::iterator iter = workers.begin(); iter != workers.end(); ++iter)
+   {
+      Worker* worker = *iter;
+      SDL_WaitThread(worker->thread, NULL);
+      SDL_DestroyMutex(worker->lock);
+
+      for(std::deque<Job*>::iterator jobIter = worker->jobs.begin(); jobIter != worker->jobs.end(); ++jobIter)
+      {
+         if((*jobIter)->owned)
+         {
+            delete *jobIter;
+         }
+      }
+
+      delete worker;
+   }
+
+   workers.clear();
+   SDL_DestroySemaphore(jobsAvailable);
+
+   // The finished jobs are deleted without completing them, since the engine is shutting down
+   takeContinuations();
+   for(std::vector<PostedContinuation>::iterator iter = pendingContinuations.begin(); iter != pendingContinuations.end(); ++iter)
+   {
+      if(iter->function == &JobSystem::completeJob)
+      {
+         delete static_cast<Job*>(iter->context);
+      }
+   }
+
+   pendingContinuations.clear();
+}
+
+void JobSystem::completeJob(void* job, int value)
+{
+   Job* finishedJob = static_cast<Job*>(job);
+   finishedJob->complete();
+   delete finishedJob;
+}
+
+void JobSystem::takeContinuations()
+{
+   PostedContinuation continuation;
+   while(continuations.pop(continuation))
+   {
+      if(continuation.function == &JobSystem::completeJob)
+      {
+         Atomic::add(&queuedJobCompletions, -1);
+      }
+
+      pendingContinuations.push_back(continuation);
+   }
+}
+
+unsigned int JobSystem::getCoreCount()
+{
+#ifdef _WIN32
+   SYSTEM_INFO systemInfo;
+   GetSystemInfo(&systemInfo);
+   const long coreCount = systemInfo.dwNumberOfProcessors;
+#else
+   const long coreCount = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+
+   return coreCount > 0 ? (unsigned int)coreCount : 1;
+}
+
+int JobSystem::runWorker(void* worker)
+{
+   Worker* self = static_cast<Worker*>(worker);
+   JobSystem* jobSystem = self->jobSystem;
+
+   for(;;)
+   {
+      SDL_SemWait(jobSystem->jobsAvailable);
+      if(!Atomic::load(&jobSystem->running))
+      {
+         break;
+      }
+
+      // The job that woke this worker may already have been taken by another thread
+      Job* job = jobSystem->takeJob(self);
+      if(job != NULL)
+      {
+         jobSystem->execute(job, self);
+      }
+   }
+
+   return 0;
+}
+
+void JobSystem::enqueue(Job* job, Worker* worker)
+{
+   SDL_mutexP(worker->lock);
+   worker->jobs.push_back(job);
+   SDL_mutexV(worker->lock);
+
+   SDL_SemPost(jobsAvailable);
+}
+
+Job* JobSystem::takeJob(Worker* worker)
+{
+   Job* job = NULL;
+
+   if(worker != NULL)
+   {
+      SDL_mutexP(worker->lock);
+      if(!worker->jobs.empty())
+      {
+         job = worker->jobs.back();
+         worker->jobs.pop_back();
+      }
+      SDL_mutexV(worker->lock);
+
+      if(job != NULL) return job;
+   }
+
+   // Steal from the other workers, starting with the next one along so that thieves spread out
+   const unsigned int numWorkers = workers.size();
+   const unsigned int firstVictim = worker != NULL ? worker->index + 1 : 0;
+   for(unsigned int i = 0; i < numWorkers; ++i)
+   {
+      Worker* victim = workers[(firstVictim + i) % numWorkers];
+      if(victim == worker) continue;
+
+      SDL_mutexP(victim->lock);
+      if(!victim->jobs.empty())
+      {
+         job = victim->jobs.front();
+         victim->jobs.pop_front();
+      }
+      SDL_mutexV(victim->lock);
+
+      if(job != NULL) return job;
+   }
+
+   return NULL;
+}
+
+void JobSystem::execute(Job* job, Worker* worker)
+{
+   // The caller may delete a job that it owns as soon as it sees it finish
+   const bool owned = job->owned;
+
+   job->run();
+
+   // Queue the dependents on this worker, since they likely work on the results of this job
+   for(std::vector<Job*>::iterator iter = job->dependents.begin(); iter != job->dependents.end(); ++iter)
+   {
+      if(Atomic::add(&(*iter)->pendingDependencies, -1) == 0)
+      {
+         if(worker != NULL)
+         {
+            enqueue(*iter, worker);
+         }
+         else
+         {
+            enqueue(*iter, workers[nextWorker++ % workers.size()]);
+         }
+      }
+   }
+
+   Atomic::store(&job->finished, 1);
+   if(!owned)
+   {
+      Atomic::add(&unfinishedJobs, -1);
+      return;
+   }
+
+   PostedContinuation continuation;
+   continuation.function = &JobSystem::completeJob;
+   continuation.context = job;
+   continuation.value = 0;
+
+   if(worker == NULL)
+   {
+      // The main thread can't wait on the continuation queue, since it is the one that drains it
+      pendingContinuations.push_back(continuation);
+      Atomic::add(&unfinishedJobs, -1);
+      return;
+   }
+
+   // Leave room in the queue for the callbacks, since they can't wait for the main thread to catch up
+   while(Atomic::add(&queuedJobCompletions, 1) > long(CONTINUATION_QUEUE_SIZE) - RESERVED_CONTINUATIONS)
+   {
+      Atomic::add(&queuedJobCompletions, -1);
+      SDL_Delay(1);
+   }
+
+   while(!continuations.push(continuation))
+   {
+      // The callbacks took the free slots, so give the main thread a chance to catch up
+      SDL_Delay(1);
+   }
+
+   // Only now is the worker free to take another job
+   Atomic::add(&unfinishedJobs, -1);
+}
+
+bool JobSystem::post(Continuation function, void* context, int value)
+{
+   if(instance == NULL)
+   {
+      return false;
+   }
+
+   PostedContinuation continuation;
+   continuation.function = function;
+   continuation.context = context;
+   continuation.value = value;
+   return static_cast<JobSystem*>(instance)->continuations.push(continuation);
+}
+
+void JobSystem::start(Job* job, bool takeOwnership)
+{
+   job->owned = takeOwnership;
+   Atomic::add(&unfinishedJobs, 1);
+
+   // Release the hold that keeps the job from running before it is started
+   if(Atomic::add(&job->pendingDependencies, -1) == 0)
+   {
+      enqueue(job, workers[nextWorker++ % workers.size()]);
+   }
+}
+
+void JobSystem::wait(Job* job)
+{
+   TRACE_ZONE("JobSystem::wait");
+   while(!job->isFinished())
+   {
+      // Keep the continuation queue from filling up, but leave running the continuations for later
+      takeContinuations();
+
+      Job* nextJob = takeJob(NULL);
+      if(nextJob != NULL)
+      {
+         execute(nextJob, NULL);
+      }
+      else
+      {
+         // The remaining jobs are all running, so let the workers have the processor
+         SDL_Delay(0);
+      }
+   }
+}
+
+void JobSystem::runContinuations()
+{
+   takeContinuations();
+   if(pendingContinuations.empty()) return;
+
+   // A continuation may start or wait for jobs, so work from a copy of the list
+   std::vector<PostedContinuation> readyContinuations;
+   readyContinuations.swap(pendingContinuations);
+
+   for(std::vector<PostedContinuation>::iterator iter = readyContinuations.begin(); iter != readyContinuations.end(); ++iter)
+   {
+      iter->function(iter->context, iter->value);
+   }
+}
+
+bool JobSystem::isIdle() const
+{
+   return Atomic::load(const_cast<volatile long*>(&unfinishedJobs)) == 0;
+}
+
+unsigned int JobSystem::getWorkerCount() const
+{
+   return workers.size();
+}
@@ -0,0 +1,230 @@
+/*
+ *  This file is covered by the Ruby license. See LICENSE.txt for more details.
+ *
+ *  Copyright (C) 2007-2012 Noam Chitayat. All rights reserved.
+ */
+
+#ifndef JOB_SYSTEM_H
+#define JOB_SYSTEM_H
+
+#include "Singleton.h"
+#include "LockFreeQueue.h"
+#include <deque>
+#include <vector>
+
+struct SDL_Thread;
+struct SDL_mutex;
+struct SDL_semaphore;
+class Job;
+
+/**
+ * A pool of worker threads that run Jobs alongside the main thread, sized to the
+ * number of processor cores on the machine.
+ *
+ * Every worker keeps its own queue of jobs. A worker takes the newest job from its
+ * own queue, which is usually a job that it just released by finishing one of its
+ * prerequisites. When its own queue is empty, it steals the oldest job from another
+ * worker's queue instead, so that the work spreads out over the idle workers.
+ *
+ * Finished jobs are posted to a lock-free queue of continuations, which the main thread
+ * drains in runContinuations() once per frame to complete and delete them. Callbacks that
+ * run on other threads (such as SDL_mixer's, which run on the audio thread) post their
+ * continuations to the same queue, so that they never touch engine state themselves.
+ *
+ * Note: This class is a singleton. Apart from Job::run() and post(), every function
+ * must be called from the main thread.
+ *
+ * @author Noam Chitayat
+ */
+class JobSystem : public Singleton<JobSystem>
+{
+   /** A continuation posted to the main thread, along with its arguments. */
+   struct PostedContinuation
+   {
+      /** The function to call. */
+      void (*function)(void* context, int value);
+
+      /** The context to call the function with. */
+      void* context;
+
+      /** The value to call the function with. */
+      int value;
+   };
+
+   /** A worker thread and its job queue. */
+   struct Worker
+   {
+      /** The job system that the worker belongs to. */
+      JobSystem* jobSystem;
+
+      /** The index of the worker in the job system. */
+      unsigned int index;
+
+      /** The worker thread. */
+      SDL_Thread* thread;
+
+      /** The lock guarding the job queue. */
+      SDL_mutex* lock;
+
+      /** The jobs queued to run on this worker. */
+      std::deque<Job*> jobs;
+   };
+
+   /** The number of continuations that can wait for the main thread to run them. */
+   static const unsigned long CONTINUATION_QUEUE_SIZE = 1024;
+
+   /**
+    * The number of slots in the continuation queue that finished jobs leave free,
+    * so that callbacks (which can't wait for a free slot) can always post theirs.
+    */
+   static const long RESERVED_CONTINUATIONS = 64;
+
+   /** The workers of the pool. */
+   std::vector<Worker*> workers;
+
+   /** Counts the queued jobs, so that idle workers can sleep until there is work for them. */
+   SDL_semaphore* jobsAvailable;
+
+   /** Nonzero while the workers should keep running. */
+   volatile long running;
+
+   /** The worker that the next job started by the main thread is queued on. */
+   unsigned int nextWorker;
+
+   /** The continuations posted by other threads, waiting for the main thread to run them. */
+   LockFreeQueue<PostedContinuation, CONTINUATION_QUEUE_SIZE> continuations;
+
+   /** The number of finished jobs in the continuation queue. */
+   volatile long queuedJobCompletions;
+
+   /** The number of started jobs that haven't been fully handled by the thread running them yet. */
+   volatile long unfinishedJobs;
+
+   /** The continuations that the main thread took off the queue, but hasn't run yet. */
+   std::vector<PostedContinuation> pendingContinuations;
+
+   /**
+    * Start the worker threads.
+    */
+   void initialize();
+
+   /**
+    * Stop the worker threads and delete the owned jobs that never ran.
+    * Continuations that haven't run yet are dropped.
+    */
+   void finish();
+
+   /**
+    * The continuation of a finished job, which completes and deletes it.
+    *
+    * @param job The finished job.
+    * @param value Unused.
+    */
+   static void completeJob(void* job, int value);
+
+   /**
+    * Move the posted continuations off the queue, without running them yet.
+    */
+   void takeContinuations();
+
+   /**
+    * @return The number of processor cores on the machine.
+    */
+   static unsigned int getCoreCount();
+
+   /**
+    * The entry point of the worker threads.
+    *
+    * @param worker The worker that the thread runs for.
+    */
+   static int runWorker(void* worker);
+
+   /**
+    * Queue a job that is ready to run.
+    *
+    * @param job The job to queue.
+    * @param worker The worker to queue the job on.
+    */
+   void enqueue(Job* job, Worker* worker);
+
+   /**
+    * Take a job to run, preferring the newest job queued on the given worker
+    * and otherwise stealing the oldest job queued on another worker.
+    *
+    * @param worker The worker to take a job from first (NULL to steal from any worker).
+    *
+    * @return The job to run, or NULL if no jobs are queued.
+    */
+   Job* takeJob(Worker* worker);
+
+   /**
+    * Run a job, then release the jobs waiting on it and post its continuation.
+    *
+    * @param job The job to run.
+    * @param worker The worker running the job (NULL for the main thread).
+    */
+   void execute(Job* job, Worker* worker);
+
+   public:
+      /**
+       * A function that the main thread calls to finish handling something that
+       * happened on another thread.
+       *
+       * @param context The context posted with the continuation.
+       * @param value The value posted with the continuation.
+       */
+      typedef void (*Continuation)(void* context, int value);
+
+      /**
+       * Post a continuation for the main thread to run during its next call to runContinuations().
+       * Safe to call from any thread, since it never locks or blocks. Does nothing if the job system
+       * has been destroyed.
+       *
+       * @param function The function to call.
+       * @param context The context to call the function with.
+       * @param value The value to call the function with.
+       *
+       * @return true iff the continuation was posted (false if the queue is full).
+       */
+      static bool post(Continuation function, void* context, int value);
+
+      /**
+       * Start a job, which runs as soon as all of its prerequisites have finished.
+       * By default, the job system takes ownership of the job, and deletes it after completing it.
+       * Otherwise, the job is never completed, and the caller deletes it once it has finished.
+       *
+       * @param job The job to start.
+       * @param takeOwnership Whether the job system should complete and delete the job.
+       */
+      void start(Job* job, bool takeOwnership = true);
+
+      /**
+       * Block until a job has finished running, helping the workers with their queued jobs
+       * in the meantime. No continuations run while waiting, so the job is not completed
+       * until the next call to runContinuations().
+       *
+       * @param job A started job that hasn't been completed yet.
+       */
+      void wait(Job* job);
+
+      /**
+       * Run all the posted continuations, including the ones that complete and delete
+       * the finished jobs. Called once per frame by the main loop, before the game logic.
+       */
+      void runContinuations();
+
+      /**
+       * Since only the main thread starts jobs, the job system stays idle until the
+       * main thread starts another one.
+       *
+       * @return true iff every started job has finished, so that every worker is free.
+       */
+      bool isIdle() const;
+
+      /**
+       * @return The number of worker threads in the pool.
+       */
+      unsigned int getWorkerCount() const;
+};
+
+#endif
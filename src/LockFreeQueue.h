@@ -0,0 +1,126 @@
+/*
+ *  This file is covered by the Ruby license. See LICENSE.txt for more details.
+ *
+ *  Copyright (C) 2007-2012 Noam Chitayat. All rights reserved.
+ */
+
+#ifndef LOCK_FREE_QUEUE_H
+#define LOCK_FREE_QUEUE_H
+
+#include "Atomic.h"
+
+/**
+ * A bounded queue that any number of threads can push into while a single thread pops
+ * from it, without locks. Pushing never blocks; if the queue is full, the push fails.
+ *
+ * Each slot of the ring buffer carries a sequence number, which tells producers
+ * when the slot is free to claim, and the consumer when the claimed slot is filled.
+ * Producers claim slots by advancing the shared push position with compare-and-swap,
+ * so a producer that is interrupted while filling its slot never blocks other producers.
+ *
+ * @param T The type of the queued items. Items are copied in and out of the queue.
+ * @param CAPACITY The number of slots in the queue (a power of two).
+ *
+ * @author Noam Chitayat
+ */
+template<class T, unsigned long CAPACITY> class LockFreeQueue
+{
+   /** A slot of the ring buffer. */
+   struct Slot
+   {
+      /**
+       * Equal to the push position that can claim the slot while it is free,
+       * and to one past the push position that claimed it once it is filled.
+       */
+      volatile long sequence;
+
+      /** The queued item. */
+      T item;
+   };
+
+   /** The ring buffer. */
+   Slot slots[CAPACITY];
+
+   /** The position of the next push (shared by all producers). */
+   volatile long pushPosition;
+
+   /** The position of the next pop (only used by the consumer). */
+   long popPosition;
+
+   public:
+      /**
+       * Constructor. Creates an empty queue.
+       */
+      LockFreeQueue() : pushPosition(0), popPosition(0)
+      {
+         for(unsigned long i = 0; i < CAPACITY; ++i)
+         {
+            slots[i].sequence = long(i);
+         }
+      }
+
+      /**
+       * Add an item to the back of the queue. Safe to call from any thread.
+       *
+       * @param item The item to add.
+       *
+       * @return true iff the item was added (false if the queue is full).
+       */
+      bool push(const T& item)
+      {
+         long position = Atomic::load(&pushPosition);
+         Slot* slot;
+         for(;;)
+         {
+            slot = &slots[(unsigned long)position % CAPACITY];
+            const long difference = Atomic::load(&slot->sequence) - position;
+            if(difference == 0)
+            {
+               // The slot is free, so try to claim it before another producer does
+               const long claimedPosition = Atomic::compareAndSwap(&pushPosition, position, position + 1);
+               if(claimedPosition == position) break;
+               position = claimedPosition;
+            }
+            else if(difference < 0)
+            {
+               // The consumer hasn't emptied the slot since the last time around the ring
+               return false;
+            }
+            else
+            {
+               // Another producer claimed the slot first
+               position = Atomic::load(&pushPosition);
+            }
+         }
+
+         slot->item = item;
+         Atomic::store(&slot->sequence, position + 1);
+         return true;
+      }
+
+      /**
+       * Remove the item at the front of the queue. Must only be called from one thread at a time.
+       *
+       * @param item Returned as the removed item.
+       *
+       * @return true iff there was an item to remove.
+       */
+      bool pop(T& item)
+      {
+         Slot& slot = slots[(unsigned long)popPosition % CAPACITY];
+         if(Atomic::load(&slot.sequence) != popPosition + 1)
+         {
+            // The slot is still empty, or claimed by a producer that hasn't filled it yet
+            return false;
+         }
+
+         item = slot.item;
+
+         // Free the slot for the producer that comes around the ring next
+         Atomic::store(&slot.sequence, popPosition + long(CAPACITY));
+         ++popPosition;
+         return true;
+      }
+};
+
+#endif
@@ -6,6 +6,7 @@
 
 #include "MainMenu.h"
 #include "GraphicsUtil.h"
+#include "InputBuffer.h"
 
 #include "TileEngine.h"
 
@@ -15,7 +16,7 @@
 
 #include "Container.h"
 #include "Label.h"
-#include "OpenGLTTF.h"
+#include "DistanceFieldFont.h"
 #include "StringListModel.h"
 #include "ListBox.h"
 
@@ -48,8 +49,8 @@ MainMenu::MainMenu(ExecutionStack& executionStack) : GameState(executionStack)
       titleLabel = new edwt::Label("Exodus Draconis Engine");
       actionsListBox = new edwt::ListBox(titleOps);
 
-      titleFont = new edwt::OpenGLTrueTypeFont("data/fonts/FairyDustB.ttf", 64);
-      actionsFont = new edwt::OpenGLTrueTypeFont("data/fonts/FairyDustB.ttf", 32);
+      titleFont = new edwt::DistanceFieldFont("data/fonts/FairyDustB.ttf", 64);
+      actionsFont = new edwt::DistanceFieldFont("data/fonts/FairyDustB.ttf", 32);
 
       titleLabel->setForegroundColor(0x666655);
       titleLabel->setFont(titleFont);
@@ -111,9 +112,13 @@ void MainMenu::populateOpsList()
    titleOps->add("Quit", QUIT_GAME_ACTION);
 }
 
-bool MainMenu::step()
+bool MainMenu::step(long timePassed)
 {
-   if(finished) return false;
+   if(finished)
+   {
+      // Keep the title screen running until it has faded out
+      return !GraphicsUtil::getInstance()->isTransitionFinished();
+   }
 
    bool done = false;
 
@@ -121,9 +126,21 @@ bool MainMenu::step()
    music->play();
 #endif
 
-   waitForInputEvent(done);
+   pollInputEvent(done);
+
+   if(done)
+   {
+      fadeOut();
+   }
 
-   return !done;
+   return true;
+}
+
+void MainMenu::fadeOut()
+{
+   finished = true;
+   Music::fadeOutMusic(1000);
+   GraphicsUtil::getInstance()->FadeToColor(0.0f, 0.0f, 0.0f, 1000);
 }
 
 void MainMenu::valueChanged(const gcn::SelectionEvent& event)
@@ -172,58 +189,54 @@ void MainMenu::action(const gcn::ActionEvent& event)
    }
 }
 
-void MainMenu::waitForInputEvent(bool& finishState)
+void MainMenu::pollInputEvent(bool& finishState)
 {
    SDL_Event event;
 
    /* Check for events */
-   SDL_WaitEvent(&event);
-
-   switch (event.type)
+   while(InputBuffer::getInstance()->popEvent(event))
    {
-      case SDL_KEYDOWN:
+      switch (event.type)
       {
-         switch(event.key.keysym.sym)
+         case SDL_KEYDOWN:
          {
-            case SDLK_ESCAPE:
+            switch(event.key.keysym.sym)
             {
-               finishState = true;
-               return;
+               case SDLK_ESCAPE:
+               {
+                  finishState = true;
+                  return;
+               }
+               default:
+               {
+                  break;
+               }
             }
-            default:
-            {
-               break;
-            }
-         }
 
-         break;
-      }
-      case SDL_QUIT:
-      {
-          finishState = true;
-          return;
-      }
-      default:
-      {
-          break;
+            break;
+         }
+         case SDL_QUIT:
+         {
+             finishState = true;
+             return;
+         }
+         default:
+         {
+             break;
+         }
       }
-   }
 
-   // If the main menu didn't consume this event, then propagate to the generic input handling
-   handleEvent(event);
+      // If the main menu didn't consume this event, then propagate to the generic input handling
+      handleEvent(event);
+   }
 }
 
-void MainMenu::draw()
+void MainMenu::draw(float interpolation)
 {
-   /* Don't run too fast */
-   SDL_Delay (1);
 }
 
 MainMenu::~MainMenu()
 {
-   Music::fadeOutMusic(1000);
-   GraphicsUtil::getInstance()->FadeToColor(0.0f, 0.0f, 0.0f, 1000);
-
    delete bg;
    delete actionsListBox;
    delete titleLabel;
@@ -15,7 +15,7 @@ namespace edwt
    class StringListModel;
    class ListBox;
    class Label;
-   class OpenGLTrueTypeFont;
+   class DistanceFieldFont;
 };
 
 class Music;
@@ -52,10 +52,10 @@ class MainMenu: public GameState, public gcn::ActionListener, public gcn::Select
    edwt::StringListModel* titleOps;
 
    /** The font for the title screen heading */
-   edwt::OpenGLTrueTypeFont* titleFont;
+   edwt::DistanceFieldFont* titleFont;
 
    /** The font for the title screen menu options */
-   edwt::OpenGLTrueTypeFont* actionsFont;
+   edwt::DistanceFieldFont* actionsFont;
 
    /**
     * Populate the title screen list with required options
@@ -63,11 +63,17 @@ class MainMenu: public GameState, public gcn::ActionListener, public gcn::Select
    void populateOpsList();
 
    /**
-    * Wait for and handle the input event.
+    * Handle all the pending input events.
     *
-    * @param finishState Returned as true if the input event quit out of the main menu.
+    * @param finishState Returned as true if an input event quit out of the main menu.
     */
-   void waitForInputEvent(bool& finishState);
+   void pollInputEvent(bool& finishState);
+
+   /**
+    * Start fading out the title screen and its music.
+    * The title screen finishes once the screen has faded to black.
+    */
+   void fadeOut();
 
    //Actions for the list ops - see documentation in MainMenuActions.cpp
    void NewGameAction();
@@ -79,18 +85,18 @@ class MainMenu: public GameState, public gcn::ActionListener, public gcn::Select
 
    protected:
       /**
-       * Waits a millisecond between draws (no rush on a title screen)
+       * The title screen is drawn entirely by the GUI.
        */
-      void draw();
+      void draw(float interpolation);
 
       /**
        * Perform logic for the title screen.
-       * NOTE: this method will spin infinitely until user input is received.
-       * Since the screen is static, there is no need to refresh without input.
+       *
+       * @param timePassed The length of the tick (in ms).
        *
        * @return true iff the title screen is not finished running (no quit event)
        */
-      bool step();
+      bool step(long timePassed);
 
    public:
       /**
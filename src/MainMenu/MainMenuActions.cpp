@@ -20,17 +20,19 @@
 //Actions for each of the list ops in the title screen
 
 /**
- * 'New Game' was selected. Push a TileEngine state and fade to black.
+ * 'New Game' was selected. Push a TileEngine state and cross-fade into it.
+ * The title screen stays on screen while the TileEngine loads.
  * [this will eventually change to a chapter selection list, with the fade
  * and pushed state (field or battle) changing based on the chapter].
  */
 void MainMenu::NewGameAction()
 {
-   TileEngine* tileEngine = new TileEngine(executionStack, CHAP1);
-   executionStack.pushState(tileEngine);
    chooseSound->play();
    Music::fadeOutMusic(1000);
-   GraphicsUtil::getInstance()->FadeToColor(0.0f, 0.0f, 0.0f, 1000);
+   GraphicsUtil::getInstance()->crossFade(1000);
+
+   TileEngine* tileEngine = new TileEngine(executionStack, CHAP1);
+   executionStack.pushState(tileEngine);
 }
 
 /**
@@ -72,12 +74,10 @@ void MainMenu::AboutAction()
 }
 
 /**
- * 'Quit Game' was selected. Signal state logic termination, fade to black.
+ * 'Quit Game' was selected. Fade to black, then signal state logic termination.
  */
 void MainMenu::QuitAction()
 {
-   finished = true;
    chooseSound->play();
-   Music::fadeOutMusic(1000);
-   GraphicsUtil::getInstance()->FadeToColor(0.0f, 0.0f, 0.0f, 1000);
+   fadeOut();
 }
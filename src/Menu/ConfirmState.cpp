@@ -7,6 +7,7 @@
 #include "ConfirmState.h"
 #include "ConfirmStateListener.h"
 #include "Container.h"
+#include "InputBuffer.h"
 #include "SDL.h"
 
 #include "DebugUtils.h"
@@ -71,12 +72,12 @@ void ConfirmState::action(const gcn::ActionEvent& event)
    finished = true;
 }
 
-bool ConfirmState::step()
+bool ConfirmState::step(long timePassed)
 {
    SDL_Event event;
 
    /* Check for events */
-   if(SDL_PollEvent(&event))
+   while(InputBuffer::getInstance()->popEvent(event))
    {
       handleEvent(event);
    }
@@ -84,7 +85,7 @@ bool ConfirmState::step()
    return !finished;
 }
 
-void ConfirmState::draw()
+void ConfirmState::draw(float interpolation)
 {
 }
 
@@ -70,8 +70,8 @@ class ConfirmState : public GameState, public gcn::ActionListener
        */
       void action(const gcn::ActionEvent& event);
 
-      bool step();
-      void draw();
+      bool step(long timePassed);
+      void draw(float interpolation);
    
       ~ConfirmState();
 };
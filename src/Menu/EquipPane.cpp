@@ -132,6 +132,7 @@ void EquipPane::refreshEquipSlots()
 void EquipPane::refresh()
 {
    refreshEquipSlots();
+   itemListBox.markDirty();
    itemListBox.adjustSize();
    itemListBox.adjustWidth();
    invalidated = false;
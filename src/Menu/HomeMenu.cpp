@@ -6,6 +6,7 @@
 
 #include "HomeMenu.h"
 #include "GraphicsUtil.h"
+#include "InputBuffer.h"
 
 #include "ResourceLoader.h"
 #include "Music.h"
@@ -41,7 +42,7 @@ HomeMenu::HomeMenu(ExecutionStack& executionStack, MenuShell& menuShell, PlayerD
    pane->setModuleSelectListener(this);
 }
 
-bool HomeMenu::step()
+bool HomeMenu::step(long timePassed)
 {
    if(finished) return false;
 
@@ -57,7 +58,7 @@ void HomeMenu::pollInputEvent(bool& finishState)
    SDL_Event event;
 
    /* Check for events */
-   if(SDL_PollEvent(&event))
+   while(InputBuffer::getInstance()->popEvent(event))
    {
       switch (event.type)
       {
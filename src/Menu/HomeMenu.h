@@ -58,12 +58,12 @@ class HomeMenu: public MenuState, public edwt::ModuleSelectListener, public gcn:
    protected:
       /**
        * Perform logic for the HomeMenu screen.
-       * NOTE: this method will spin wait until user input is received.
-       * Since the screen is static, there is no need to refresh without input.
+       *
+       * @param timePassed The length of the tick (in ms).
        *
        * @return true iff the title screen is not finished running (no quit event)
        */
-      bool step();
+      bool step(long timePassed);
 
    public:
       /**
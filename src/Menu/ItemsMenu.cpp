@@ -17,7 +17,7 @@ const int debugFlag = DEBUG_MENU;
 ItemsMenu::ItemsMenu(ExecutionStack& executionStack, MenuShell& menuShell, PlayerData& playerData) : MenuState(executionStack, menuShell), playerData(playerData)
 {
    Inventory* inventory = playerData.getInventory();
-   inventoryList.setItems(inventory->getItemList());
+   inventoryList.setInventory(inventory);
    ItemsPane* pane = new ItemsPane(inventoryList, menuShell.getDimension());
    pane->setModuleSelectListener(this);
 
@@ -18,7 +18,7 @@ const int debugFlag = DEBUG_MENU;
 
 const std::string ItemsPane::ItemListEventId = "ItemListEvent";
 
-ItemsPane::ItemsPane(ItemListModel& itemList, const gcn::Rectangle& rect) : MenuPane(rect), itemListModel(itemList), listBox(&itemList)
+ItemsPane::ItemsPane(ItemListModel& itemList, const gcn::Rectangle& rect) : MenuPane(rect), invalidated(false), itemListModel(itemList), listBox(&itemList)
 {
    listBox.setNumColumns(2);
    listBox.setMinColumnWidth(0, 200);
@@ -49,7 +49,7 @@ void ItemsPane::action(const gcn::ActionEvent& event)
 void ItemsPane::logic()
 {
    MenuPane::logic();
-   if(invalidated)
+   if(itemListModel.refresh() || invalidated)
    {
       refresh();
    }
@@ -62,8 +62,11 @@ void ItemsPane::invalidate()
 
 void ItemsPane::refresh()
 {
+   // The item list changed behind the list box's back, so it has to be redrawn
+   listBox.markDirty();
    listBox.adjustSize();
    listBox.adjustWidth();
+   invalidated = false;
 }
 
 ItemsPane::~ItemsPane()
@@ -25,6 +25,7 @@ namespace edwt
  */
 class ItemsPane : public MenuPane, public gcn::ActionListener
 {
+   /** true iff the list of items has changed since the pane was last refreshed. */
    bool invalidated;
 
    /** The model holding the item list. */
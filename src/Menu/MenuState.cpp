@@ -11,6 +11,7 @@
 #include "MenuPane.h"
 #include "Container.h"
 #include "TabbedArea.h"
+#include "InputBuffer.h"
 #include <SDL.h>
 #include "DebugUtils.h"
 
@@ -40,11 +41,8 @@ void MenuState::activate()
    menuPane->setVisible(true);
 }
 
-bool MenuState::step()
+bool MenuState::step(long timePassed)
 {
-   /* Don't run too fast */
-   SDL_Delay (1);
-
    if(finished) return false;
    bool done = false;
 
@@ -57,7 +55,7 @@ void MenuState::pollInputEvent(bool& finishState)
 {  
    /* Check for events */
    SDL_Event event;
-   if(SDL_PollEvent(&event))
+   while(InputBuffer::getInstance()->popEvent(event))
    {
       switch (event.type)
       {
@@ -89,7 +87,7 @@ void MenuState::pollInputEvent(bool& finishState)
    }
 }
 
-void MenuState::draw()
+void MenuState::draw(float interpolation)
 {
 }
 
@@ -74,14 +74,16 @@ class MenuState : public GameState, public edwt::TabChangeListener
 
       /**
        * Processes for events common to all menu states, such as "cancel" actions.
+       *
+       * @param timePassed The length of the tick (in ms).
        */
-      virtual bool step();
+      virtual bool step(long timePassed);
    
       /**
        * Common menu drawing code should go here.
        * Currently, the GUI takes care of all of that, so this method will remain empty for now.
        */
-      virtual void draw();
+      virtual void draw(float interpolation);
 
       /**
        * Destructor.
@@ -7,16 +7,50 @@
 #include "ItemListModel.h"
 #include "ItemData.h"
 #include "Item.h"
+#include "Inventory.h"
 #include <sstream>
 
+ItemListModel::ItemListModel() : inventory(NULL), inventoryRevision(0)
+{
+}
+
+void ItemListModel::setInventory(const Inventory* newInventory)
+{
+   inventory = newInventory;
+   inventoryRevision = inventory->getRevision();
+
+   const ItemList& inventoryItems = inventory->getItemList();
+   itemList.assign(inventoryItems.begin(), inventoryItems.end());
+
+   elements.clear();
+   elements.resize(itemList.size());
+}
+
 void ItemListModel::setItems(ItemList& newList)
 {
+   inventory = NULL;
    itemList.assign(newList.begin(), newList.end());
+
+   elements.clear();
+   elements.resize(itemList.size());
 }
 
 void ItemListModel::clear()
 {
+   inventory = NULL;
    itemList.clear();
+   elements.clear();
+}
+
+bool ItemListModel::refresh()
+{
+   if(inventory == NULL || inventory->getRevision() == inventoryRevision)
+   {
+      return false;
+   }
+
+   setInventory(inventory);
+   return true;
 }
 
 int ItemListModel::getNumberOfElements()
@@ -26,12 +60,19 @@ int ItemListModel::getNumberOfElements()
 
 std::string ItemListModel::getElementAt(int i)
 {
-   std::stringstream stream;
-   stream << getItemAt(i)->getName();
-   stream << '\t';
-   stream << itemList[i].second;
+   // Formatting is only done once per item, since list boxes ask for their rows every time they draw
+   std::string& element = elements[i];
+   if(element.empty())
+   {
+      std::stringstream stream;
+      stream << getItemAt(i)->getName();
+      stream << '\t';
+      stream << itemList[i].second;
+
+      element = stream.str();
+   }
 
-   return stream.str();
+   return element;
 }
 
 const Item* ItemListModel::getItemAt(int i)
@@ -11,15 +11,48 @@
 #include "guichan.hpp"
 #include <vector>
 
+class Inventory;
 class Item;
 
 class ItemListModel : public gcn::ListModel
 {
+   /** The inventory that the items are copied from, or NULL if the items were set directly. */
+   const Inventory* inventory;
+
+   /** The revision of the inventory when the items were copied from it. */
+   unsigned int inventoryRevision;
+
    ItemList itemList;
+
+   /**
+    * The formatted strings of the items, parallel to the item list.
+    * A string is empty until its item is first asked for.
+    */
+   std::vector<std::string> elements;
    
    public:
+      /**
+       * Constructor.
+       */
+      ItemListModel();
+
+      /**
+       * Show the items of an inventory, and keep following the inventory as it changes.
+       *
+       * @param newInventory The inventory to show the items of.
+       */
+      void setInventory(const Inventory* newInventory);
+
       void setItems(ItemList& newList);
       void clear();
+
+      /**
+       * Copy the items from the inventory again if it has changed since they were copied.
+       *
+       * @return true iff the items were copied again.
+       */
+      bool refresh();
+
       int getNumberOfElements();
       std::string getElementAt(int i);
       const Item* getItemAt(int i);
@@ -9,11 +9,25 @@
 #include "json.h"
 #include "SaveGameItemNames.h"
 
+Inventory::Inventory() : revision(0)
+{
+}
+
 ItemList& Inventory::getItemList()
 {
    return items;
 }
 
+const ItemList& Inventory::getItemList() const
+{
+   return items;
+}
+
+unsigned int Inventory::getRevision() const
+{
+   return revision;
+}
+
 ItemList Inventory::getItemsByTypes(std::vector<int> acceptedTypes) const
 {
    /**
@@ -32,6 +46,8 @@ void Inventory::load(Json::Value& inventoryJson)
       itemQuantity = (*iter)[ITEM_QUANTITY_ATTRIBUTE].asInt();
       items.push_back(std::pair<int,int>(itemNum, itemQuantity));
    }
+
+   ++revision;
 }
 
 Json::Value Inventory::serialize() const
@@ -110,7 +126,8 @@ bool Inventory::addItem(int itemId, int quantity)
    {
       itemIter->second += quantity;
    }
-   
+
+   ++revision;
    return true;
 }
 
@@ -135,7 +152,8 @@ bool Inventory::removeItem(int itemId, int quantity)
             {
                items.erase(iter);
             }
-            
+
+            ++revision;
             return true;
          }
          
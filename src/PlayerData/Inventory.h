@@ -28,6 +28,9 @@ class Inventory
    /** The items held in the inventory. */
    ItemList items;
 
+   /** The number of times the items in the inventory have changed. */
+   unsigned int revision;
+
    /**
     * Searches the inventory for the item quantity of the specified item ID.
     *
@@ -45,12 +48,30 @@ class Inventory
    ItemList::iterator findItem(int itemId);
 
    public:
+      /**
+       * Constructor.
+       */
+      Inventory();
+
       /**
        * @return The item list that represents the inventory.
        * \todo Remove this function when possible to promote encapsulation.
        */
       ItemList& getItemList();
 
+      /**
+       * @return The item list that represents the inventory.
+       */
+      const ItemList& getItemList() const;
+
+      /**
+       * Note that changes made through the (non-const) item list are not counted.
+       *
+       * @return A number that changes whenever items are loaded, added or removed,
+       *         so that views of the inventory can tell when they are out of date.
+       */
+      unsigned int getRevision() const;
+
       /**
        * Gets a list of items and their quantities in the inventory, filtered by a list of types.
        *
@@ -11,6 +11,7 @@
 #include "Tileset.h"
 #include "Region.h"
 #include "Spritesheet.h"
+#include "Tracer.h"
 
 #include <fstream>
 
@@ -77,6 +78,8 @@ Resource* ResourceLoader::loadNewResource(ResourceKey name, ResourceType type)
 void ResourceLoader::tryInitialize(Resource* resource, ResourceKey name, ResourceType type)
 {
    DEBUG("Trying to initialize resource %s", name.c_str());
+   TRACE_ZONE("ResourceLoader::tryInitialize");
+
    // Get the path to the data for this resource
    std::string path = getPath(name, type);
 
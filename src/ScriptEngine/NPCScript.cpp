@@ -6,6 +6,7 @@
 
 #include "NPCScript.h"
 #include "NPC.h"
+#include "LuaActor.h"
 #include "DebugUtils.h"
 
 const int debugFlag = DEBUG_NPC;
@@ -23,7 +24,7 @@ extern "C"
 
 const char* NPCScript::FUNCTION_NAMES[] = { "idle", "activate" };
 
-NPCScript::NPCScript(lua_State* luaVM, const std::string& scriptPath, NPC* npc) : Script(scriptPath), npc(npc), activated(false), finished(false)
+NPCScript::NPCScript(lua_State* luaVM, const std::string& scriptPath, NPC* npc) : Script(scriptPath), npc(npc), tileEngine(NULL), activated(false), finished(false)
 {
    luaStack = lua_newthread(luaVM);
 
@@ -97,6 +98,12 @@ NPCScript::NPCScript(lua_State* luaVM, const std::string& scriptPath, NPC* npc)
 
 }
 
+void NPCScript::setHandle(const TileEngine& tileEngine, const NPCHandle& handle)
+{
+   this->tileEngine = &tileEngine;
+   this->handle = handle;
+}
+
 bool NPCScript::callFunction(NPCFunction function)
 {
    if(functionExists[function])
@@ -113,8 +120,15 @@ bool NPCScript::callFunction(NPCFunction function)
       lua_pushstring(luaStack, functionName);
       lua_gettable(luaStack, -2);
 
-      // Push NPC as argument
-      luaW_push<Actor>(luaStack, npc);
+      // Push a reference to the NPC as argument, which goes stale once the NPC is removed
+      if(tileEngine != NULL)
+      {
+         luapush_NPC(luaStack, *tileEngine, handle);
+      }
+      else
+      {
+         lua_pushnil(luaStack);
+      }
 
       // Run the script
       return runScript(1);
@@ -8,8 +8,10 @@
 #define NPC_SCRIPT_H
 
 #include "Script.h"
+#include "NPCList.h"
 
 class NPC;
+class TileEngine;
 
 /**
  * An NPCScript is a type of Script that holds functions that determine
@@ -61,6 +63,12 @@ class NPCScript : public Script
    /** The NPC controlled by this script's execution. */
    NPC* npc;
 
+   /** The tile engine holding the NPC (NULL until the NPC is added to it). */
+   const TileEngine* tileEngine;
+
+   /** The handle of the NPC within the tile engine, which is passed to the script functions. */
+   NPCHandle handle;
+
    /** True iff the NPC script received a signal to call the NPC's activate function. */
    bool activated;
 
@@ -80,6 +88,16 @@ class NPCScript : public Script
        */
       NPCScript(lua_State* luaVM, const std::string& scriptPath, NPC* npc);
 
+      /**
+       * Set the handle that the script functions receive to refer to the NPC.
+       * Scripts only ever receive the handle, so that they can't reach the NPC
+       * once it has been removed from the tile engine.
+       *
+       * @param tileEngine The tile engine holding the NPC.
+       * @param handle The handle of the NPC within the tile engine.
+       */
+      void setHandle(const TileEngine& tileEngine, const NPCHandle& handle);
+
       /**
        * Call a function on this NPC's script.
        *
@@ -16,6 +16,7 @@
 #include "FileScript.h"
 #include "StringScript.h"
 #include "ScriptFactory.h"
+#include "FrameTelemetry.h"
 
 #include "LuaPlayerCharacter.h"
 #include "LuaActor.h"
@@ -240,6 +241,57 @@ int ScriptEngine::generateRandom(lua_State* luaStack)
    return 1;
 }
 
+int ScriptEngine::getFrameStats(lua_State* luaStack)
+{
+   FrameTelemetry* telemetry = FrameTelemetry::getInstance();
+   int nargs = lua_gettop(luaStack);
+
+   if(nargs == 0)
+   {
+      // Without a phase, return the report of every phase, as shown in the overlay
+      lua_pushstring(luaStack, telemetry->getReport().c_str());
+      return 1;
+   }
+
+   FrameTelemetry::Phase phase;
+   if(!telemetry->findPhase(luaL_checkstring(luaStack, 1), phase))
+   {
+      return luaL_error(luaStack, "Unknown frame phase: %s", lua_tostring(luaStack, 1));
+   }
+
+   const FrameTelemetry::Summary summary = telemetry->summarize(phase);
+   lua_pushnumber(luaStack, summary.p50);
+   lua_pushnumber(luaStack, summary.p95);
+   lua_pushnumber(luaStack, summary.p99);
+   lua_pushnumber(luaStack, summary.max);
+   return 4;
+}
+
+int ScriptEngine::toggleFrameStats(lua_State* luaStack)
+{
+   FrameTelemetry::getInstance()->toggleOverlay();
+   return 0;
+}
+
+int ScriptEngine::dumpFrameStats(lua_State* luaStack)
+{
+   FrameTelemetry::getInstance()->dump(luaL_checkstring(luaStack, 1));
+   return 0;
+}
+
+int ScriptEngine::setDebugOutput(lua_State* luaStack)
+{
+   const std::string flagName(luaL_checkstring(luaStack, 1));
+   const bool enabled = lua_gettop(luaStack) < 2 || lua_toboolean(luaStack, 2);
+
+   if(!DebugUtils::setFlagEnabled(flagName, enabled))
+   {
+      return luaL_error(luaStack, "Unknown debug flag: %s", flagName.c_str());
+   }
+
+   return 0;
+}
+
 int ScriptEngine::setRegion(lua_State* luaStack)
 {
    int nargs = lua_gettop(luaStack);
@@ -152,6 +152,12 @@ class ScriptEngine
       int delay(lua_State* luaStack);
       int generateRandom(lua_State* luaStack);
 
+      ////////////////// Debugging functions //////////////////
+      int getFrameStats(lua_State* luaStack);
+      int toggleFrameStats(lua_State* luaStack);
+      int dumpFrameStats(lua_State* luaStack);
+      int setDebugOutput(lua_State* luaStack);
+
       ///////////////// Tile engine functions /////////////////
       int setRegion(lua_State* luaStack);
 };
@@ -70,6 +70,26 @@ static int luaRandom(lua_State* luaVM)
    return getEngine(luaVM)->generateRandom(luaVM);
 }
 
+static int luaGetFrameStats(lua_State* luaVM)
+{
+   return getEngine(luaVM)->getFrameStats(luaVM);
+}
+
+static int luaToggleFrameStats(lua_State* luaVM)
+{
+   return getEngine(luaVM)->toggleFrameStats(luaVM);
+}
+
+static int luaDumpFrameStats(lua_State* luaVM)
+{
+   return getEngine(luaVM)->dumpFrameStats(luaVM);
+}
+
+static int luaSetDebugOutput(lua_State* luaVM)
+{
+   return getEngine(luaVM)->setDebugOutput(luaVM);
+}
+
 void ScriptEngine::registerFunctions()
 {
    REGISTER("narrate", luaNarrate);
@@ -80,6 +100,12 @@ void ScriptEngine::registerFunctions()
    REGISTER("delay", luaDelay);
    REGISTER("random", luaRandom);
 
+   // Debugging functions (mostly for the debug console)
+   REGISTER("frameStats", luaGetFrameStats);
+   REGISTER("toggleFrameStats", luaToggleFrameStats);
+   REGISTER("dumpFrameStats", luaDumpFrameStats);
+   REGISTER("setDebugOutput", luaSetDebugOutput);
+
    // Tile Engine functions
    REGISTER("setRegion", luaSetRegion);
 }
@@ -123,10 +123,16 @@ void Sprite::step(long timePassed)
    }
 }
 
-void Sprite::draw(int x, int y) const
+shapes::Size Sprite::getFrameSize() const
 {
    int indexToDraw = animation != NULL ? animation->getIndex() : frameIndex;
-   sheet->draw(x, y, indexToDraw);
+   return sheet->getFrameSize(indexToDraw);
+}
+
+void Sprite::draw(int x, int y, SpriteBatch& batch) const
+{
+   int indexToDraw = animation != NULL ? animation->getIndex() : frameIndex;
+   sheet->draw(x, y, indexToDraw, batch);
 }
 
 Sprite::~Sprite()
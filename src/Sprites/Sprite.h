@@ -10,9 +10,11 @@
 #include <string>
 
 #include "MovementDirection.h"
+#include "Size.h"
 
 class Spritesheet;
 class Animation;
+class SpriteBatch;
 
 /**
  * A sprite is a movable object that can go through different animations or
@@ -88,13 +90,19 @@ class Sprite
        */
       void step(long timePassed);
 
+      /**
+       * @return The size (in pixels) of the frame currently being drawn.
+       */
+      shapes::Size getFrameSize() const;
+
       /**
        * Draws the sprite at the specified location.
        *
        * @param x The x-location to draw at.
        * @param y The y-location to draw at.
+       * @param batch The sprite batch to draw the sprite into.
        */
-      void draw(int x, int y) const;
+      void draw(int x, int y, SpriteBatch& batch) const;
 
       /**
        * Destructor.
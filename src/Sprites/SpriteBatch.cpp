@@ -0,0 +1,100 @@
+/*
+ *  This file is covered by the Ruby license. See LICENSE.txt for more details.
+ *
+ *  Copyright (C) 2007-2012 Noam Chitayat. All rights reserved.
+ */
+
+#include "SpriteBatch.h"
+#include "SDL_opengl.h"
+#include "GraphicsUtil.h"
+#include "SpriteFrame.h"
+#include "Texture.h"
+#include <algorithm>
+
+SpriteBatch::SpriteBatch() : depth(0.0f)
+{
+}
+
+void SpriteBatch::setDepth(float newDepth)
+{
+   depth = newDepth;
+}
+
+void SpriteBatch::add(Texture* texture, const SpriteFrame& frame, int x, int y)
+{
+   float destLeft = float(x);
+   float destBottom = float(y);
+   float destRight = destLeft + frame.getWidth();
+   float destTop = destBottom - frame.getHeight();
+
+   const float quadVertices[] = { destLeft, destTop, depth, destRight, destTop, depth,
+                                  destRight, destBottom, depth, destLeft, destBottom, depth };
+   const float quadTexCoords[] = { frame.texLeft, frame.texTop, frame.texRight, frame.texTop,
+                                   frame.texRight, frame.texBottom, frame.texLeft, frame.texBottom };
+
+   vertices.insert(vertices.end(), quadVertices, quadVertices + 12);
+   texCoords.insert(texCoords.end(), quadTexCoords, quadTexCoords + 8);
+
+   if(runs.empty() || runs.back().texture != texture)
+   {
+      Run newRun;
+      newRun.texture = texture;
+      newRun.numQuads = 0;
+      runs.push_back(newRun);
+   }
+
+   ++runs.back().numQuads;
+}
+
+unsigned int SpriteBatch::getQuadCount() const
+{
+   return vertices.size() / 12;
+}
+
+void SpriteBatch::draw(unsigned int firstQuad, unsigned int endQuad) const
+{
+   if(firstQuad >= endQuad) return;
+
+   // Alpha testing skips the (nearly) transparent pixels around the sprites,
+   // so that they don't hide whatever is behind them in the depth buffer
+   GraphicsUtil::getInstance()->setAlphaTestEnabled(true);
+
+   glPushClientAttrib(GL_CLIENT_VERTEX_ARRAY_BIT);
+
+   glEnableClientState(GL_VERTEX_ARRAY);
+   glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+   glVertexPointer(3, GL_FLOAT, 0, &vertices[0]);
+   glTexCoordPointer(2, GL_FLOAT, 0, &texCoords[0]);
+
+   // Draw the part of each run that lies in the range
+   unsigned int runStart = 0;
+   for(std::vector<Run>::const_iterator iter = runs.begin(); iter != runs.end() && runStart < endQuad; ++iter)
+   {
+      const unsigned int runEnd = runStart + iter->numQuads;
+      if(runEnd > firstQuad)
+      {
+         const unsigned int start = std::max(runStart, firstQuad);
+         const unsigned int end = std::min(runEnd, endQuad);
+         iter->texture->bind();
+         glDrawArrays(GL_QUADS, start * 4, (end - start) * 4);
+      }
+
+      runStart = runEnd;
+   }
+
+   glPopClientAttrib();
+}
+
+void SpriteBatch::clear()
+{
+   // Clearing keeps the capacity, so the batch stops allocating once it is warmed up
+   vertices.clear();
+   texCoords.clear();
+   runs.clear();
+}
+
+void SpriteBatch::flush()
+{
+   draw(0, getQuadCount());
+   clear();
+}
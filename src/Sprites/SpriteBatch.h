@@ -0,0 +1,99 @@
+/*
+ *  This file is covered by the Ruby license. See LICENSE.txt for more details.
+ *
+ *  Copyright (C) 2007-2012 Noam Chitayat. All rights reserved.
+ */
+
+#ifndef SPRITE_BATCH_H
+#define SPRITE_BATCH_H
+
+#include <vector>
+
+class Texture;
+struct SpriteFrame;
+
+/**
+ * Collects sprite quads so that they can be drawn together.
+ * Quads are drawn in the order they were added, so consecutive quads from
+ * the same texture (for instance, a crowd of NPCs sharing a spritesheet)
+ * are drawn with a single texture bind and draw call.
+ *
+ * Quads are drawn with alpha testing, and with whatever blending the caller
+ * set up. A range of the quads can be drawn on its own, so that the caller
+ * can interleave translucent sprites with other drawing in back-to-front order.
+ *
+ * @author Noam Chitayat
+ */
+class SpriteBatch
+{
+   /** A sequence of consecutive quads drawn from the same texture. */
+   struct Run
+   {
+      /** The texture to draw the quads with. */
+      Texture* texture;
+
+      /** The number of quads in the run. */
+      unsigned int numQuads;
+   };
+
+   /** The depth to draw newly added quads at. */
+   float depth;
+
+   /** The vertex coordinates (x, y, depth) of the collected quads (4 vertices per quad). */
+   std::vector<float> vertices;
+
+   /** The texture coordinates of the collected quads, parallel to the vertex coordinates. */
+   std::vector<float> texCoords;
+
+   /** The texture runs of the collected quads, in drawing order. */
+   std::vector<Run> runs;
+
+   public:
+      /**
+       * Constructor.
+       */
+      SpriteBatch();
+
+      /**
+       * Set the depth to draw subsequently added sprite frames at.
+       * Quads at the same depth are drawn in the order they were added.
+       *
+       * @param newDepth The new depth.
+       */
+      void setDepth(float newDepth);
+
+      /**
+       * Add a sprite frame to the batch.
+       *
+       * @param texture The spritesheet texture containing the frame.
+       * @param frame The frame to draw.
+       * @param x The x-location to draw the left edge of the frame at.
+       * @param y The y-location to draw the bottom edge of the frame at.
+       */
+      void add(Texture* texture, const SpriteFrame& frame, int x, int y);
+
+      /**
+       * @return The number of quads collected so far.
+       */
+      unsigned int getQuadCount() const;
+
+      /**
+       * Draw a range of the collected quads, keeping them in the batch.
+       *
+       * @param firstQuad The index of the first quad to draw.
+       * @param endQuad The index one past the last quad to draw.
+       */
+      void draw(unsigned int firstQuad, unsigned int endQuad) const;
+
+      /**
+       * Empty the batch.
+       */
+      void clear();
+
+      /**
+       * Draw all the collected quads and empty the batch.
+       */
+      void flush();
+};
+
+#endif
@@ -5,12 +5,25 @@
  */
 
 #include "SpriteFrame.h"
+#include "Size.h"
 
 SpriteFrame::SpriteFrame()
 {
 }
 
-SpriteFrame::SpriteFrame(int left, int top, int right, int bottom)
-                 : left(left), top(top), right(right), bottom(bottom)
+SpriteFrame::SpriteFrame(int left, int top, int right, int bottom, const shapes::Size& sheetSize)
+                 : left(left), top(top), right(right), bottom(bottom),
+                   texLeft(left / float(sheetSize.width)), texTop(top / float(sheetSize.height)),
+                   texRight(right / float(sheetSize.width)), texBottom(bottom / float(sheetSize.height))
 {
 }
+
+int SpriteFrame::getWidth() const
+{
+   return right - left;
+}
+
+int SpriteFrame::getHeight() const
+{
+   return bottom - top;
+}
@@ -7,6 +7,11 @@
 #ifndef SPRITE_FRAME_H
 #define SPRITE_FRAME_H
 
+namespace shapes
+{
+   struct Size;
+};
+
 /**
  * A sprite frame is a single, non-animated (static) frame represented by
  * the coordinates of a sprite in a spritesheet. This could be the frame for
@@ -21,6 +26,9 @@ struct SpriteFrame
    /** The pixel locations of the edges of this sprite in the spritesheet */
    int left, top, right, bottom;
 
+   /** The texture coordinates of the edges of this sprite in the spritesheet */
+   float texLeft, texTop, texRight, texBottom;
+
    /**
     * Constructor.
     * \todo Is this constructor really necessary? I'd rather not create
@@ -35,8 +43,19 @@ struct SpriteFrame
     * @param top The top edge of the frame.
     * @param right The right edge of the frame.
     * @param bottom The bottom edge of the frame.
+    * @param sheetSize The size (in pixels) of the spritesheet, used to precompute the texture coordinates.
+    */
+   SpriteFrame(int left, int top, int right, int bottom, const shapes::Size& sheetSize);
+
+   /**
+    * @return The width (in pixels) of the frame.
+    */
+   int getWidth() const;
+
+   /**
+    * @return The height (in pixels) of the frame.
     */
-   SpriteFrame(int left, int top, int right, int bottom);
+   int getHeight() const;
 };
 
 #endif
@@ -9,6 +9,7 @@
 #include "GraphicsUtil.h"
 #include "Texture.h"
 #include "SpriteFrame.h"
+#include "SpriteBatch.h"
 #include "Animation.h"
 #include <queue>
 #include <fstream>
@@ -116,7 +117,7 @@ void Spritesheet::parseFrames(Json::Value& rootElement)
       int right = currFrame["right"].asInt();
       int bottom = currFrame["bottom"].asInt();
 
-      frameList[i] = SpriteFrame(left, top, right, bottom);
+      frameList[i] = SpriteFrame(left, top, right, bottom, size);
       DEBUG("Frame %s loaded in with coordinates %d, %d, %d, %d",
             frameName.c_str(), left, top, right, bottom);
 
@@ -194,6 +195,17 @@ void Spritesheet::parseAnimations(Json::Value& rootElement)
    }
 }
 
+shapes::Size Spritesheet::getFrameSize(const int frameIndex) const
+{
+   if(frameList == NULL || frameIndex < 0 || frameIndex >= numFrames)
+   {
+      return shapes::Size();
+   }
+
+   const SpriteFrame& f = frameList[frameIndex];
+   return shapes::Size(f.getWidth(), f.getHeight());
+}
+
 int Spritesheet::getFrameIndex(const std::string& frameName) const
 {
    std::map<std::string, int>::const_iterator frameIndex = frameIndices.find(frameName);
@@ -217,7 +229,7 @@ Animation* Spritesheet::getAnimation(const std::string& animationName) const
 }
 
 
-void Spritesheet::draw(const int x, const int y, const int frameIndex) const
+void Spritesheet::draw(const int x, const int y, const int frameIndex, SpriteBatch& batch) const
 {
    if(frameList == NULL)
    {
@@ -226,54 +238,13 @@ void Spritesheet::draw(const int x, const int y, const int frameIndex) const
       return;
    }
 
-   if(frameIndex < 0 || frameIndex > numFrames)
+   if(frameIndex < 0 || frameIndex >= numFrames)
    {
       DEBUG("Spritesheet frame index %d out of bounds!", frameIndex);
       return;
    }
 
-   SpriteFrame f = frameList[frameIndex];
-
-   /**
-    * \todo We can do all these calculations when the frames are initialized
-    *       in order to optimize the drawing code a bit more!
-    */
-   int frameHeight = f.bottom - f.top;
-   int frameWidth = f.right - f.left;
-
-   float frameTop = f.top / float(size.height);
-   float frameBottom = f.bottom / float(size.height);
-   float frameLeft = f.left / float(size.width);
-   float frameRight = f.right / float(size.width);
-   
-   float destLeft = float(x);
-   float destBottom = float(y);
-   float destRight = destLeft + frameWidth;
-   float destTop = destBottom - frameHeight;
-
-   // NOTE: Alpha testing doesn't do transparency; it either draws a pixel or it doesn't
-   // If we want partial transparency, we would need to use alpha blending
-
-   // Retain old alpha test state, function and threshold
-   glPushAttrib(GL_COLOR_BUFFER_BIT);
-
-   // Enable alpha testing
-   glEnable(GL_ALPHA_TEST);
-
-   // Set the alpha blending evaluation function
-   glAlphaFunc(GL_GREATER, 0.1f);
-
-   texture->bind();
-
-   glBegin(GL_QUADS);
-      glTexCoord2f(frameLeft, frameTop); glVertex3f(destLeft, destTop, 0.0f);
-      glTexCoord2f(frameRight, frameTop); glVertex3f(destRight, destTop, 0.0f);
-      glTexCoord2f(frameRight, frameBottom); glVertex3f(destRight, destBottom, 0.0f);
-      glTexCoord2f(frameLeft, frameBottom); glVertex3f(destLeft, destBottom, 0.0f);
-   glEnd();
-
-   // We're done with alpha testing, return to default state
-   glPopAttrib();
+   batch.add(texture, frameList[frameIndex], x, y);
 }
 
 size_t Spritesheet::getSize()
@@ -21,6 +21,7 @@ namespace Json
 struct SpriteFrame;
 class Animation;
 class Texture;
+class SpriteBatch;
 
 /**
  * The Spritesheet class represents an entire spritesheet image. It holds a
@@ -103,8 +104,16 @@ class Spritesheet : public Resource
        * @param x The x-location to draw at.
        * @param y The y-location to draw at.
        * @param frameIndex The frame to draw.
+       * @param batch The sprite batch to draw the frame into.
        */
-      void draw(const int x, const int y, const int frameIndex) const;
+      void draw(const int x, const int y, const int frameIndex, SpriteBatch& batch) const;
+
+      /**
+       * @param frameIndex The frame to measure.
+       *
+       * @return The size (in pixels) of the frame, or an empty size if there is no such frame.
+       */
+      shapes::Size getFrameSize(const int frameIndex) const;
 
       /**
        * Get the index of a frame specified by the frame name.
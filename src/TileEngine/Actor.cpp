@@ -14,10 +14,15 @@
 #include "ActorMoveMessage.h"
 #include "DebugUtils.h"
 
+#include <math.h>
+#include <stdlib.h>
+
 const int debugFlag = DEBUG_NPC;
 
+const unsigned int Actor::NO_MOVEMENT_LANE = ~0u;
+
 Actor::Actor(const std::string& name, const std::string& sheetName, messaging::MessagePipe& messagePipe, EntityGrid& entityGrid, const shapes::Point2D& location, const shapes::Size& size, double movementSpeed, MovementDirection direction)
-   : name(name), pixelLoc(location), messagePipe(messagePipe), size(size), movementSpeed(movementSpeed), currDirection(direction), entityGrid(entityGrid)
+   : name(name), pixelLoc(location), previousPixelLoc(location), messagePipe(messagePipe), size(size), movementSpeed(movementSpeed), currDirection(direction), movementLane(NO_MOVEMENT_LANE), entityGrid(entityGrid)
 {
    Spritesheet* sheet = ResourceLoader::getSpritesheet(sheetName);
    sprite = new Sprite(sheet);
@@ -53,7 +58,7 @@ void Actor::step(long timePassed)
 {
    sprite->step(timePassed);
    
-   if(!isIdle())
+   if(!isIdle() && !entityGrid.getMovementSystem().isWalking(this))
    {
       Order* currentOrder = orders.front();
       if(currentOrder->perform(timePassed))
@@ -64,11 +69,31 @@ void Actor::step(long timePassed)
    }
 }
 
-void Actor::draw()
+void Actor::savePreviousLocation()
+{
+   previousPixelLoc = pixelLoc;
+}
+
+shapes::Point2D Actor::getDrawLocation(float interpolation) const
+{
+   const int deltaX = pixelLoc.x - previousPixelLoc.x;
+   const int deltaY = pixelLoc.y - previousPixelLoc.y;
+   if(abs(deltaX) > TileEngine::TILE_SIZE || abs(deltaY) > TileEngine::TILE_SIZE)
+   {
+      // Don't slide the actor across the map when it is moved instantly
+      return pixelLoc;
+   }
+
+   return shapes::Point2D(previousPixelLoc.x + int(floorf(deltaX * interpolation + 0.5f)),
+                          previousPixelLoc.y + int(floorf(deltaY * interpolation + 0.5f)));
+}
+
+void Actor::draw(SpriteBatch& batch, float interpolation)
 {
    if(sprite)
    {
-      sprite->draw(pixelLoc.x, pixelLoc.y + TileEngine::TILE_SIZE);
+      const shapes::Point2D drawLocation = getDrawLocation(interpolation);
+      sprite->draw(drawLocation.x, drawLocation.y + TileEngine::TILE_SIZE, batch);
    }
    
    if(!orders.empty())
@@ -77,6 +102,20 @@ void Actor::draw()
    }
 }
 
+shapes::Rectangle Actor::getDrawBounds(float interpolation) const
+{
+   const shapes::Point2D drawLocation = getDrawLocation(interpolation);
+   if(!sprite)
+   {
+      return shapes::Rectangle(drawLocation, size);
+   }
+
+   // Sprites are drawn upwards from the bottom of the actor's first tile
+   const shapes::Size frameSize = sprite->getFrameSize();
+   const shapes::Point2D frameTopLeft(drawLocation.x, drawLocation.y + TileEngine::TILE_SIZE - frameSize.height);
+   return shapes::Rectangle(frameTopLeft, frameSize);
+}
+
 bool Actor::isIdle() const
 {
    return orders.empty();
@@ -176,6 +215,7 @@ MovementDirection Actor::getDirection() const
 void Actor::setMovementSpeed(float speed)
 {
    movementSpeed = speed;
+   entityGrid.getMovementSystem().setSpeed(this, speed);
 }
 
 float Actor::getMovementSpeed() const
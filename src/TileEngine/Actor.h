@@ -13,10 +13,13 @@
 #include "MovementDirection.h"
 #include "Size.h"
 #include "Point2D.h"
+#include "Rectangle.h"
 
 class EntityGrid;
+class MovementSystem;
 class Sprite;
 class Spritesheet;
+class SpriteBatch;
 
 namespace messaging
 {
@@ -25,6 +28,8 @@ namespace messaging
 
 class Actor
 {
+   friend class MovementSystem;
+
    /**
     * A class for asynchronous Actor instructions.
     */
@@ -40,6 +45,9 @@ class Actor
 
    /** The current location of the actor (in pixels) */
    shapes::Point2D pixelLoc;
+
+   /** The location of the actor (in pixels) at the start of the current logic tick */
+   shapes::Point2D previousPixelLoc;
    
    /** The size of the actor (in pixels) */
    shapes::Size size;
@@ -49,6 +57,12 @@ class Actor
    
    /** The direction that the actor is currently facing */
    MovementDirection currDirection;
+
+   /** Marks an actor that is not being moved by the MovementSystem. */
+   static const unsigned int NO_MOVEMENT_LANE;
+
+   /** The index of the actor's state in the MovementSystem, or NO_MOVEMENT_LANE. */
+   unsigned int movementLane;
    
    protected:
       /** The Actor's associated sprite, which is drawn on screen. */
@@ -100,17 +114,42 @@ class Actor
 
       /**
        * Performs a logic step of this NPC. During the step, the NPC works on
-       * enqueued Instructions if there are any.
+       * enqueued Instructions if there are any. While the actor is walking
+       * between waypoints, the MovementSystem moves it instead.
        *
        * @param timePassed The amount of time that has passed since the last frame.
        */
       virtual void step(long timePassed);
       
       /**
-       * This function draws the actor in its current location with its current
-       * sprite animation frame.
+       * Remember the actor's current location as its location at the start of the logic tick,
+       * so that its movement during the tick can be smoothed out when it is drawn.
+       */
+      void savePreviousLocation();
+
+      /**
+       * @param interpolation How far (from 0 to 1) the drawn frame is between the last tick and the next one.
+       *
+       * @return The location to draw the actor at, partway between its location before and after the last tick.
+       *         If the actor jumped further than a tile (for instance, by teleporting), it is drawn at its current location.
+       */
+      shapes::Point2D getDrawLocation(float interpolation) const;
+
+      /**
+       * This function draws the actor with its current sprite animation frame,
+       * partway between its location before and after the last tick.
+       *
+       * @param batch The sprite batch to draw the actor's sprite into.
+       * @param interpolation How far (from 0 to 1) the drawn frame is between the last tick and the next one.
+       */
+      virtual void draw(SpriteBatch& batch, float interpolation);
+
+      /**
+       * @param interpolation How far (from 0 to 1) the drawn frame is between the last tick and the next one.
+       *
+       * @return The area of the map (in pixels) covered by the actor's current sprite frame.
        */
-      virtual void draw();
+      shapes::Rectangle getDrawBounds(float interpolation) const;
 
       /**
        * @return true iff the NPC is not chewing on any instructions
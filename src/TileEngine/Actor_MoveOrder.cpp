@@ -7,6 +7,7 @@
 #include "Actor.h"
 #include "Actor_Orders.h"
 #include "SDL_opengl.h"
+#include "GraphicsUtil.h"
 #include "TileEngine.h"
 #include "Map.h"
 #include <math.h>
@@ -23,6 +24,8 @@ Actor::MoveOrder::MoveOrder(Actor& actor, const shapes::Point2D& destination, En
 
 Actor::MoveOrder::~MoveOrder()
 {
+   entityGrid.getMovementSystem().removeWalker(&actor);
+
    if(movementBegun)
    {
       entityGrid.abortMovement(&actor, lastWaypoint, nextWaypoint);
@@ -69,10 +72,22 @@ void Actor::MoveOrder::updateNextWaypoint(shapes::Point2D location, MovementDire
 
 bool Actor::MoveOrder::perform(long timePassed)
 {
+   MovementSystem& movementSystem = entityGrid.getMovementSystem();
    shapes::Point2D location = actor.getLocation();
    MovementDirection newDirection = actor.getDirection();
-   const float vel = actor.getMovementSpeed();
-   cumulativeDistanceCovered +=timePassed * vel;   
+
+   if(movementSystem.hasWalker(&actor))
+   {
+      // The movement system moved the actor to the waypoint, and already
+      // accounted for this frame's time; take back the distance it didn't use.
+      cumulativeDistanceCovered = movementSystem.removeWalker(&actor);
+   }
+   else
+   {
+      const float vel = actor.getMovementSpeed();
+      cumulativeDistanceCovered += timePassed * vel;
+   }
+
    long distanceCovered = 0;
    if(cumulativeDistanceCovered > 1.0)
    {
@@ -145,7 +160,7 @@ bool Actor::MoveOrder::perform(long timePassed)
             return false;
          }
 
-         DEBUG("Next waypoint: %d,%d", nextWaypoint.x, nextWaypoint.y);
+         DEBUG_VERBOSE("Next waypoint: %d,%d", nextWaypoint.x, nextWaypoint.y);
          updateNextWaypoint(location, newDirection);
          updateDirection(newDirection, true);
       }
@@ -178,15 +193,17 @@ bool Actor::MoveOrder::perform(long timePassed)
             if(location.y < nextWaypoint.y) location.y = nextWaypoint.y;
          }
          
-         // Movement for this frame is finished
+         // Movement for this frame is finished; the movement system takes
+         // the actor the rest of the way to the waypoint.
          actor.setLocation(location);
+         movementSystem.addWalker(&actor, nextWaypoint, cumulativeDistanceCovered);
          return false;
       }
       
       // The Actor can reach the next waypoint in this frame
       distanceCovered -= stepDistance;
       
-      DEBUG("Reached waypoint %d,%d", nextWaypoint.x, nextWaypoint.y);
+      DEBUG_VERBOSE("Reached waypoint %d,%d", nextWaypoint.x, nextWaypoint.y);
       entityGrid.endMovement(&actor, lastWaypoint, nextWaypoint);
       movementBegun = false;
 
@@ -204,7 +221,7 @@ void Actor::MoveOrder::draw()
    if(path.empty()) return;
 
    glDisable(GL_TEXTURE_2D);
-   glColor3f(1.0f, 0.0f, 0.0f);
+   GraphicsUtil::getInstance()->setColor(1.0f, 0.0f, 0.0f);
    glBegin(GL_LINE_STRIP);
    for(EntityGrid::Path::const_iterator iter = path.begin(); iter != path.end(); ++iter)
    {
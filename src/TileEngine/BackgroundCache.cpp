@@ -0,0 +1,169 @@
+/*
+ *  This file is covered by the Ruby license. See LICENSE.txt for more details.
+ *
+ *  Copyright (C) 2007-2012 Noam Chitayat. All rights reserved.
+ */
+
+#include "BackgroundCache.h"
+#include "SDL_opengl.h"
+#include "GraphicsUtil.h"
+#include "RenderTexture.h"
+#include "TileEngine.h"
+#include "Layer.h"
+#include "Point2D.h"
+#include "Size.h"
+
+#include <algorithm>
+
+#include "DebugUtils.h"
+
+const int debugFlag = DEBUG_TILE_ENG;
+
+// 16 tiles of 32 pixels make for 512x512 chunk textures
+const int BackgroundCache::CHUNK_TILES = 16;
+
+const unsigned int BackgroundCache::MAX_CHUNK_TEXTURES = 32;
+
+std::list<BackgroundCache::Chunk*> BackgroundCache::recentChunks;
+
+BackgroundCache::BackgroundCache(const std::vector<Layer*>& layers, const shapes::Rectangle& bounds)
+   : layers(layers), bounds(bounds)
+{
+   chunkColumns = (bounds.getWidth() + CHUNK_TILES - 1) / CHUNK_TILES;
+   chunkRows = (bounds.getHeight() + CHUNK_TILES - 1) / CHUNK_TILES;
+
+   Chunk emptyChunk;
+   emptyChunk.texture = NULL;
+   chunks.assign(chunkColumns * chunkRows, emptyChunk);
+}
+
+shapes::Rectangle BackgroundCache::getChunkArea(int chunkX, int chunkY) const
+{
+   const shapes::Point2D topLeft(chunkX * CHUNK_TILES, chunkY * CHUNK_TILES);
+   const shapes::Point2D bottomRight(std::min(topLeft.x + CHUNK_TILES, bounds.right),
+                                     std::min(topLeft.y + CHUNK_TILES, bounds.bottom));
+
+   return shapes::Rectangle(topLeft, bottomRight);
+}
+
+void BackgroundCache::renderChunk(Chunk& chunk, const shapes::Rectangle& chunkArea)
+{
+   // Make room for the new texture by freeing the chunk that went the longest without being drawn
+   if(recentChunks.size() >= MAX_CHUNK_TEXTURES)
+   {
+      freeChunk(*recentChunks.back());
+   }
+
+   const int chunkPixels = CHUNK_TILES * TileEngine::TILE_SIZE;
+   chunk.texture = new RenderTexture(shapes::Size(chunkPixels, chunkPixels));
+   recentChunks.push_front(&chunk);
+   chunk.recentEntry = recentChunks.begin();
+
+   DEBUG("Rendering background chunk at (%d, %d)", chunkArea.left, chunkArea.top);
+
+   chunk.texture->beginDrawing();
+   glTranslated(-chunkArea.left * TileEngine::TILE_SIZE, -chunkArea.top * TileEngine::TILE_SIZE, 0);
+
+   bool firstLayer = true;
+   std::vector<Layer*>::const_iterator iter;
+   for(iter = layers.begin(); iter != layers.end(); ++iter)
+   {
+      (*iter)->draw(chunkArea, !firstLayer);
+      firstLayer = false;
+   }
+
+   chunk.texture->endDrawing();
+}
+
+void BackgroundCache::freeChunk(Chunk& chunk)
+{
+   recentChunks.erase(chunk.recentEntry);
+   delete chunk.texture;
+   chunk.texture = NULL;
+}
+
+void BackgroundCache::draw(const shapes::Rectangle& visibleArea)
+{
+   if(visibleArea.right <= visibleArea.left || visibleArea.bottom <= visibleArea.top) return;
+
+   const int firstChunkX = visibleArea.left / CHUNK_TILES;
+   const int firstChunkY = visibleArea.top / CHUNK_TILES;
+   const int lastChunkX = (visibleArea.right - 1) / CHUNK_TILES;
+   const int lastChunkY = (visibleArea.bottom - 1) / CHUNK_TILES;
+
+   const float chunkPixels = float(CHUNK_TILES * TileEngine::TILE_SIZE);
+   GraphicsUtil* graphics = GraphicsUtil::getInstance();
+
+   for(int chunkY = firstChunkY; chunkY <= lastChunkY; ++chunkY)
+   {
+      for(int chunkX = firstChunkX; chunkX <= lastChunkX; ++chunkX)
+      {
+         Chunk& chunk = chunks[chunkY * chunkColumns + chunkX];
+         const shapes::Rectangle chunkArea = getChunkArea(chunkX, chunkY);
+
+         if(chunk.texture == NULL)
+         {
+            renderChunk(chunk, chunkArea);
+         }
+         else
+         {
+            recentChunks.splice(recentChunks.begin(), recentChunks, chunk.recentEntry);
+         }
+
+         float destLeft = float(chunkArea.left * TileEngine::TILE_SIZE);
+         float destRight = float(chunkArea.right * TileEngine::TILE_SIZE);
+         float destTop = float(chunkArea.top * TileEngine::TILE_SIZE);
+         float destBottom = float(chunkArea.bottom * TileEngine::TILE_SIZE);
+
+         // Chunks at the edges of the map only fill part of their texture.
+         // The texture was drawn upside-down, so its top is at t = 1.
+         float right = (destRight - destLeft) / chunkPixels;
+         float bottom = 1.0f - (destBottom - destTop) / chunkPixels;
+
+         // Chunks are copied as-is; rendering a chunk may have left alpha testing on
+         graphics->setAlphaTestEnabled(false);
+         chunk.texture->bind();
+
+         glBegin(GL_QUADS);
+            glTexCoord2f(0.0f, 1.0f); glVertex3f(destLeft, destTop, 0.0f);
+            glTexCoord2f(right, 1.0f); glVertex3f(destRight, destTop, 0.0f);
+            glTexCoord2f(right, bottom); glVertex3f(destRight, destBottom, 0.0f);
+            glTexCoord2f(0.0f, bottom); glVertex3f(destLeft, destBottom, 0.0f);
+         glEnd();
+      }
+   }
+}
+
+void BackgroundCache::invalidate(const shapes::Rectangle& tiles)
+{
+   if(tiles.right <= std::max(tiles.left, 0) || tiles.bottom <= std::max(tiles.top, 0)) return;
+
+   const int firstChunkX = std::max(tiles.left, 0) / CHUNK_TILES;
+   const int firstChunkY = std::max(tiles.top, 0) / CHUNK_TILES;
+   const int lastChunkX = std::min((tiles.right - 1) / CHUNK_TILES, chunkColumns - 1);
+   const int lastChunkY = std::min((tiles.bottom - 1) / CHUNK_TILES, chunkRows - 1);
+
+   for(int chunkY = firstChunkY; chunkY <= lastChunkY; ++chunkY)
+   {
+      for(int chunkX = firstChunkX; chunkX <= lastChunkX; ++chunkX)
+      {
+         Chunk& chunk = chunks[chunkY * chunkColumns + chunkX];
+         if(chunk.texture != NULL)
+         {
+            freeChunk(chunk);
+         }
+      }
+   }
+}
+
+BackgroundCache::~BackgroundCache()
+{
+   std::vector<Chunk>::iterator iter;
+   for(iter = chunks.begin(); iter != chunks.end(); ++iter)
+   {
+      if(iter->texture != NULL)
+      {
+         freeChunk(*iter);
+      }
+   }
+}
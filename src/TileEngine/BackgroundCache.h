@@ -0,0 +1,124 @@
+/*
+ *  This file is covered by the Ruby license. See LICENSE.txt for more details.
+ *
+ *  Copyright (C) 2007-2012 Noam Chitayat. All rights reserved.
+ */
+
+#ifndef BACKGROUND_CACHE_H
+#define BACKGROUND_CACHE_H
+
+#include <list>
+#include <vector>
+#include "Rectangle.h"
+
+class Layer;
+class RenderTexture;
+
+/**
+ * Caches the composed background layers of a map in square chunk textures.
+ * Each chunk is drawn from the map layers the first time it comes into view,
+ * and from then on the background of a frame costs a single textured quad
+ * per visible chunk, no matter how many layers the map has.
+ *
+ * The chunk textures of all the maps share a fixed budget. Once it is used up,
+ * the least recently drawn chunk is freed to make room for a new one, and is
+ * drawn again from the layers if it comes back into view.
+ *
+ * Whenever a background tile changes, the tiles that changed must be invalidated,
+ * so that the chunks covering them are drawn again.
+ *
+ * @author Noam Chitayat
+ */
+class BackgroundCache
+{
+   /** The size (in tiles) of each side of a chunk. */
+   static const int CHUNK_TILES;
+
+   /**
+    * The most chunk textures kept by all the caches together (each one is 1 MiB),
+    * which is still several times the number of chunks that fit on the screen.
+    */
+   static const unsigned int MAX_CHUNK_TEXTURES;
+
+   /** A cached section of the background. */
+   struct Chunk
+   {
+      /** The composed layers of this chunk, or NULL if the chunk isn't drawn. */
+      RenderTexture* texture;
+
+      /** The entry of this chunk in the list of recently drawn chunks (only valid if it has a texture). */
+      std::list<Chunk*>::iterator recentEntry;
+   };
+
+   /** The chunks of all the caches that have textures, from the most to the least recently drawn. */
+   static std::list<Chunk*> recentChunks;
+
+   /** The background layers of the map, from back to front. */
+   const std::vector<Layer*>& layers;
+
+   /** The bounds (in tiles) of the map. */
+   const shapes::Rectangle& bounds;
+
+   /** The number of chunk columns needed to cover the map. */
+   int chunkColumns;
+
+   /** The number of chunk rows needed to cover the map. */
+   int chunkRows;
+
+   /** The chunks of the map, in row-major order. */
+   std::vector<Chunk> chunks;
+
+   /**
+    * @param chunkX The chunk column.
+    * @param chunkY The chunk row.
+    *
+    * @return The tiles of the map covered by the chunk.
+    */
+   shapes::Rectangle getChunkArea(int chunkX, int chunkY) const;
+
+   /**
+    * Compose the background layers into a chunk's texture.
+    *
+    * @param chunk The chunk to draw (which has no texture yet).
+    * @param chunkArea The tiles of the map covered by the chunk.
+    */
+   void renderChunk(Chunk& chunk, const shapes::Rectangle& chunkArea);
+
+   /**
+    * Free the texture of a chunk, so that it is drawn again the next time it comes into view.
+    *
+    * @param chunk The chunk to free (which has a texture).
+    */
+   static void freeChunk(Chunk& chunk);
+
+   public:
+      /**
+       * Constructor. Chunk textures are only created once they are needed.
+       *
+       * @param layers The background layers of the map.
+       * @param bounds The bounds (in tiles) of the map.
+       */
+      BackgroundCache(const std::vector<Layer*>& layers, const shapes::Rectangle& bounds);
+
+      /**
+       * Draw the chunks that cover the visible area.
+       *
+       * @param visibleArea The tiles that are visible on screen.
+       */
+      void draw(const shapes::Rectangle& visibleArea);
+
+      /**
+       * Free the chunks that cover some of the map's tiles, so that they are drawn
+       * from the layers again the next time they come into view.
+       *
+       * @param tiles The tiles that changed.
+       */
+      void invalidate(const shapes::Rectangle& tiles);
+
+      /**
+       * Destructor.
+       */
+      ~BackgroundCache();
+};
+
+#endif
@@ -0,0 +1,77 @@
+/*
+ *  This file is covered by the Ruby license. See LICENSE.txt for more details.
+ *
+ *  Copyright (C) 2007-2012 Noam Chitayat. All rights reserved.
+ */
+
+#include "Camera.h"
+#include "Point2D.h"
+#include "Rectangle.h"
+
+#include <algorithm>
+
+Camera::Camera(const shapes::Size& viewSize) : viewSize(viewSize), xOffset(0), yOffset(0)
+{
+}
+
+int Camera::calculateOffset(int focus, int viewLength, int mapLength)
+{
+   if(mapLength < viewLength)
+   {
+      // Center maps that don't fill the screen
+      return (viewLength - mapLength) >> 1;
+   }
+
+   // Keep the focus in the middle, but don't scroll past the edges of the map
+   const int offset = (viewLength >> 1) - focus;
+   return std::max(viewLength - mapLength, std::min(offset, 0));
+}
+
+void Camera::setMapSize(const shapes::Size& mapPixelSize)
+{
+   mapSize = mapPixelSize;
+   focusOn(shapes::Point2D(mapSize.width >> 1, mapSize.height >> 1));
+}
+
+void Camera::focusOn(const shapes::Point2D& focus)
+{
+   xOffset = calculateOffset(focus.x, viewSize.width, mapSize.width);
+   yOffset = calculateOffset(focus.y, viewSize.height, mapSize.height);
+}
+
+int Camera::getXOffset() const
+{
+   return xOffset;
+}
+
+int Camera::getYOffset() const
+{
+   return yOffset;
+}
+
+shapes::Rectangle Camera::getViewBounds() const
+{
+   return shapes::Rectangle(shapes::Point2D(-xOffset, -yOffset), viewSize);
+}
+
+shapes::Rectangle Camera::getVisibleTiles(int tileSize) const
+{
+   const shapes::Rectangle viewBounds = getViewBounds();
+   const int mapWidth = mapSize.width / tileSize;
+   const int mapHeight = mapSize.height / tileSize;
+
+   // Round outwards so that partly visible tiles are included
+   const shapes::Point2D topLeft(std::max(0, viewBounds.left / tileSize),
+                                 std::max(0, viewBounds.top / tileSize));
+   const shapes::Point2D bottomRight(std::min(mapWidth, (viewBounds.right + tileSize - 1) / tileSize),
+                                     std::min(mapHeight, (viewBounds.bottom + tileSize - 1) / tileSize));
+
+   return shapes::Rectangle(topLeft, bottomRight);
+}
+
+bool Camera::isVisible(const shapes::Rectangle& area) const
+{
+   const shapes::Rectangle viewBounds = getViewBounds();
+   return area.left < viewBounds.right && area.right > viewBounds.left
+         && area.top < viewBounds.bottom && area.bottom > viewBounds.top;
+}
@@ -0,0 +1,103 @@
+/*
+ *  This file is covered by the Ruby license. See LICENSE.txt for more details.
+ *
+ *  Copyright (C) 2007-2012 Noam Chitayat. All rights reserved.
+ */
+
+#ifndef CAMERA_H
+#define CAMERA_H
+
+#include "Size.h"
+
+namespace shapes
+{
+   struct Point2D;
+   struct Rectangle;
+};
+
+/**
+ * The camera determines which part of the map is shown on screen.
+ * Maps that are smaller than the screen (along either axis) are centered on
+ * the screen, while larger maps scroll to keep the focus point (usually the
+ * player character) in the middle of the screen, without ever showing past
+ * the edges of the map.
+ *
+ * @author Noam Chitayat
+ */
+class Camera
+{
+   /** The size (in pixels) of the area the map is drawn to. */
+   const shapes::Size viewSize;
+
+   /** The size (in pixels) of the current map. */
+   shapes::Size mapSize;
+
+   /** The x-offset to draw elements of the map at. */
+   int xOffset;
+
+   /** The y-offset to draw elements of the map at. */
+   int yOffset;
+
+   /**
+    * @param focus The coordinate (in pixels) to center the view on.
+    * @param viewLength The length of the view along an axis.
+    * @param mapLength The length of the map along the same axis.
+    *
+    * @return The draw offset along the axis.
+    */
+   static int calculateOffset(int focus, int viewLength, int mapLength);
+
+   public:
+      /**
+       * Constructor.
+       *
+       * @param viewSize The size (in pixels) of the area the map is drawn to.
+       */
+      Camera(const shapes::Size& viewSize);
+
+      /**
+       * Set the size of the map being viewed, and center the view on it.
+       *
+       * @param mapPixelSize The size (in pixels) of the map.
+       */
+      void setMapSize(const shapes::Size& mapPixelSize);
+
+      /**
+       * Move the camera to center on a point, as far as the map bounds allow.
+       *
+       * @param focus The point (in pixels) to center the view on.
+       */
+      void focusOn(const shapes::Point2D& focus);
+
+      /**
+       * @return The x-offset to draw elements of the map at.
+       */
+      int getXOffset() const;
+
+      /**
+       * @return The y-offset to draw elements of the map at.
+       */
+      int getYOffset() const;
+
+      /**
+       * @return The area of the map (in pixels) that is visible on screen.
+       */
+      shapes::Rectangle getViewBounds() const;
+
+      /**
+       * @param tileSize The size (in pixels) of a map tile.
+       *
+       * @return The tiles of the map that are at least partly visible on screen,
+       *         clipped to the map bounds.
+       */
+      shapes::Rectangle getVisibleTiles(int tileSize) const;
+
+      /**
+       * @param area An area of the map (in pixels).
+       *
+       * @return true iff any part of the area is visible on screen.
+       */
+      bool isVisible(const shapes::Rectangle& area) const;
+};
+
+#endif
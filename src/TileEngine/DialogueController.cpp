@@ -46,10 +46,12 @@ void DialogueController::initMainDialogue()
 void DialogueController::addLine(LineType type, const char* speech, Task* task)
 {
    Line* nextLine = new Line(type, speech, task);
+   mainDialogue->layOutText(nextLine->dialogue, nextLine->layout);
+
    if(currLine == NULL)
    {
       currLine = nextLine;
-      setDialogue(type);
+      setDialogue(nextLine);
    }
    else
    {
@@ -67,9 +69,11 @@ void DialogueController::say(const char* speech, Task* task)
    addLine(SAY, speech, task);
 }
 
-void DialogueController::setDialogue(LineType type)
+void DialogueController::setDialogue(Line* line)
 {
-   switch(type)
+   mainDialogue->setLayout(line->layout);
+
+   switch(line->type)
    {
       case NARRATE:
       {
@@ -107,31 +111,28 @@ void DialogueController::setFastModeEnabled(bool enabled)
 void DialogueController::advanceDialogue()
 {
    // See if we ran over any embedded scripts that we should execute
-   unsigned int openIndex, closeIndex;
-   if(currLine->getNextBracketPair(openIndex, closeIndex))
+   unsigned int scriptPosition;
+   if(currLine->getNextScriptPosition(scriptPosition))
    {
-      // If there is a bracket pair coming up and we're past the point of the
-      // open bracket, then extract the script string and run it
-      if(openIndex <= charsToShow)
+      // If there is a script coming up and we're past the point where
+      // it was embedded, then run it
+      if(scriptPosition <= charsToShow)
       {
-         charsToShow = openIndex;
-         std::string script = currLine->removeNextScriptString();
+         charsToShow = scriptPosition;
+         std::string script = currLine->removeNextScript();
          scriptEngine.runScriptString(script);
       }
    }
 
-   std::string dialogue = currLine->dialogue;
-
    // If we have run to the end of the dialogue, we show all the text
    // and signal that the associated task is done.
-   if(dialogue.size() <= charsToShow)
+   if(currLine->dialogue.size() <= charsToShow)
    {
-      charsToShow = dialogue.size();
+      charsToShow = currLine->dialogue.size();
    }
 
    // Display the necessary piece of text in the text box
-   dialogue = dialogue.substr(0, charsToShow);
-   mainDialogue->setText(dialogue);
+   mainDialogue->setRevealedLength(charsToShow);
 }
 
 bool DialogueController::dialogueComplete()
@@ -188,6 +189,7 @@ bool DialogueController::nextLine()
    {
       currLine = lineQueue.front();
       lineQueue.pop();
+      setDialogue(currLine);
    }
 
    return true;
@@ -213,6 +215,9 @@ bool DialogueController::resume(long timePassed)
 DialogueController::Line::Line(LineType type, const std::string& dialogue, Task* task)
                     : type(type), dialogue(dialogue), task(task)
 {
+   std::queue<int> openScriptBrackets;
+   std::queue<int> closeScriptBrackets;
+
    int openIndex = 0;
    int closeIndex = 0;
 
@@ -255,33 +260,44 @@ DialogueController::Line::Line(LineType type, const std::string& dialogue, Task*
          DEBUG("Found embedded script starting at %d, ending at %d", openIndex, closeIndex); 
       }
    }
+
+   // Remove the scripts from the dialogue now, so that the line can be laid out once.
+   // Each script runs once the dialogue before it has been shown.
+   int removedLength = 0;
+   while(!openScriptBrackets.empty())
+   {
+      openIndex = openScriptBrackets.front() - removedLength;
+      closeIndex = closeScriptBrackets.front() - removedLength;
+      openScriptBrackets.pop();
+      closeScriptBrackets.pop();
+
+      const int scriptLength = closeIndex - openIndex;
+      scriptPositions.push(openIndex);
+      scripts.push(this->dialogue.substr(openIndex + 1, scriptLength - 1));
+      this->dialogue.replace(openIndex, scriptLength + 1, "");
+      removedLength += scriptLength + 1;
+
+      DEBUG("Extracting script %s, leaving dialogue %s", scripts.back().c_str(), this->dialogue.c_str());
+   }
 }
 
-bool DialogueController::Line::getNextBracketPair(unsigned int& openIndex, unsigned int& closeIndex)
+bool DialogueController::Line::getNextScriptPosition(unsigned int& position)
 {
-   if(openScriptBrackets.empty())
+   if(scriptPositions.empty())
    {
       return false;
    }
 
-   openIndex = openScriptBrackets.front();
-   closeIndex = closeScriptBrackets.front();
-
+   position = scriptPositions.front();
    return true;
 }
 
-std::string DialogueController::Line::removeNextScriptString()
+std::string DialogueController::Line::removeNextScript()
 {
-   unsigned int openIndex, closeIndex;
-   getNextBracketPair(openIndex, closeIndex);
-
-   openScriptBrackets.pop();
-   closeScriptBrackets.pop();
+   std::string script = scripts.front();
 
-   const int scriptLength = closeIndex - openIndex;
-   std::string script = dialogue.substr(openIndex + 1, scriptLength - 1);
-   dialogue.replace(openIndex, scriptLength + 1, "");
+   scriptPositions.pop();
+   scripts.pop();
 
-   DEBUG("Extracting script %s, leaving dialogue %s", script.c_str(), dialogue.c_str());
    return script;
 }
@@ -12,6 +12,7 @@
 
 #include "Thread.h"
 #include "Task.h"
+#include "TextLayout.h"
 
 namespace edwt
 {
@@ -84,41 +85,50 @@ class DialogueController
     */
    class Line
    {
-      /** A queue of upcoming open script brackets ('<' characters) */
-      std::queue<int> openScriptBrackets;
+      /**
+       * A queue of the positions of upcoming embedded scripts
+       * (the number of characters of dialogue before each script)
+       */
+      std::queue<unsigned int> scriptPositions;
 
-      /** A queue of upcoming close script brackets ('>' characters) */
-      std::queue<int> closeScriptBrackets;
+      /** A queue of upcoming embedded scripts, parallel to the script positions */
+      std::queue<std::string> scripts;
 
       public:
          /** The type of line (how it should be displayed) */
          LineType type;
    
-         /** The dialogue itself. */
+         /** The dialogue itself, without its embedded scripts. */
          std::string dialogue;
+
+         /** The dialogue broken into rows for the dialogue box. */
+         edwt::TextLayout layout;
    
          /** The task ID waiting on this particular line of dialogue */
          Task* task;
    
          /**
-          *  Constructor. Initializes values and indexes the locations of
-          *  embedded scripts in the line of dialogue for later use.
+          *  Constructor. Initializes values and removes the embedded
+          *  scripts from the line of dialogue, indexing their locations
+          *  for later use.
           */
          Line(LineType type, const std::string& dialogue, Task* task);
 
          /**
-          *  Gets the next embdedded script bracket pair.
+          *  Gets the position of the next embedded script.
+          *
+          *  @param position The number of characters of dialogue before the script.
           *
-          *  @return true iff there are embedded script brackets left in the string
+          *  @return true iff there are embedded scripts left in the line
           */
-         bool getNextBracketPair(unsigned int& openIndex, unsigned int& closeIndex);
+         bool getNextScriptPosition(unsigned int& position);
 
          /**
-          *  Gets the next embedded script and removes it from the dialogue line.
+          *  Gets the next embedded script and removes it from the queue of upcoming scripts.
           *
-          *  @return the script string removed from the dialogue line
+          *  @return the next embedded script
           */
-         std::string removeNextScriptString();
+         std::string removeNextScript();
    };
 
    /** The queue to hold all the pending dialogue sequences. */
@@ -164,19 +174,20 @@ class DialogueController
 
    /**
     * Refresh the dialogue box to show enough letters on the screen for the amount of time passed.
+    * The line was laid out when it was enqueued, so this only changes how many letters are shown.
     */
    void advanceDialogue();
 
    /**
-    * Set the current line to be a narration or speech;
-    * alter the dialogue box accordingly.
+    * Show a line of dialogue in the dialogue box (with none of its letters revealed yet);
+    * alter the dialogue box according to whether the line is a narration or speech.
     *
-    * @param type The type of line that will be shown.
+    * @param line The line that will be shown.
     */
-   void setDialogue(LineType type);
+   void setDialogue(Line* line);
 
    /**
-    * Enqueue a line of speech in the dialogue box.
+    * Lay out a line of speech for the dialogue box and enqueue it.
     * If there is already a line being spoken, append the new speech.
     *
     * @param type The type of line that will be enqueued.
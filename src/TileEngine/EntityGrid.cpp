@@ -19,6 +19,7 @@
 #include "MapExitMessage.h"
 #include "MapTriggerMessage.h"
 #include "SDL_opengl.h"
+#include "GraphicsUtil.h"
 
 #include "DebugUtils.h"
 const int debugFlag = DEBUG_ENTITY_GRID;
@@ -107,9 +108,15 @@ bool EntityGrid::withinMap(const shapes::Point2D& point) const
    return pixelBounds.contains(point);
 }
 
+MovementSystem& EntityGrid::getMovementSystem()
+{
+   return movementSystem;
+}
+
 void EntityGrid::step(long timePassed)
 {
    if(map) map->step(timePassed);
+   movementSystem.step(timePassed);
 }
 
 EntityGrid::Path EntityGrid::findBestPath(const shapes::Point2D& src, const shapes::Point2D& dst)
@@ -398,64 +405,74 @@ void EntityGrid::setArea(const shapes::Rectangle& area, TileState state)
    }
 }
 
-void EntityGrid::drawBackground(int y) const
+void EntityGrid::drawBackground(const shapes::Rectangle& visibleArea) const
 {
    if(map == NULL) return;
 
 #ifdef DRAW_ENTITY_GRID
-   for(unsigned int x = 0; x < collisionMapBounds.getWidth(); ++x)
+   GraphicsUtil* graphics = GraphicsUtil::getInstance();
+   const int collisionTileRatio = TileEngine::TILE_SIZE / MOVEMENT_TILE_SIZE;
+   for(int y = visibleArea.top * collisionTileRatio; y < visibleArea.bottom * collisionTileRatio; ++y)
    {
-      float destLeft = float(x * MOVEMENT_TILE_SIZE);
-      float destRight = float((x + 1) * MOVEMENT_TILE_SIZE);
-      float destTop = float(y * MOVEMENT_TILE_SIZE);
-      float destBottom = float((y + 1) * MOVEMENT_TILE_SIZE);
+      for(int x = visibleArea.left * collisionTileRatio; x < visibleArea.right * collisionTileRatio; ++x)
+      {
+         float destLeft = float(x * MOVEMENT_TILE_SIZE);
+         float destRight = float((x + 1) * MOVEMENT_TILE_SIZE);
+         float destTop = float(y * MOVEMENT_TILE_SIZE);
+         float destBottom = float((y + 1) * MOVEMENT_TILE_SIZE);
 
-      glDisable(GL_TEXTURE_2D);
-      glBegin(GL_QUADS);
+         glDisable(GL_TEXTURE_2D);
 
-      switch(collisionMap[y][x].entityType)
-      {
-         case TileState::FREE:
-         {
-            glColor3f(0.0f, 0.5f, 0.0f);
-            break;
-         }
-         case TileState::ACTOR:
+         switch(collisionMap[y][x].entityType)
          {
-            if(collisionMap[y][x].entity == NULL)
+            case TileState::FREE:
             {
-               glColor3f(0.5f, 0.0f, 0.0f);
+               graphics->setColor(0.0f, 0.5f, 0.0f);
+               break;
             }
-            else
+            case TileState::ACTOR:
             {
-               glColor3f(0.0f, 0.0f, 0.5f);
+               if(collisionMap[y][x].entity == NULL)
+               {
+                  graphics->setColor(0.5f, 0.0f, 0.0f);
+               }
+               else
+               {
+                  graphics->setColor(0.0f, 0.0f, 0.5f);
+               }
+               break;
+            }
+            case TileState::OBSTACLE:
+            default:
+            {
+               graphics->setColor(0.5f, 0.5f, 0.0f);
+               break;
             }
-            break;
-         }
-         case TileState::OBSTACLE:
-         default:
-         {
-            glColor3f(0.5f, 0.5f, 0.0f);
-            break;
          }
-      }
 
-      glVertex3f(destLeft, destTop, 0.0f);
-      glVertex3f(destRight, destTop, 0.0f);
-      glVertex3f(destRight, destBottom, 0.0f);
-      glVertex3f(destLeft, destBottom, 0.0f);
-      glColor3f(1.0f, 1.0f, 1.0f);
-      glEnd();
-      glEnable(GL_TEXTURE_2D);
+         glBegin(GL_QUADS);
+         glVertex3f(destLeft, destTop, 0.0f);
+         glVertex3f(destRight, destTop, 0.0f);
+         glVertex3f(destRight, destBottom, 0.0f);
+         glVertex3f(destLeft, destBottom, 0.0f);
+         glEnd();
+         graphics->setColor(1.0f, 1.0f, 1.0f);
+         glEnable(GL_TEXTURE_2D);
+      }
    }
 #else
-   map->drawBackground(y);
+   map->drawBackground(visibleArea);
 #endif
 }
 
-void EntityGrid::drawForeground(int y) const
+void EntityGrid::drawForeground(const shapes::Rectangle& visibleArea) const
+{
+   map->drawForeground(visibleArea);
+}
+
+void EntityGrid::drawForeground(int y, const shapes::Rectangle& visibleArea) const
 {
-   map->drawForeground(y);
+   map->drawForeground(y, visibleArea);
 }
 
 void EntityGrid::receive(const ActorMoveMessage& message)
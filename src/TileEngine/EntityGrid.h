@@ -13,6 +13,7 @@
 #include <vector>
 #include "MovementDirection.h"
 #include "Pathfinder.h"
+#include "MovementSystem.h"
 #include "Rectangle.h"
 #include "Listener.h"
 
@@ -68,6 +69,9 @@ class EntityGrid : messaging::Listener<ActorMoveMessage>
 
    /** The pathfinding component used to navigate in this map. */
    Pathfinder pathfinder;
+
+   /** The component that moves walking actors between waypoints. */
+   MovementSystem movementSystem;
    
    /** The map of entities and states for each of the tiles. */
    TileState** collisionMap;
@@ -181,7 +185,12 @@ class EntityGrid : messaging::Listener<ActorMoveMessage>
       bool withinMap(const shapes::Point2D& point) const;
 
       /**
-       * Process logic for the map and its obstacles.
+       * @return The component that moves walking actors between waypoints.
+       */
+      MovementSystem& getMovementSystem();
+
+      /**
+       * Process logic for the map and its obstacles, and move the walking actors.
        */
       void step(long timePassed);
    
@@ -306,18 +315,26 @@ class EntityGrid : messaging::Listener<ActorMoveMessage>
       void endMovement(Actor* actor, const shapes::Point2D& src, const shapes::Point2D& dst);
    
       /**
-       * Draw a row of the background layers of the map.
+       * Draw the visible part of the background layers of the map.
        *
-       * @param y The row to draw.
+       * @param visibleArea The tiles that are visible on screen.
+       */
+      void drawBackground(const shapes::Rectangle& visibleArea) const;
+
+      /**
+       * Draw the visible part of the foreground layers of the map.
+       *
+       * @param visibleArea The tiles that are visible on screen.
        */
-      void drawBackground(int y) const;
+      void drawForeground(const shapes::Rectangle& visibleArea) const;
 
       /**
        * Draw a row of the foreground layers of the map.
        *
        * @param y The row to draw.
+       * @param visibleArea The tiles that are visible on screen.
        */
-      void drawForeground(int y) const;
+      void drawForeground(int y, const shapes::Rectangle& visibleArea) const;
 
       /**
        * Receive location change messages.
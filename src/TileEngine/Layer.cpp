@@ -8,13 +8,19 @@
 #include "Rectangle.h"
 #include "ResourceLoader.h"
 #include "Tileset.h"
+#include "TileEngine.h"
 #include "tinyxml.h"
+#include "Tracer.h"
+#include <algorithm>
 
 #include "DebugUtils.h"
 
 const int debugFlag = DEBUG_TILE_ENG;
 
-Layer::Layer(const TiXmlElement* layerData, const shapes::Rectangle& bounds) : bounds(bounds), heightOffset(0)
+// Draw tiles one at a time in immediate mode instead of using the prebuilt vertex arrays
+//#define DRAW_TILES_IMMEDIATE
+
+Layer::Layer(const TiXmlElement* layerData, const shapes::Rectangle& bounds, int depthSlot) : tileset(NULL), bounds(bounds), heightOffset(0), depthSlot(depthSlot)
 {
    const TiXmlElement* propertiesElement = layerData->FirstChildElement("properties");
 
@@ -42,6 +48,7 @@ Layer::Layer(const TiXmlElement* layerData, const shapes::Rectangle& bounds) : b
    }
 
    DEBUG("Loading layer data.");
+   TRACE_ZONE("Layer parse");
    const TiXmlText* layerDataElement = layerData->FirstChildElement("data")->FirstChild()->ToText();
    std::stringstream layerStream(layerDataElement->Value());
 
@@ -70,19 +77,90 @@ Layer::Layer(const TiXmlElement* layerData, const shapes::Rectangle& bounds) : b
          tileMap[y + heightOffset][x] = atoi(entry.c_str()) - 1;
       }
    }
+
+   buildVertexArrays();
 }
 
-void Layer::draw(int row, bool isForeground) const
+void Layer::buildVertexArrays()
 {
    const unsigned int width = bounds.getWidth();
-   for(unsigned int column = 0; column < width; ++column)
+   const unsigned int height = bounds.getHeight();
+
+   unsigned int numTiles = 0;
+
+   rowStarts.reserve(height + 1);
+   for(unsigned int row = 0; row < height; ++row)
+   {
+      rowStarts.push_back(numTiles);
+
+      // Depth comes from the row the tiles belong to, not the row they are drawn at
+      const float depth = TileEngine::getDrawDepth(row, depthSlot);
+      for(unsigned int column = 0; column < width; ++column)
+      {
+         const int tileNum = tileMap[row][column];
+         if(tileNum != -1)
+         {
+            tileset->addTile(column, row - heightOffset, tileNum, depth, vertices, texCoords);
+            tileColumns.push_back(column);
+            ++numTiles;
+         }
+      }
+   }
+
+   rowStarts.push_back(numTiles);
+   DEBUG("Built vertex arrays for %d tiles.", numTiles);
+}
+
+void Layer::draw(const shapes::Rectangle& visibleArea, bool isForeground) const
+{
+   drawRows(0, bounds.getHeight(), visibleArea, isForeground);
+}
+
+void Layer::draw(int row, const shapes::Rectangle& visibleArea, bool isForeground) const
+{
+   drawRows(row, row + 1, visibleArea, isForeground);
+}
+
+void Layer::drawRows(int firstRow, int lastRow, const shapes::Rectangle& visibleArea, bool isForeground) const
+{
+   // Tiles in each row are drawn heightOffset rows further up
+   firstRow = std::max(firstRow, std::max(0, visibleArea.top + heightOffset));
+   lastRow = std::min(lastRow, std::min(static_cast<int>(bounds.getHeight()), visibleArea.bottom + heightOffset));
+   const int firstColumn = std::max(0, visibleArea.left);
+   const int lastColumn = std::min(static_cast<int>(bounds.getWidth()), visibleArea.right);
+   if(firstRow >= lastRow || firstColumn >= lastColumn) return;
+
+#ifdef DRAW_TILES_IMMEDIATE
+   for(int row = firstRow; row < lastRow; ++row)
    {
-      const int tileNum = tileMap[row][column];
-      if(tileNum != -1)
+      const float depth = TileEngine::getDrawDepth(row, depthSlot);
+      for(int column = firstColumn; column < lastColumn; ++column)
       {
-         tileset->draw(column, row - heightOffset, tileNum, isForeground);
+         const int tileNum = tileMap[row][column];
+         if(tileNum != -1)
+         {
+            tileset->draw(column, row - heightOffset, tileNum, depth, isForeground);
+         }
       }
    }
+#else
+   if(vertices.empty()) return;
+
+   // Each visible row is drawn as one range of tiles, from its first to its last visible column,
+   // so that the number of tiles drawn depends on the size of the screen and not of the map
+   tileset->beginTiles(vertices, texCoords, isForeground);
+
+   const std::vector<int>::const_iterator columnsBegin = tileColumns.begin();
+   for(int row = firstRow; row < lastRow; ++row)
+   {
+      const std::vector<int>::const_iterator rowEnd = columnsBegin + rowStarts[row + 1];
+      const std::vector<int>::const_iterator firstTile = std::lower_bound(columnsBegin + rowStarts[row], rowEnd, firstColumn);
+      const std::vector<int>::const_iterator endTile = std::lower_bound(firstTile, rowEnd, lastColumn);
+      tileset->drawTileRange(firstTile - columnsBegin, endTile - firstTile);
+   }
+
+   tileset->endTiles();
+#endif
 }
 
 Layer::~Layer()
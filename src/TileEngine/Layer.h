@@ -8,6 +8,7 @@
 #define LAYER_H
 
 #include <string>
+#include <vector>
 
 namespace shapes
 {
@@ -34,9 +35,64 @@ class Layer
    /** The height offset (in tiles) of this layer. */
    int heightOffset;
 
+   /** The depth slot of this layer within each row (see TileEngine::getDrawDepth). */
+   int depthSlot;
+
+   /** The vertex coordinates (x, y, depth) of the layer's tiles (4 vertices per tile), in row-major order. */
+   std::vector<float> vertices;
+
+   /** The texture coordinates of the layer's tiles, parallel to the vertex coordinates. */
+   std::vector<float> texCoords;
+
+   /** The column of each tile in the vertex arrays (ascending within each row). */
+   std::vector<int> tileColumns;
+
+   /** The index of the first tile of each row in the vertex arrays, followed by the total number of tiles. */
+   std::vector<unsigned int> rowStarts;
+
+   /**
+    * Build the vertex arrays for the layer's tiles.
+    * Since the layer's tiles never change, this only needs to be done once.
+    */
+   void buildVertexArrays();
+
+   /**
+    * Draw the visible part of a range of rows of the layer.
+    *
+    * @param firstRow The first row to draw.
+    * @param lastRow The row after the last row to draw.
+    * @param visibleArea The tiles that are visible on screen.
+    * @param isForeground true iff the layer is drawn on top of other layers.
+    */
+   void drawRows(int firstRow, int lastRow, const shapes::Rectangle& visibleArea, bool isForeground) const;
+
    public:
-      Layer(const TiXmlElement* layerData, const shapes::Rectangle& bounds);
-      void draw(int row, bool isForeground = false) const;
+      /**
+       * Constructor.
+       *
+       * @param layerData The layer element of the map file.
+       * @param bounds The bounds (in tiles) of the map containing this layer.
+       * @param depthSlot The depth slot of the layer's tiles within each row.
+       */
+      Layer(const TiXmlElement* layerData, const shapes::Rectangle& bounds, int depthSlot = 0);
+
+      /**
+       * Draw all the visible rows of the layer.
+       *
+       * @param visibleArea The tiles that are visible on screen.
+       * @param isForeground true iff the layer is drawn on top of other layers.
+       */
+      void draw(const shapes::Rectangle& visibleArea, bool isForeground = false) const;
+
+      /**
+       * Draw the visible part of a row of the layer.
+       *
+       * @param row The row to draw.
+       * @param visibleArea The tiles that are visible on screen. Tiles outside of this area are skipped.
+       * @param isForeground true iff the layer is drawn on top of other layers.
+       */
+      void draw(int row, const shapes::Rectangle& visibleArea, bool isForeground = false) const;
+
       ~Layer();
 };
 
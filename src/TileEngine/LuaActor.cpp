@@ -6,6 +6,9 @@
 
 #include "LuaActor.h"
 #include "Actor.h"
+#include "NPC.h"
+#include "NPCList.h"
+#include "TileEngine.h"
 #include "Point2D.h"
 
 #include "LuaWrapper.hpp"
@@ -19,6 +22,46 @@ extern "C"
 #include <lauxlib.h>
 }
 
+#include "DebugUtils.h"
+
+const int debugFlag = DEBUG_SCRIPT_ENG;
+
+/**
+ * The Lua-side representation of an NPC. Owned by Lua and deleted when
+ * garbage collected.
+ */
+struct NPCReference
+{
+   /** The tile engine that owns the NPC. */
+   const TileEngine* tileEngine;
+
+   /** The handle of the NPC within the tile engine. */
+   NPCHandle handle;
+};
+
+/**
+ * Resolve an Actor argument, which can be either an Actor proper (e.g. the
+ * player character) or a reference to an NPC.
+ *
+ * @return The actor at the given index, or NULL if it refers to an NPC that no longer exists.
+ */
+static Actor* ActorL_Check(lua_State* luaVM, int index)
+{
+   if(luaW_is<NPCReference>(luaVM, index))
+   {
+      const NPCReference* reference = luaW_to<NPCReference>(luaVM, index);
+      Actor* npc = reference->tileEngine->getNPC(reference->handle);
+      if(npc == NULL)
+      {
+         DEBUG("Script referenced an NPC that is no longer on the map.");
+      }
+
+      return npc;
+   }
+
+   return luaW_check<Actor>(luaVM, index);
+}
+
 static int ActorL_Move(lua_State* luaVM)
 {
    int nargs = lua_gettop(luaVM);
@@ -27,7 +70,7 @@ static int ActorL_Move(lua_State* luaVM)
    {
       case 3:
       {
-         Actor* actor = luaW_check<Actor>(luaVM, 1);
+         Actor* actor = ActorL_Check(luaVM, 1);
          if (actor)
          {
             const shapes::Point2D destination(lua_tointeger(luaVM, 2), lua_tointeger(luaVM, 3));
@@ -47,7 +90,7 @@ static int ActorL_SetSprite(lua_State* luaVM)
    {
       case 2:
       {
-         Actor* actor = luaW_check<Actor>(luaVM, 1);
+         Actor* actor = ActorL_Check(luaVM, 1);
          if (actor)
          {
             std::string frameName(lua_tostring(luaVM, 2));
@@ -68,7 +111,7 @@ static int ActorL_SetAnimation(lua_State* luaVM)
    {
       case 2:
       {
-         Actor* actor = luaW_check<Actor>(luaVM, 1);
+         Actor* actor = ActorL_Check(luaVM, 1);
          if (actor)
          {
             std::string animationName(lua_tostring(luaVM, 2));
@@ -89,7 +132,7 @@ static int ActorL_SetSpritesheet(lua_State* luaVM)
    {
       case 2:
       {
-         Actor* actor = luaW_check<Actor>(luaVM, 1);
+         Actor* actor = ActorL_Check(luaVM, 1);
          if (actor)
          {
             std::string spritesheetName(lua_tostring(luaVM, 2));
@@ -110,10 +153,13 @@ static int ActorL_LookAt(lua_State* luaVM)
    {
       case 2:
       {
-         Actor* actor = luaW_check<Actor>(luaVM, 1);
-         Actor* other = luaW_check<Actor>(luaVM, 2);
+         Actor* actor = ActorL_Check(luaVM, 1);
+         Actor* other = ActorL_Check(luaVM, 2);
          
-         actor->faceActor(other);
+         if (actor && other)
+         {
+            actor->faceActor(other);
+         }
          break;
       }
    }
@@ -134,4 +180,22 @@ static luaL_reg actorMetatable[] =
 void luaopen_Actor(lua_State* luaVM)
 {
    luaW_register<Actor>(luaVM, "Actor", NULL, actorMetatable, NULL, NULL);
+   luaW_register<NPCReference>(luaVM, "NPC", NULL, actorMetatable, NULL);
+}
+
+void luapush_NPC(lua_State* luaVM, const TileEngine& tileEngine, const NPCHandle& handle)
+{
+   if(!handle.isValid())
+   {
+      lua_pushnil(luaVM);
+      return;
+   }
+
+   NPCReference* reference = new NPCReference;
+   reference->tileEngine = &tileEngine;
+   reference->handle = handle;
+
+   // Let Lua delete the reference once scripts no longer hold on to it
+   luaW_push<NPCReference>(luaVM, reference);
+   luaW_hold<NPCReference>(luaVM, reference);
 }
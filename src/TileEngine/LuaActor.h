@@ -8,7 +8,21 @@
 #define LUA_ACTOR_H
 
 struct lua_State;
+struct NPCHandle;
+class TileEngine;
 
 void luaopen_Actor(lua_State* luaVM);
 
+/**
+ * Push a reference to an NPC onto the Lua stack.
+ * The reference stores the NPC's handle rather than its address, so that
+ * scripts holding on to it after the NPC is removed get a no-op instead of
+ * touching freed memory.
+ *
+ * @param luaVM The Lua stack to push the reference onto.
+ * @param tileEngine The tile engine that owns the NPC.
+ * @param handle The handle of the NPC (pushes nil if the handle is invalid).
+ */
+void luapush_NPC(lua_State* luaVM, const TileEngine& tileEngine, const NPCHandle& handle);
+
 #endif
\ No newline at end of file
@@ -5,8 +5,9 @@
  */
 
 #include "LuaTileEngine.h"
+#include "LuaActor.h"
 #include "TileEngine.h"
-#include "NPC.h"
+#include "NPCList.h"
 #include "Size.h"
 #include "Point2D.h"
 #include "LuaWrapper.hpp"
@@ -26,7 +27,8 @@ const int debugFlag = DEBUG_SCRIPT_ENG;
 
 static int TileEngineL_AddNPC(lua_State* luaVM)
 {
-   NPC* npc = NULL;
+   TileEngine* tileEngine = NULL;
+   NPCHandle npc;
    
    shapes::Size npcSize(32, 32);
    int nargs = lua_gettop(luaVM);
@@ -40,7 +42,7 @@ static int TileEngineL_AddNPC(lua_State* luaVM)
       }
       case 5:
       {
-         TileEngine* tileEngine = luaW_check<TileEngine>(luaVM, 1);
+         tileEngine = luaW_check<TileEngine>(luaVM, 1);
          if (tileEngine)
          {
             std::string npcName(lua_tostring(luaVM, 2));
@@ -54,29 +56,46 @@ static int TileEngineL_AddNPC(lua_State* luaVM)
       }
    }
    
-   luaW_push<Actor>(luaVM, npc);
+   if (tileEngine)
+   {
+      luapush_NPC(luaVM, *tileEngine, npc);
+   }
+   else
+   {
+      lua_pushnil(luaVM);
+   }
+
    return 1;
 }
 
 static int TileEngineL_GetNPC(lua_State* luaVM)
 {
-   NPC* npc = NULL;
+   TileEngine* tileEngine = NULL;
+   NPCHandle npc;
    int nargs = lua_gettop(luaVM);
    
    switch(nargs)
    {
-      case 5:
+      case 2:
       {
-         TileEngine* tileEngine = luaW_check<TileEngine>(luaVM, 1);
+         tileEngine = luaW_check<TileEngine>(luaVM, 1);
          if (tileEngine)
          {
             std::string npcName(lua_tostring(luaVM, 2));
-            npc = tileEngine->getNPC(npcName);
+            npc = tileEngine->findNPC(npcName);
          }
       }
    }
 
-   luaW_push<NPC>(luaVM, npc);
+   if (tileEngine)
+   {
+      luapush_NPC(luaVM, *tileEngine, npc);
+   }
+   else
+   {
+      lua_pushnil(luaVM);
+   }
+
    return 1;
 }
 
@@ -9,11 +9,14 @@
 #include "TriggerZone.h"
 #include "MapExit.h"
 #include "Layer.h"
+#include "BackgroundCache.h"
+#include "RenderTexture.h"
 #include "Pathfinder.h"
 #include "ResourceLoader.h"
 #include "TileEngine.h"
 #include "Rectangle.h"
 #include "Point2D.h"
+#include "Tracer.h"
 #include <sstream>
 
 #include "DebugUtils.h"
@@ -22,22 +25,14 @@ const int debugFlag = DEBUG_RES_LOAD | DEBUG_ENTITY_GRID;
 
 //#define DRAW_PASSIBILITY
 
-Map::Map()
+Map::Map() : backgroundCache(NULL)
 {
 }
 
-Map::Map(const std::string& name, const std::string& filePath) : mapName(name)
+Map::Map(const std::string& name, const TiXmlDocument& xmlDoc) : mapName(name), backgroundCache(NULL)
 {
-   DEBUG("Loading map file %s", filePath.c_str());
-   
-   std::ifstream input(filePath.c_str());
-   if(!input)
-   {
-      T_T("Failed to open map file for reading.");
-   }
-   
-   TiXmlDocument xmlDoc;
-   input >> xmlDoc;
+   TRACE_ZONE("Map::Map");
+   DEBUG("Loading map %s", name.c_str());
    
    if(xmlDoc.Error())
    {
@@ -70,13 +65,20 @@ Map::Map(const std::string& name, const std::string& filePath) : mapName(name)
       }
       else if(layerName == "foreground")
       {
-         foregroundLayers.push_back(new Layer(layerElement, bounds));
+         // Each foreground layer covers the ones before it, and the actors in its rows
+         const int depthSlot = TileEngine::FIRST_FOREGROUND_DEPTH_SLOT + foregroundLayers.size();
+         foregroundLayers.push_back(new Layer(layerElement, bounds, depthSlot));
          DEBUG("Foreground layer added.");
       }
       
       layerElement = layerElement->NextSiblingElement("layer");
    }
 
+   if(!backgroundLayers.empty() && RenderTexture::isSupported())
+   {
+      backgroundCache = new BackgroundCache(backgroundLayers, bounds);
+   }
+
    bool hasCollisionLayer = false;
    bool hasEntrancesLayer = false;
    bool hasExitsLayer = false;
@@ -291,47 +293,66 @@ void Map::step(long timePassed) const
 {
 }
 
-void Map::drawBackground(int row) const
+void Map::drawBackground(const shapes::Rectangle& visibleArea) const
 {
 #ifdef DRAW_PASSIBILITY
-   const unsigned int width = bounds.getWidth();
-   const unsigned int height = bounds.getHeight();
-   
-   for(unsigned int column = 0; column < width; ++column)
+   for(int row = visibleArea.top; row < visibleArea.bottom; ++row)
    {
-      if(isPassible(column, row))
-      {
-         Tileset::drawColorToTile(column, row, 0.0f, 1.0f, 0.0f);
-      }
-      else
+      for(int column = visibleArea.left; column < visibleArea.right; ++column)
       {
-         Tileset::drawColorToTile(column, row, 1.0f, 0.0f, 0.0f);
+         if(isPassible(column, row))
+         {
+            Tileset::drawColorToTile(column, row, 0.0f, 1.0f, 0.0f);
+         }
+         else
+         {
+            Tileset::drawColorToTile(column, row, 1.0f, 0.0f, 0.0f);
+         }
       }
    }
 #else
+   if(backgroundCache != NULL)
+   {
+      backgroundCache->draw(visibleArea);
+      return;
+   }
+
    bool firstLayer = true;
    std::vector<Layer*>::const_iterator iter;
    for(iter = backgroundLayers.begin(); iter != backgroundLayers.end(); ++iter)
    {
-      (*iter)->draw(row, !firstLayer);
+      (*iter)->draw(visibleArea, !firstLayer);
       firstLayer = false;
    }
 #endif
 }
 
-void Map::drawForeground(int row) const
+void Map::drawForeground(const shapes::Rectangle& visibleArea) const
+{
+#ifndef DRAW_PASSIBILITY
+   std::vector<Layer*>::const_iterator iter;
+   for(iter = foregroundLayers.begin(); iter != foregroundLayers.end(); ++iter)
+   {
+      (*iter)->draw(visibleArea, true);
+   }
+#endif
+}
+
+void Map::drawForeground(int row, const shapes::Rectangle& visibleArea) const
 {
 #ifndef DRAW_PASSIBILITY
    std::vector<Layer*>::const_iterator iter;
    for(iter = foregroundLayers.begin(); iter != foregroundLayers.end(); ++iter)
    {
-      (*iter)->draw(row, true);
+      (*iter)->draw(row, visibleArea, true);
    }
 #endif
 }
 
 Map::~Map()
 {
+   delete backgroundCache;
+
    std::vector<Layer*>::const_iterator iter;
    for(iter = backgroundLayers.begin(); iter != backgroundLayers.end(); ++iter)
    {
@@ -19,6 +19,7 @@
 class Point2D;
 class MapExit;
 class Layer;
+class BackgroundCache;
 class TriggerZone;
 
 /**
@@ -60,6 +61,9 @@ class Map
    /** The bounds (in tiles) of this map */
    shapes::Rectangle bounds;
 
+   /** Cached textures of the composed background layers (NULL if render textures are unsupported) */
+   BackgroundCache* backgroundCache;
+
    /**
     * @return true iff the tile at this location of the map is passible
     */
@@ -93,14 +97,14 @@ class Map
    public:
 
       /**
-       * Constructor. Loads map data from a Region file.
-       * At the end of construction, the input stream 'in' will be at the end of
-       * this Map's data.
+       * Constructor. Loads map data from a parsed map file.
+       * The file can be parsed on any thread, but the map itself must be
+       * constructed on the main thread, since it creates textures for its layers.
        *
        * @param name The name of the map area.
-       * @param filePath The path to the map file to load.
+       * @param xmlDoc The parsed map file.
        */
-      Map(const std::string& name, const std::string& filePath);
+      Map(const std::string& name, const TiXmlDocument& xmlDoc);
 
       /**
        * @return The name of this map.
@@ -141,18 +145,28 @@ class Map
       void step(long timePassed) const;
 
       /**
-       * Draw a row of the map's background.
+       * Draw the visible part of the map's background.
+       *
+       * @param visibleArea The tiles that are visible on screen.
+       */
+      void drawBackground(const shapes::Rectangle& visibleArea) const;
+
+      /**
+       * Draw the visible part of the map's foreground.
+       * Foreground tiles are drawn with depth values, so that they occlude
+       * the actors behind them regardless of the order they are drawn in.
        *
-       * @param row The row of the background to draw.
+       * @param visibleArea The tiles that are visible on screen.
        */
-      void drawBackground(int row) const;
+      void drawForeground(const shapes::Rectangle& visibleArea) const;
 
       /**
        * Draw a row of the map's foreground.
        *
        * @param row The row of the foreground to draw.
+       * @param visibleArea The tiles that are visible on screen.
        */
-      void drawForeground(int row) const;
+      void drawForeground(int row, const shapes::Rectangle& visibleArea) const;
 
       /**
        * Destructor.
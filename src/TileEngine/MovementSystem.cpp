@@ -0,0 +1,160 @@
+/*
+ *  This file is covered by the Ruby license. See LICENSE.txt for more details.
+ *
+ *  Copyright (C) 2007-2012 Noam Chitayat. All rights reserved.
+ */
+
+#include "MovementSystem.h"
+#include "Actor.h"
+#include "Point2D.h"
+
+#include <algorithm>
+#include <stdlib.h>
+
+/**
+ * Advance a batch of walkers towards their waypoints.
+ * This loop is kept free of calls and branches, and its arrays are declared
+ * as non-aliasing, so that the compiler can vectorize it.
+ * Walkers that already arrived have no distance left to their waypoint,
+ * so they stay put and just keep accumulating distance for their next leg.
+ */
+static void integrateWalkers(const int count, const float time,
+                             int* __restrict xs, int* __restrict ys,
+                             const int* __restrict xDsts, const int* __restrict yDsts,
+                             const float* __restrict vels, float* __restrict pending,
+                             unsigned char* __restrict hasMoved, unsigned char* __restrict hasArrived)
+{
+   for(int i = 0; i < count; ++i)
+   {
+      const float totalDistance = pending[i] + time * vels[i];
+      const int stepDistance = static_cast<int>(totalDistance);
+
+      const int xDiff = xDsts[i] - xs[i];
+      const int yDiff = yDsts[i] - ys[i];
+      const int distanceToWaypoint = std::max(abs(xDiff), abs(yDiff));
+
+      const int xMove = std::max(-stepDistance, std::min(xDiff, stepDistance));
+      const int yMove = std::max(-stepDistance, std::min(yDiff, stepDistance));
+      xs[i] += xMove;
+      ys[i] += yMove;
+
+      pending[i] = totalDistance - static_cast<float>(std::min(stepDistance, distanceToWaypoint));
+      hasMoved[i] = (xMove | yMove) != 0;
+      hasArrived[i] = stepDistance >= distanceToWaypoint;
+   }
+}
+
+void MovementSystem::addWalker(Actor* actor, const shapes::Point2D& waypoint, float pendingDistance)
+{
+   const shapes::Point2D& location = actor->getLocation();
+
+   actor->movementLane = actors.size();
+   actors.push_back(actor);
+   xPositions.push_back(location.x);
+   yPositions.push_back(location.y);
+   xWaypoints.push_back(waypoint.x);
+   yWaypoints.push_back(waypoint.y);
+   speeds.push_back(actor->getMovementSpeed());
+   pendingDistances.push_back(pendingDistance);
+   moved.push_back(0);
+   arrived.push_back(0);
+}
+
+float MovementSystem::removeWalker(Actor* actor)
+{
+   if(!hasWalker(actor)) return 0;
+
+   const unsigned int lane = actor->movementLane;
+   const float pendingDistance = pendingDistances[lane];
+
+   // Move the last walker into the vacated lane to keep the arrays dense
+   const unsigned int lastLane = actors.size() - 1;
+   if(lane != lastLane)
+   {
+      actors[lane] = actors[lastLane];
+      xPositions[lane] = xPositions[lastLane];
+      yPositions[lane] = yPositions[lastLane];
+      xWaypoints[lane] = xWaypoints[lastLane];
+      yWaypoints[lane] = yWaypoints[lastLane];
+      speeds[lane] = speeds[lastLane];
+      pendingDistances[lane] = pendingDistances[lastLane];
+      moved[lane] = moved[lastLane];
+      arrived[lane] = arrived[lastLane];
+      actors[lane]->movementLane = lane;
+   }
+
+   actors.pop_back();
+   xPositions.pop_back();
+   yPositions.pop_back();
+   xWaypoints.pop_back();
+   yWaypoints.pop_back();
+   speeds.pop_back();
+   pendingDistances.pop_back();
+   moved.pop_back();
+   arrived.pop_back();
+
+   actor->movementLane = Actor::NO_MOVEMENT_LANE;
+   return pendingDistance;
+}
+
+bool MovementSystem::hasWalker(const Actor* actor) const
+{
+   return actor->movementLane != Actor::NO_MOVEMENT_LANE;
+}
+
+bool MovementSystem::isWalking(const Actor* actor) const
+{
+   return hasWalker(actor) && !arrived[actor->movementLane];
+}
+
+void MovementSystem::setSpeed(const Actor* actor, float speed)
+{
+   if(hasWalker(actor))
+   {
+      speeds[actor->movementLane] = speed;
+   }
+}
+
+unsigned int MovementSystem::size() const
+{
+   return actors.size();
+}
+
+void MovementSystem::step(long timePassed)
+{
+   if(actors.empty()) return;
+
+   integrate(timePassed);
+   commit();
+}
+
+void MovementSystem::integrate(long timePassed)
+{
+   integrateWalkers(actors.size(), static_cast<float>(timePassed),
+                    &xPositions[0], &yPositions[0], &xWaypoints[0], &yWaypoints[0],
+                    &speeds[0], &pendingDistances[0], &moved[0], &arrived[0]);
+}
+
+void MovementSystem::commit()
+{
+   // Location changes send messages, which can end up removing walkers
+   // (for instance, when the player walks onto a map exit). Removing a walker
+   // moves the last lane into its place, so the lanes are committed from the
+   // end: the lanes that get moved down have already been committed, and the
+   // lanes that haven't been committed yet can only move further down.
+   for(unsigned int lane = actors.size(); lane > 0;)
+   {
+      --lane;
+      if(lane >= actors.size())
+      {
+         // Several walkers were removed at once
+         continue;
+      }
+
+      if(moved[lane])
+      {
+         moved[lane] = 0;
+         actors[lane]->setLocation(shapes::Point2D(xPositions[lane], yPositions[lane]));
+      }
+   }
+}
@@ -0,0 +1,122 @@
+/*
+ *  This file is covered by the Ruby license. See LICENSE.txt for more details.
+ *
+ *  Copyright (C) 2007-2012 Noam Chitayat. All rights reserved.
+ */
+
+#ifndef MOVEMENT_SYSTEM_H
+#define MOVEMENT_SYSTEM_H
+
+#include <vector>
+
+class Actor;
+
+namespace shapes
+{
+   struct Point2D;
+};
+
+/**
+ * Moves all walking actors towards their next waypoints in a single pass.
+ *
+ * An actor's MoveOrder does the expensive work (pathfinding, acquiring tiles
+ * in the EntityGrid, choosing animations) once per waypoint, and then hands
+ * the actor to the MovementSystem, which keeps the per-walker state in
+ * parallel arrays and integrates them all together every frame. The order
+ * is only consulted again once the walker arrives at its waypoint.
+ *
+ * @author Noam Chitayat
+ */
+class MovementSystem
+{
+   /** The walking actors (each actor's movementLane is its index in the arrays below). */
+   std::vector<Actor*> actors;
+
+   /** The current x-coordinate (in pixels) of each walker. */
+   std::vector<int> xPositions;
+
+   /** The current y-coordinate (in pixels) of each walker. */
+   std::vector<int> yPositions;
+
+   /** The x-coordinate (in pixels) of the waypoint that each walker is heading to. */
+   std::vector<int> xWaypoints;
+
+   /** The y-coordinate (in pixels) of the waypoint that each walker is heading to. */
+   std::vector<int> yWaypoints;
+
+   /** The movement speed (in pixels per millisecond) of each walker. */
+   std::vector<float> speeds;
+
+   /** The distance (in pixels) each walker has accumulated but not yet moved. */
+   std::vector<float> pendingDistances;
+
+   /** Nonzero for each walker that has moved since the last commit. */
+   std::vector<unsigned char> moved;
+
+   /** Nonzero for each walker that has reached its waypoint. */
+   std::vector<unsigned char> arrived;
+
+   /**
+    * Advance every walker towards its waypoint.
+    *
+    * @param timePassed The amount of time that has passed since the last frame.
+    */
+   void integrate(long timePassed);
+
+   /**
+    * Push the new walker positions back to their actors.
+    */
+   void commit();
+
+   public:
+      /**
+       * Hand an actor over to the movement system until it reaches the specified waypoint.
+       * The actor must not already be walking.
+       *
+       * @param actor The actor to move.
+       * @param waypoint The coordinates (in pixels) to move the actor to.
+       * @param pendingDistance Distance (in pixels) that the actor has accumulated but not yet moved.
+       */
+      void addWalker(Actor* actor, const shapes::Point2D& waypoint, float pendingDistance);
+
+      /**
+       * Stop moving an actor.
+       *
+       * @param actor The actor to stop moving.
+       *
+       * @return The distance (in pixels) that the actor accumulated but did not move.
+       */
+      float removeWalker(Actor* actor);
+
+      /**
+       * @return true iff the actor was handed to the movement system and has not been removed since.
+       */
+      bool hasWalker(const Actor* actor) const;
+
+      /**
+       * @return true iff the actor is still on its way to its waypoint.
+       */
+      bool isWalking(const Actor* actor) const;
+
+      /**
+       * Update the speed of a walking actor.
+       *
+       * @param actor The actor whose speed changed.
+       * @param speed The new movement speed of the actor.
+       */
+      void setSpeed(const Actor* actor, float speed);
+
+      /**
+       * @return The number of actors being moved.
+       */
+      unsigned int size() const;
+
+      /**
+       * Move all the walkers and update their actors' locations.
+       *
+       * @param timePassed The amount of time that has passed since the last frame.
+       */
+      void step(long timePassed);
+};
+
+#endif
@@ -36,3 +36,8 @@ void NPC::activate()
    npcThread->activate();
 }
 
+void NPC::setHandle(const TileEngine& tileEngine, const NPCHandle& handle)
+{
+   npcThread->setHandle(tileEngine, handle);
+}
+
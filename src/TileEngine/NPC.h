@@ -10,6 +10,8 @@
 #include "Actor.h"
 
 class NPCScript;
+class TileEngine;
+struct NPCHandle;
 class Scheduler;
 class ScriptEngine;
 
@@ -75,6 +77,14 @@ class NPC : public Actor
        * player, etc.  
        */
       void activate();
+
+      /**
+       * Give the NPC's script the handle that refers to the NPC.
+       *
+       * @param tileEngine The tile engine holding the NPC.
+       * @param handle The handle of the NPC within the tile engine.
+       */
+      void setHandle(const TileEngine& tileEngine, const NPCHandle& handle);
    
       /**
        * Destructor.
@@ -0,0 +1,228 @@
+/*
+ *  This file is covered by the Ruby license. See LICENSE.txt for more details.
+ *
+ *  Copyright (C) 2007-2012 Noam Chitayat. All rights reserved.
+ */
+
+#include "NPCList.h"
+#include "NPC.h"
+
+#include "DebugUtils.h"
+const int debugFlag = DEBUG_NPC;
+
+const unsigned int NPCList::NO_NPC = ~0u;
+const unsigned int NPCList::INITIAL_BUCKET_COUNT = 16;
+
+/**
+ * djb2 string hash, used to place names in the name index.
+ */
+static unsigned int hashName(const std::string& name)
+{
+   unsigned int hash = 5381;
+   for(std::string::const_iterator iter = name.begin(); iter != name.end(); ++iter)
+   {
+      hash = ((hash << 5) + hash) + static_cast<unsigned char>(*iter);
+   }
+
+   return hash;
+}
+
+NPCHandle::NPCHandle() : index(0), generation(0)
+{
+}
+
+NPCHandle::NPCHandle(unsigned int index, unsigned int generation) : index(index), generation(generation)
+{
+}
+
+bool NPCHandle::isValid() const
+{
+   // Slot generations start at 1, so generation 0 is never handed out
+   return generation != 0;
+}
+
+bool NPCHandle::operator==(const NPCHandle& rhs) const
+{
+   return index == rhs.index && generation == rhs.generation;
+}
+
+bool NPCHandle::operator!=(const NPCHandle& rhs) const
+{
+   return !(*this == rhs);
+}
+
+NPCList::NPCList() : nameIndex(INITIAL_BUCKET_COUNT)
+{
+}
+
+NPCList::NameBucket& NPCList::getBucket(const std::string& name)
+{
+   return nameIndex[hashName(name) % nameIndex.size()];
+}
+
+const NPCList::NameBucket& NPCList::getBucket(const std::string& name) const
+{
+   return nameIndex[hashName(name) % nameIndex.size()];
+}
+
+void NPCList::growNameIndex()
+{
+   std::vector<NameBucket> oldIndex(nameIndex.size() * 2);
+   oldIndex.swap(nameIndex);
+
+   for(std::vector<NameBucket>::const_iterator bucket = oldIndex.begin(); bucket != oldIndex.end(); ++bucket)
+   {
+      for(NameBucket::const_iterator entry = bucket->begin(); entry != bucket->end(); ++entry)
+      {
+         getBucket(entry->first).push_back(*entry);
+      }
+   }
+}
+
+void NPCList::removeName(const std::string& name)
+{
+   NameBucket& bucket = getBucket(name);
+   for(NameBucket::iterator entry = bucket.begin(); entry != bucket.end(); ++entry)
+   {
+      if(entry->first == name)
+      {
+         bucket.erase(entry);
+         return;
+      }
+   }
+}
+
+NPCHandle NPCList::add(NPC* npc)
+{
+   const std::string& name = npc->getName();
+
+   unsigned int slotIndex;
+   if(freeSlots.empty())
+   {
+      Slot newSlot;
+      newSlot.generation = 1;
+      slots.push_back(newSlot);
+      slotIndex = slots.size() - 1;
+   }
+   else
+   {
+      slotIndex = freeSlots.back();
+      freeSlots.pop_back();
+   }
+
+   Slot& slot = slots[slotIndex];
+   slot.npcIndex = npcs.size();
+   npcs.push_back(npc);
+   npcSlots.push_back(slotIndex);
+
+   const NPCHandle handle(slotIndex, slot.generation);
+
+   if(npcs.size() > nameIndex.size())
+   {
+      growNameIndex();
+   }
+
+   getBucket(name).push_back(NameEntry(name, handle));
+
+   DEBUG("NPC %s stored in slot %d (generation %d)", name.c_str(), handle.index, handle.generation);
+   return handle;
+}
+
+void NPCList::remove(const NPCHandle& handle)
+{
+   NPC* npc = get(handle);
+   if(npc == NULL) return;
+
+   Slot& slot = slots[handle.index];
+
+   // Fill the hole in the dense array with the last NPC, and repoint that NPC's slot
+   const unsigned int lastIndex = npcs.size() - 1;
+   if(slot.npcIndex != lastIndex)
+   {
+      npcs[slot.npcIndex] = npcs[lastIndex];
+      npcSlots[slot.npcIndex] = npcSlots[lastIndex];
+      slots[npcSlots[slot.npcIndex]].npcIndex = slot.npcIndex;
+   }
+
+   npcs.pop_back();
+   npcSlots.pop_back();
+
+   // Bumping the generation invalidates all outstanding handles to this slot
+   slot.npcIndex = NO_NPC;
+   ++slot.generation;
+   freeSlots.push_back(handle.index);
+
+   removeName(npc->getName());
+   delete npc;
+}
+
+void NPCList::clear()
+{
+   for(std::vector<NPC*>::iterator iter = npcs.begin(); iter != npcs.end(); ++iter)
+   {
+      delete *iter;
+   }
+
+   for(std::vector<unsigned int>::iterator iter = npcSlots.begin(); iter != npcSlots.end(); ++iter)
+   {
+      Slot& slot = slots[*iter];
+      slot.npcIndex = NO_NPC;
+      ++slot.generation;
+      freeSlots.push_back(*iter);
+   }
+
+   npcs.clear();
+   npcSlots.clear();
+
+   for(std::vector<NameBucket>::iterator bucket = nameIndex.begin(); bucket != nameIndex.end(); ++bucket)
+   {
+      bucket->clear();
+   }
+}
+
+NPC* NPCList::get(const NPCHandle& handle) const
+{
+   if(handle.index >= slots.size()) return NULL;
+
+   const Slot& slot = slots[handle.index];
+   if(slot.generation != handle.generation || slot.npcIndex == NO_NPC)
+   {
+      return NULL;
+   }
+
+   return npcs[slot.npcIndex];
+}
+
+NPCHandle NPCList::find(const std::string& name) const
+{
+   const NameBucket& bucket = getBucket(name);
+   for(NameBucket::const_iterator entry = bucket.begin(); entry != bucket.end(); ++entry)
+   {
+      if(entry->first == name)
+      {
+         return entry->second;
+      }
+   }
+
+   return NPCHandle();
+}
+
+unsigned int NPCList::size() const
+{
+   return npcs.size();
+}
+
+NPCList::const_iterator NPCList::begin() const
+{
+   return npcs.begin();
+}
+
+NPCList::const_iterator NPCList::end() const
+{
+   return npcs.end();
+}
+
+NPCList::~NPCList()
+{
+   clear();
+}
@@ -0,0 +1,185 @@
+/*
+ *  This file is covered by the Ruby license. See LICENSE.txt for more details.
+ *
+ *  Copyright (C) 2007-2012 Noam Chitayat. All rights reserved.
+ */
+
+#ifndef NPC_LIST_H
+#define NPC_LIST_H
+
+#include <string>
+#include <utility>
+#include <vector>
+
+class NPC;
+
+/**
+ * A stable reference to an NPC stored in an NPCList.
+ * The slot index locates the NPC, and the generation is compared against the
+ * slot's generation so that handles to removed NPCs are recognized as stale,
+ * even if the slot has since been reused by a different NPC.
+ */
+struct NPCHandle
+{
+   /** The index of the slot holding the NPC. */
+   unsigned int index;
+
+   /** The generation of the slot at the time the NPC was added. */
+   unsigned int generation;
+
+   /**
+    * Default constructor. Creates a handle that refers to no NPC.
+    */
+   NPCHandle();
+
+   /**
+    * Constructor.
+    *
+    * @param index The index of the slot holding the NPC.
+    * @param generation The generation of the slot when the NPC was added.
+    */
+   NPCHandle(unsigned int index, unsigned int generation);
+
+   /**
+    * @return true iff this handle was ever assigned to an NPC.
+    */
+   bool isValid() const;
+
+   bool operator==(const NPCHandle& rhs) const;
+   bool operator!=(const NPCHandle& rhs) const;
+};
+
+/**
+ * Owning storage for the NPCs on the current map.
+ * NPCs are kept in a contiguous array for per-frame iteration, and addressed
+ * from the outside (e.g. by Lua scripts) through generation-checked handles.
+ * A separate hash index maps NPC names to their handles.
+ *
+ * @author Noam Chitayat
+ */
+class NPCList
+{
+   /** A slot that a handle index refers to. */
+   struct Slot
+   {
+      /** The current generation of the slot (incremented whenever its NPC is removed). */
+      unsigned int generation;
+
+      /** The position of the slot's NPC in the dense NPC array, or NO_NPC if the slot is free. */
+      unsigned int npcIndex;
+   };
+
+   /** An entry in the name index. */
+   typedef std::pair<std::string, NPCHandle> NameEntry;
+
+   /** A bucket of the name index. */
+   typedef std::vector<NameEntry> NameBucket;
+
+   /** Marks a free slot. */
+   static const unsigned int NO_NPC;
+
+   /** The number of name index buckets to start with. */
+   static const unsigned int INITIAL_BUCKET_COUNT;
+
+   /** The dense array of NPCs, iterated every frame. */
+   std::vector<NPC*> npcs;
+
+   /** The slot index of each NPC in the dense array (parallel to npcs). */
+   std::vector<unsigned int> npcSlots;
+
+   /** The slots that handles refer to. */
+   std::vector<Slot> slots;
+
+   /** Indices of slots that can be reused. */
+   std::vector<unsigned int> freeSlots;
+
+   /** The hash index from NPC names to handles. */
+   std::vector<NameBucket> nameIndex;
+
+   /**
+    * @param name The name to hash.
+    *
+    * @return The bucket in the name index that the name belongs in.
+    */
+   NameBucket& getBucket(const std::string& name);
+   const NameBucket& getBucket(const std::string& name) const;
+
+   /**
+    * Rebuild the name index with twice as many buckets.
+    */
+   void growNameIndex();
+
+   /**
+    * Remove a name from the name index.
+    *
+    * @param name The name to remove.
+    */
+   void removeName(const std::string& name);
+
+   public:
+      typedef std::vector<NPC*>::const_iterator const_iterator;
+
+      /**
+       * Constructor.
+       */
+      NPCList();
+
+      /**
+       * Add an NPC to the list. The list takes ownership of the NPC.
+       * NPC names are unique, so no NPC with the same name may already be in the list.
+       *
+       * @param npc The NPC to add.
+       *
+       * @return A handle to the added NPC.
+       */
+      NPCHandle add(NPC* npc);
+
+      /**
+       * Remove and delete an NPC.
+       *
+       * @param handle The handle of the NPC to remove. Stale handles are ignored.
+       */
+      void remove(const NPCHandle& handle);
+
+      /**
+       * Remove and delete all the NPCs in the list.
+       * All previously issued handles become stale.
+       */
+      void clear();
+
+      /**
+       * @param handle The handle of the NPC to get.
+       *
+       * @return The NPC referred to by the handle, or NULL if the handle is stale.
+       */
+      NPC* get(const NPCHandle& handle) const;
+
+      /**
+       * @param name The name of the NPC to find.
+       *
+       * @return The handle of the NPC with the given name, or an invalid handle if there is no such NPC.
+       */
+      NPCHandle find(const std::string& name) const;
+
+      /**
+       * @return The number of NPCs in the list.
+       */
+      unsigned int size() const;
+
+      /**
+       * @return An iterator to the first NPC in the list.
+       */
+      const_iterator begin() const;
+
+      /**
+       * @return An iterator past the last NPC in the list.
+       */
+      const_iterator end() const;
+
+      /**
+       * Destructor.
+       */
+      ~NPCList();
+};
+
+#endif
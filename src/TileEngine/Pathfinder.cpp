@@ -8,6 +8,11 @@
 #include "EntityGrid.h"
 #include "Point2D.h"
 #include "TileState.h"
+#include "Atomic.h"
+#include "Job.h"
+#include "JobSystem.h"
+#include "Tracer.h"
+#include <SDL.h>
 #include <limits>
 #include <algorithm>
 
@@ -17,6 +22,168 @@ const int debugFlag = DEBUG_PATHFINDER;
 const float Pathfinder::ROOT_2 = 1.41421356f;
 const float Pathfinder::INFINITY = std::numeric_limits<float>::infinity();
 
+/** The fewest tiles for which the shortest paths are worth computing on the job system. */
+static const unsigned int PARALLEL_RFW_MIN_TILES = 256;
+
+/**
+ * Relax the shortest paths from a range of tiles through an intermediate tile.
+ *
+ * Ranges of rows can be relaxed at the same time, since the only values that
+ * they share (the intermediate tile's row and column) never change while
+ * relaxing through the intermediate tile.
+ *
+ * @param distanceMatrix The shortest distances found so far.
+ * @param successorMatrix The first steps of the shortest paths found so far.
+ * @param numTiles The number of tiles in the matrices.
+ * @param intermediate The tile to relax the paths through.
+ * @param firstRow The first tile to relax the paths from.
+ * @param endRow One past the last tile to relax the paths from.
+ */
+static void relaxRows(float** distanceMatrix, int** successorMatrix, unsigned int numTiles,
+                      unsigned int intermediate, unsigned int firstRow, unsigned int endRow)
+{
+   const float* intermediateRow = distanceMatrix[intermediate];
+   for(unsigned int a = firstRow; a < endRow; ++a)
+   {
+      const float distanceToIntermediate = distanceMatrix[a][intermediate];
+      if(distanceToIntermediate == std::numeric_limits<float>::infinity())
+      {
+         // No path from this tile can be shortened by going through an unreachable tile
+         continue;
+      }
+
+      float* row = distanceMatrix[a];
+      for(unsigned int b = 0; b < numTiles; ++b)
+      {
+         float distance = distanceToIntermediate + intermediateRow[b];
+         if(distance < row[b])
+         {
+            row[b] = distance;
+            successorMatrix[a][b] = successorMatrix[a][intermediate];
+         }
+      }
+   }
+}
+
+/**
+ * A barrier that a fixed number of threads meet at over and over, spinning (and yielding
+ * the processor) until all of them have arrived. Since the waiting threads never sleep,
+ * it is only suitable for threads that are all known to be running at the same time;
+ * a thread that arrives before the others are running just spins until they are.
+ *
+ * @author Noam Chitayat
+ */
+class SpinBarrier
+{
+   /** The number of threads that meet at the barrier. */
+   const long numThreads;
+
+   /** The number of threads that have arrived since the barrier last opened. */
+   volatile long arrived;
+
+   /** The number of times that the barrier has opened. */
+   volatile long generation;
+
+   public:
+      /**
+       * Constructor.
+       *
+       * @param numThreads The number of threads that meet at the barrier.
+       */
+      SpinBarrier(long numThreads) : numThreads(numThreads), arrived(0), generation(0)
+      {
+      }
+
+      /**
+       * Block until every thread has arrived at the barrier.
+       */
+      void arriveAndWait()
+      {
+         const long currentGeneration = Atomic::load(&generation);
+         if(Atomic::add(&arrived, 1) == numThreads)
+         {
+            // Reset the count before opening, so that nobody arrives for the next round too early
+            Atomic::store(&arrived, 0);
+            Atomic::add(&generation, 1);
+            return;
+         }
+
+         while(Atomic::load(&generation) == currentGeneration)
+         {
+            SDL_Delay(0);
+         }
+      }
+};
+
+/**
+ * Relax the shortest paths from a range of tiles through every tile in turn, meeting
+ * the threads relaxing the other ranges at a barrier after each intermediate tile.
+ *
+ * @param distanceMatrix The shortest distances found so far.
+ * @param successorMatrix The first steps of the shortest paths found so far.
+ * @param numTiles The number of tiles in the matrices.
+ * @param firstRow The first tile to relax the paths from.
+ * @param endRow One past the last tile to relax the paths from.
+ * @param barrier The barrier shared by all of the ranges.
+ */
+static void relaxRowsThroughAllTiles(float** distanceMatrix, int** successorMatrix, unsigned int numTiles,
+                                     unsigned int firstRow, unsigned int endRow, SpinBarrier& barrier)
+{
+   for(unsigned int i = 0; i < numTiles; ++i)
+   {
+      relaxRows(distanceMatrix, successorMatrix, numTiles, i, firstRow, endRow);
+
+      // Every range has to go through this tile before any of them can go through the next one
+      barrier.arriveAndWait();
+   }
+}
+
+/**
+ * Relaxes the shortest paths from a range of tiles through every tile on the job system.
+ *
+ * @author Noam Chitayat
+ */
+class RelaxRowsJob : public Job
+{
+   /** The shortest distances found so far. */
+   float** distanceMatrix;
+
+   /** The first steps of the shortest paths found so far. */
+   int** successorMatrix;
+
+   /** The number of tiles in the matrices. */
+   unsigned int numTiles;
+
+   /** The first tile to relax the paths from. */
+   unsigned int firstRow;
+
+   /** One past the last tile to relax the paths from. */
+   unsigned int endRow;
+
+   /** The barrier shared by all of the ranges. */
+   SpinBarrier& barrier;
+
+   protected:
+      /**
+       * Relax the range of rows.
+       */
+      void run()
+      {
+         relaxRowsThroughAllTiles(distanceMatrix, successorMatrix, numTiles, firstRow, endRow, barrier);
+      }
+
+   public:
+      /**
+       * Constructor.
+       */
+      RelaxRowsJob(float** distanceMatrix, int** successorMatrix, unsigned int numTiles,
+                   unsigned int firstRow, unsigned int endRow, SpinBarrier& barrier) :
+         distanceMatrix(distanceMatrix), successorMatrix(successorMatrix), numTiles(numTiles),
+         firstRow(firstRow), endRow(endRow), barrier(barrier)
+      {
+      }
+};
+
 shapes::Point2D Pathfinder::tileNumToCoords(int tileNum)
 {
    div_t result = div(tileNum, collisionGridBounds.getWidth());
@@ -56,6 +223,7 @@ void Pathfinder::initialize(TileState** grid, int tileSize, const shapes::Rectan
 
 void Pathfinder::initRoyFloydWarshallMatrices()
 {
+   TRACE_ZONE("Pathfinder::initRoyFloydWarshallMatrices");
    const unsigned int NUM_TILES = collisionGridBounds.getArea();
    
    distanceMatrix = new float*[NUM_TILES];
@@ -112,20 +280,45 @@ void Pathfinder::initRoyFloydWarshallMatrices()
       }
    }
 
-   for(unsigned int i = 0; i < NUM_TILES; ++i)
+   // The ranges of rows meet at a barrier, so they can only be split between the workers if
+   // every worker is free to take one. Only the main thread starts jobs, so the job system
+   // stays idle until the ranges are started below.
+   JobSystem* jobSystem = JobSystem::getInstance();
+   if(NUM_TILES < PARALLEL_RFW_MIN_TILES || !jobSystem->isIdle())
    {
-      for(unsigned int a = 0; a < NUM_TILES; ++a)
+      for(unsigned int i = 0; i < NUM_TILES; ++i)
       {
-         for(unsigned int b = 0; b < NUM_TILES; ++b)
-         {
-            float distance = distanceMatrix[a][i] + distanceMatrix[i][b];
-            if(distance < distanceMatrix[a][b])
-            {
-               distanceMatrix[a][b] = distance;
-               successorMatrix[a][b] = successorMatrix[a][i];
-            }
-         }
+         relaxRows(distanceMatrix, successorMatrix, NUM_TILES, i, 0, NUM_TILES);
       }
+
+      return;
+   }
+
+   // Split the rows between the workers and the main thread. Each range goes through every
+   // intermediate tile on the same thread, so only one job per worker is needed.
+   const unsigned int maxChunks = jobSystem->getWorkerCount() + 1;
+   const unsigned int rowsPerChunk = (NUM_TILES + maxChunks - 1) / maxChunks;
+   const unsigned int numChunks = (NUM_TILES + rowsPerChunk - 1) / rowsPerChunk;
+   SpinBarrier barrier(numChunks);
+
+   std::vector<Job*> relaxJobs;
+   for(unsigned int chunk = 1; chunk < numChunks; ++chunk)
+   {
+      const unsigned int firstRow = chunk * rowsPerChunk;
+      const unsigned int endRow = std::min(firstRow + rowsPerChunk, NUM_TILES);
+      Job* relaxJob = new RelaxRowsJob(distanceMatrix, successorMatrix, NUM_TILES, firstRow, endRow, barrier);
+      relaxJobs.push_back(relaxJob);
+      jobSystem->start(relaxJob, false);
+   }
+
+   // Relax the first range directly instead of waiting, since a waiting main thread could pick up
+   // a second range, which would never reach the barrier while the first one is stuck there
+   relaxRowsThroughAllTiles(distanceMatrix, successorMatrix, NUM_TILES, 0, rowsPerChunk, barrier);
+
+   for(std::vector<Job*>::iterator iter = relaxJobs.begin(); iter != relaxJobs.end(); ++iter)
+   {
+      jobSystem->wait(*iter);
+      delete *iter;
    }
 }
 
@@ -213,6 +406,7 @@ class Pathfinder::AStarPoint : public shapes::Point2D
 
 Pathfinder::Path Pathfinder::findAStarPath(const EntityGrid& entityGrid, const shapes::Point2D& src, const shapes::Point2D& dst, const shapes::Size& size)
 {
+   TRACE_ZONE("Pathfinder::findAStarPath");
    if(collisionGrid == NULL) return Path();
 
    const TileState& entityState = collisionGrid[src.y / movementTileSize][src.x / movementTileSize];
@@ -248,7 +442,7 @@ Pathfinder::Path Pathfinder::findAStarPath(const EntityGrid& entityGrid, const s
 
       if(*cheapestPoint == destinationPoint)
       {
-         DEBUG("Found goal point %d,%d", cheapestPoint->x, cheapestPoint->y);
+         DEBUG_VERBOSE("Found goal point %d,%d", cheapestPoint->x, cheapestPoint->y);
          const AStarPoint* curr = cheapestPoint;
          while(curr != NULL)
          {
@@ -258,7 +452,7 @@ Pathfinder::Path Pathfinder::findAStarPath(const EntityGrid& entityGrid, const s
          break;
       }
       
-      DEBUG("Evaluating point %d,%d", cheapestPoint->x, cheapestPoint->y);
+      DEBUG_VERBOSE("Evaluating point %d,%d", cheapestPoint->x, cheapestPoint->y);
 
       // Evaluate all the existing laterally adjacent points,
       // adding 1 as the cost of reaching the point from our current cheapest point.
@@ -307,7 +501,7 @@ void Pathfinder::evaluateAdjacentNodes(const EntityGrid& entityGrid, const TileS
 
          if(freeTile)
          {
-            DEBUG("Pushing point %d,%d onto open set with g()=%f and f()=%f.", iter->x, iter->y, tileGCost, tileGCost + tileHCost);
+            DEBUG_VERBOSE("Pushing point %d,%d onto open set with g()=%f and f()=%f.", iter->x, iter->y, tileGCost, tileGCost + tileHCost);
             openSet.push_back(new AStarPoint(evaluatedPoint, iter->x, iter->y, tileGCost, tileHCost));
             std::push_heap(openSet.begin(), openSet.end(), AStarPoint::IsLowerPriority());
          }
@@ -318,7 +512,7 @@ void Pathfinder::evaluateAdjacentNodes(const EntityGrid& entityGrid, const TileS
          std::vector<AStarPoint*>::const_iterator tileInOpenSet = std::find_if(openSet.begin(), openSet.end(), equality);
          if(tileInOpenSet != openSet.end() && (*tileInOpenSet)->getGCost() > tileGCost)
          {
-            DEBUG("Altering cost of discovered point %d, %d to g()=%f and f()=%f", iter->x, iter->y, tileGCost, tileGCost + tileHCost);
+            DEBUG_VERBOSE("Altering cost of discovered point %d, %d to g()=%f and f()=%f", iter->x, iter->y, tileGCost, tileGCost + tileHCost);
             (*tileInOpenSet)->setGCost(tileGCost);
             (*tileInOpenSet)->setParent(evaluatedPoint);
             std::make_heap(openSet.begin(), openSet.end(), AStarPoint::IsLowerPriority());
@@ -329,6 +523,7 @@ void Pathfinder::evaluateAdjacentNodes(const EntityGrid& entityGrid, const TileS
 
 Pathfinder::Path Pathfinder::findRFWPath(const shapes::Point2D& src, const shapes::Point2D& dst)
 {
+   TRACE_ZONE("Pathfinder::findRFWPath");
    Path path;
 
    int srcTileNum = pixelsToTileNum(src);
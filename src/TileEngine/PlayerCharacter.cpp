@@ -9,6 +9,7 @@
 #include "TileEngine.h"
 #include "Pathfinder.h"
 #include "EntityGrid.h"
+#include "InputBuffer.h"
 
 #include <math.h>
 #include <SDL.h>
@@ -59,27 +60,33 @@ void PlayerCharacter::step(long timePassed)
    int xDirection = 0;
    int yDirection = 0;
 
-   Uint8 *keystate = SDL_GetKeyState(NULL);
-   if(!keystate[SDLK_UP] && keystate[SDLK_DOWN])
+   // Follow the keys as of the input events handled so far, rather than the live keyboard state
+   InputBuffer* input = InputBuffer::getInstance();
+   const bool up = input->isKeyDown(SDLK_UP);
+   const bool down = input->isKeyDown(SDLK_DOWN);
+   const bool left = input->isKeyDown(SDLK_LEFT);
+   const bool right = input->isKeyDown(SDLK_RIGHT);
+
+   if(!up && down)
    {
       // Positive velocity in the y-axis
       direction = DOWN;
       yDirection = 1;      
    }
-   else if(keystate[SDLK_UP] && !keystate[SDLK_DOWN])
+   else if(up && !down)
    {
       // Negative velocity in the y-axis
       direction = UP;
       yDirection = -1;
    }
 
-   if(!keystate[SDLK_LEFT] && keystate[SDLK_RIGHT])
+   if(!left && right)
    {
       // Positive velocity in the x-axis
       direction = direction == UP ? UP_RIGHT : direction == DOWN ? DOWN_RIGHT : RIGHT;
       xDirection = 1;
    }
-   else if(keystate[SDLK_LEFT] && !keystate[SDLK_RIGHT])
+   else if(left && !right)
    {
       // Negative velocity in the x-axis
       direction = direction == UP ? UP_LEFT : direction == DOWN ? DOWN_LEFT : LEFT;
@@ -102,6 +109,12 @@ void PlayerCharacter::step(long timePassed)
       sprite->setAnimation(WALKING_PREFIX, direction);
       setDirection(direction);
       entityGrid.moveToClosestPoint(this, xDirection, yDirection, distanceTraversed);
+
+      // Measure how long the keys took to move the player, now that they have
+      if(up) input->reportKeyResponse(SDLK_UP);
+      if(down) input->reportKeyResponse(SDLK_DOWN);
+      if(left) input->reportKeyResponse(SDLK_LEFT);
+      if(right) input->reportKeyResponse(SDLK_RIGHT);
    }
    else if(isIdle())
    {
@@ -111,10 +124,10 @@ void PlayerCharacter::step(long timePassed)
    Actor::step(timePassed);
 }
 
-void PlayerCharacter::draw()
+void PlayerCharacter::draw(SpriteBatch& batch, float interpolation)
 {
    if(active)
    {
-      Actor::draw();
+      Actor::draw(batch, interpolation);
    }
-}
+}
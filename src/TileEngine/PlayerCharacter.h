@@ -69,8 +69,11 @@ class PlayerCharacter : public Actor
    
       /**
        * Draws the player character at the playerLocation coordinates.
+       *
+       * @param batch The sprite batch to draw the player's sprite into.
+       * @param interpolation How far (from 0 to 1) the drawn frame is between the last tick and the next one.
        */
-      void draw();
+      void draw(SpriteBatch& batch, float interpolation);
 };
 
 #endif
@@ -6,18 +6,76 @@
 
 #include "Region.h"
 #include "Map.h"
+#include "Job.h"
+#include "JobSystem.h"
+#include "Tracer.h"
 #include <fstream>
 #include <dirent.h>
 #include "DebugUtils.h"
 
 const int debugFlag = DEBUG_RES_LOAD;
 
+/** A map file of the region, parsed by a ParseMapJob. */
+struct MapFile
+{
+   /** The path to the map file. */
+   std::string path;
+
+   /** true iff the map file could be opened. */
+   bool opened;
+
+   /** The parsed map file. */
+   TiXmlDocument document;
+
+   /** Constructor. */
+   MapFile() : opened(false)
+   {
+   }
+};
+
+/**
+ * Parses the XML of a map file, which is the slowest part of loading a map
+ * that doesn't need the main thread.
+ *
+ * @author Noam Chitayat
+ */
+class ParseMapJob : public Job
+{
+   /** The map file to parse. */
+   MapFile& mapFile;
+
+   protected:
+      /**
+       * Read and parse the map file.
+       */
+      void run()
+      {
+         std::ifstream input(mapFile.path.c_str());
+         if(input)
+         {
+            mapFile.opened = true;
+            input >> mapFile.document;
+         }
+      }
+
+   public:
+      /**
+       * Constructor.
+       *
+       * @param mapFile The map file to parse, which must outlive the job's run.
+       */
+      ParseMapJob(MapFile& mapFile) : mapFile(mapFile)
+      {
+      }
+};
+
 Region::Region(const ResourceKey& name) : Resource(name), regionName(name)
 {
 }
 
 void Region::load(const std::string& path)
 {
+   TRACE_ZONE("Region::load");
    struct dirent *entry;
    DIR *dp;
    std::vector<std::string> files;
@@ -38,13 +96,34 @@ void Region::load(const std::string& path)
    }
    
    closedir(dp);
-   
-   for(std::vector<std::string>::iterator iter = files.begin(); iter != files.end(); ++iter)
+
+   // Parse all the map files at once on the job system, and wait for them to finish
+   JobSystem* jobSystem = JobSystem::getInstance();
+   std::vector<MapFile> mapFiles(files.size());
+   BarrierJob* allParsed = new BarrierJob();
+   for(unsigned int i = 0; i < files.size(); ++i)
    {
-      std::string mapFile(std::string(path) + *iter);
+      mapFiles[i].path = path + files[i];
+      ParseMapJob* parseJob = new ParseMapJob(mapFiles[i]);
+      allParsed->addDependency(parseJob);
+      jobSystem->start(parseJob);
+   }
+
+   jobSystem->start(allParsed);
+   jobSystem->wait(allParsed);
+
+   // The maps are built on this thread, since their layers create textures
+   for(unsigned int i = 0; i < files.size(); ++i)
+   {
+      const std::string& mapFile = mapFiles[i].path;
+      if(!mapFiles[i].opened)
+      {
+         T_T(std::string("Failed to open map file for reading: ") + mapFile);
+      }
+
       try
       {
-         Map* nextMap = new Map(iter->substr(0, iter->length() - 4), mapFile);
+         Map* nextMap = new Map(files[i].substr(0, files[i].length() - 4), mapFiles[i].document);
          areas[nextMap->getName()] = nextMap;
       }
       catch(Exception& e)
@@ -12,6 +12,10 @@
 #include "Scheduler.h"
 #include "Container.h"
 #include "GraphicsUtil.h"
+#include "RenderTexture.h"
+#include "InputBuffer.h"
+#include "FrameTelemetry.h"
+#include "Tracer.h"
 #include "ResourceLoader.h"
 #include "Region.h"
 #include "Map.h"
@@ -19,6 +23,7 @@
 #include "MapExitMessage.h"
 #include "Pathfinder.h"
 #include "Rectangle.h"
+#include "SpriteBatch.h"
 #include "DebugConsoleWindow.h"
 #include "DialogueController.h"
 #include "OpenGLTTF.h"
@@ -30,8 +35,25 @@ const int debugFlag = DEBUG_TILE_ENG;
 
 const int TileEngine::TILE_SIZE = 32;
 
+const int TileEngine::ACTOR_DEPTH_SLOT = 0;
+const int TileEngine::FIRST_FOREGROUND_DEPTH_SLOT = 1;
+const int TileEngine::DEPTH_SLOTS_PER_ROW = 8;
+
+const int TileEngine::MAP_TRANSITION_TIME = 500;
+
+// Depths fall in the (-1, 1) depth range of the screen's orthogonal projection,
+// so this step supports maps up to 4095 rows tall. It is coarse enough to stay
+// distinct even with a 16-bit depth buffer.
+static const float DEPTH_STEP = 1.0f / 16384;
+
+float TileEngine::getDrawDepth(int row, int slot)
+{
+   const int depthIndex = row * DEPTH_SLOTS_PER_ROW + std::min(slot, DEPTH_SLOTS_PER_ROW - 1);
+   return -1.0f + (depthIndex + 1) * DEPTH_STEP;
+}
+
 TileEngine::TileEngine(ExecutionStack& executionStack, const std::string& chapterName, const std::string& playerDataPath)
-: GameState(executionStack), entityGrid(*this, messagePipe), xMapOffset(0), yMapOffset(0)
+: GameState(executionStack), entityGrid(*this, messagePipe), camera(shapes::Size(GraphicsUtil::width, GraphicsUtil::height)), drawListDirty(true), drawListHasPlayer(false), depthOrdering(true)
 {
    messagePipe.registerListener(this);
    playerActor = new PlayerCharacter(messagePipe, entityGrid, "npc1");
@@ -39,7 +61,6 @@ TileEngine::TileEngine(ExecutionStack& executionStack, const std::string& chapte
    dialogue = new DialogueController(*top, scheduler, *scriptEngine);
    consoleWindow = new edwt::DebugConsoleWindow(top, top->getWidth(), top->getHeight() * 0.2);
    
-   time = SDL_GetTicks();
    loadPlayerData(playerDataPath);
    startChapter(chapterName);
 }
@@ -69,14 +90,8 @@ void TileEngine::startChapter(const std::string& chapterName)
 
 void TileEngine::clearNPCs()
 {
-   std::map<std::string, NPC*>::iterator iter;
-
-   for(iter = npcList.begin(); iter != npcList.end(); ++iter)
-   {
-      delete iter->second;
-   }
-
    npcList.clear();
+   drawListDirty = true;
 }
 
 std::string TileEngine::getMapName()
@@ -91,6 +106,11 @@ void TileEngine::receive(const MapExitMessage& message)
       std::string exitedMap = entityGrid.getMapName();
       std::string enteredMap = message.mapExit.getNextMap();
       DEBUG("Exit signal received: Exiting %s and entering %s", exitedMap.c_str(), enteredMap.c_str());
+      if(!GraphicsUtil::isHeadless())
+      {
+         GraphicsUtil::getInstance()->crossFade(MAP_TRANSITION_TIME);
+      }
+
       setMap(enteredMap);
       const shapes::Point2D& entryPoint = entityGrid.getMapData()->getMapEntrance(exitedMap);
       playerActor->addToMap(entryPoint);
@@ -136,20 +156,21 @@ int TileEngine::setMap(std::string mapName)
 
    DEBUG("Map set to: %s", mapName.c_str());
 
-   recalculateMapOffsets();
+   camera.setMapSize(entityGrid.getMapBounds().getSize() * TILE_SIZE);
 
    return scriptEngine->runMapScript(currRegion->getName(), mapName);
 }
 
-void TileEngine::recalculateMapOffsets()
+void TileEngine::updateCamera(float interpolation)
 {
-   const shapes::Size& mapPixelBounds = entityGrid.getMapBounds().getSize() * TILE_SIZE;
-
-   xMapOffset = mapPixelBounds.width < GraphicsUtil::width ? 
-              (GraphicsUtil::width - mapPixelBounds.width) >> 1 : 0;
-
-   yMapOffset = mapPixelBounds.height < GraphicsUtil::height ?
-              (GraphicsUtil::height - mapPixelBounds.height) >> 1 : 0;
+   if(playerActor->isActive())
+   {
+      // Follow the player where it is drawn, so that the player doesn't jitter against the map
+      const shapes::Point2D playerLocation = playerActor->getDrawLocation(interpolation);
+      const shapes::Size& playerSize = playerActor->getSize();
+      camera.focusOn(shapes::Point2D(playerLocation.x + (playerSize.width >> 1),
+                                     playerLocation.y + (playerSize.height >> 1)));
+   }
 }
 
 void TileEngine::toggleDebugConsole()
@@ -169,16 +190,23 @@ void TileEngine::toggleDebugConsole()
    }
 }
 
-NPC* TileEngine::addNPC(const std::string& npcName, const std::string& spritesheetName, const shapes::Point2D& npcLocation, const shapes::Size& size)
+NPCHandle TileEngine::addNPC(const std::string& npcName, const std::string& spritesheetName, const shapes::Point2D& npcLocation, const shapes::Size& size)
 {
-   NPC* npcToAdd = NULL;
+   NPCHandle handle;
    
-   if(entityGrid.isAreaFree(shapes::Rectangle(npcLocation, size)))
+   if(npcList.find(npcName).isValid())
+   {
+      // The NPC with this name is already on the entity grid, so it can't be replaced here
+      DEBUG("Cannot add NPC %s; an NPC with that name already exists.", npcName.c_str());
+   }
+   else if(entityGrid.isAreaFree(shapes::Rectangle(npcLocation, size)))
    {
-      npcToAdd = new NPC(*scriptEngine, scheduler, npcName, spritesheetName,
+      NPC* npcToAdd = new NPC(*scriptEngine, scheduler, npcName, spritesheetName,
                                  messagePipe, entityGrid, currRegion->getName(),
                                  npcLocation, size);
-      npcList[npcName] = npcToAdd;
+      handle = npcList.add(npcToAdd);
+      npcToAdd->setHandle(*this, handle);
+      drawListDirty = true;
       entityGrid.addActor(npcToAdd, npcLocation);
    }
    else
@@ -186,18 +214,22 @@ NPC* TileEngine::addNPC(const std::string& npcName, const std::string& spriteshe
       DEBUG("Cannot place NPC at this location; something is in the way.");
    }
 
-   return npcToAdd;
+   return handle;
 }
 
 NPC* TileEngine::getNPC(const std::string& npcName) const
 {
-   std::map<std::string, NPC*>::const_iterator npcIterator = npcList.find(npcName);
-   if(npcIterator != npcList.end())
-   {
-      return npcIterator->second;
-   }
+   return npcList.get(npcList.find(npcName));
+}
+
+NPCHandle TileEngine::findNPC(const std::string& npcName) const
+{
+   return npcList.find(npcName);
+}
 
-   return NULL;
+NPC* TileEngine::getNPC(const NPCHandle& handle) const
+{
+   return npcList.get(handle);
 }
 
 PlayerCharacter* TileEngine::getPlayerCharacter() const
@@ -207,11 +239,11 @@ PlayerCharacter* TileEngine::getPlayerCharacter() const
 
 void TileEngine::stepNPCs(long timePassed)
 {
-   std::map<std::string, NPC*>::iterator iter;
+   NPCList::const_iterator iter;
 
    for(iter = npcList.begin(); iter != npcList.end(); ++iter)
    {
-      NPC* currNPC = iter->second;
+      NPC* currNPC = *iter;
       currNPC->step(timePassed);
    }
 }
@@ -219,11 +251,12 @@ void TileEngine::stepNPCs(long timePassed)
 std::vector<Actor*> TileEngine::collectActors() const
 {
    std::vector<Actor*> actors;
-   std::map<std::string, NPC*>::const_iterator iter;
+   actors.reserve(npcList.size() + 1);
 
+   NPCList::const_iterator iter;
    for(iter = npcList.begin(); iter != npcList.end(); ++iter)
    {
-      NPC* currNPC = iter->second;
+      NPC* currNPC = *iter;
       actors.push_back(currNPC);
    }
 
@@ -240,81 +273,222 @@ static bool higherOnMap(const Actor* lhs, const Actor* rhs)
    return lhs->getLocation().y + lhs->getSize().height < rhs->getLocation().y + rhs->getSize().height;
 }
 
-void TileEngine::draw()
+void TileEngine::updateDrawList()
 {
-   // Collect the drawable actors and sort them by their y-location (in tiles)
-   std::vector<Actor*> actors = collectActors();
+   const bool playerActive = playerActor->isActive();
+   if(drawListDirty || drawListHasPlayer != playerActive)
+   {
+      drawList = collectActors();
+      drawListHasPlayer = playerActive;
+      drawListDirty = false;
+   }
+
+   // Actors only move a few pixels per frame, so the list from the last frame
+   // is almost always sorted already, and insertion sort finishes in one pass.
+   const unsigned int numActors = drawList.size();
+   for(unsigned int i = 1; i < numActors; ++i)
+   {
+      Actor* actor = drawList[i];
+
+      unsigned int j = i;
+      for(; j > 0 && higherOnMap(actor, drawList[j - 1]); --j)
+      {
+         drawList[j] = drawList[j - 1];
+      }
+
+      drawList[j] = actor;
+   }
+}
+
+void TileEngine::draw(float interpolation)
+{
+   TRACE_ZONE("TileEngine::draw");
+
+   // Update the drawable actors and sort them by their y-location
+   updateDrawList();
+   const std::vector<Actor*>& actors = drawList;
+
+   updateCamera(interpolation);
 
    GraphicsUtil::getInstance()->clearBuffer();
-   GraphicsUtil::getInstance()->setOffset(xMapOffset, yMapOffset);
+   GraphicsUtil::getInstance()->setOffset(camera.getXOffset(), camera.getYOffset());
       // Draw the map layers and actors against an offset (to center all the map elements)
 
       if(entityGrid.getMapData() == NULL)
       {
          // Draw all the sprites
-         std::vector<Actor*>::iterator nextActorToDraw;
+         std::vector<Actor*>::const_iterator nextActorToDraw;
          for(nextActorToDraw = actors.begin(); nextActorToDraw != actors.end(); ++nextActorToDraw)
          {
-            (*nextActorToDraw)->draw();
+            (*nextActorToDraw)->draw(spriteBatch, interpolation);
          }
+
+         GraphicsUtil::getInstance()->setBlendEnabled(true);
+         spriteBatch.flush();
+         GraphicsUtil::getInstance()->setBlendEnabled(false);
       }
       else
       {
-         std::sort(actors.begin(), actors.end(), higherOnMap);
+         // Only the rows and columns on screen are drawn
+         const shapes::Rectangle visibleArea = camera.getVisibleTiles(TILE_SIZE);
 
-         std::vector<Actor*>::iterator nextActorToDraw = actors.begin();
+         // Start by drawing the background layers, which are all behind the actors
+         {
+            TRACE_ZONE("Draw background");
+            entityGrid.drawBackground(visibleArea);
+         }
 
-         const unsigned int mapHeight = entityGrid.getMapBounds().getHeight();
-         for(int row = 0; row < mapHeight; ++row)
+         // Actors are in front of the foreground rows up to their own row, or up
+         // to the row of any actor sorted before them (which they are drawn over).
+         // Actors sharing a row share a depth, and are drawn in sorted order.
+         actorRowEnds.clear();
+         int actorRow = 0;
+         std::vector<Actor*>::const_iterator nextActorToDraw;
+         for(nextActorToDraw = actors.begin(); nextActorToDraw != actors.end(); ++nextActorToDraw)
          {
-            // Start by drawing a row of the background layers, if the map exists
-            if(entityGrid.getMapData() != NULL)
+            actorRow = std::max(actorRow, (*nextActorToDraw)->getLocation().y / TILE_SIZE);
+
+            if(camera.isVisible((*nextActorToDraw)->getDrawBounds(interpolation)))
             {
-               entityGrid.drawBackground(row);
+               spriteBatch.setDepth(getDrawDepth(actorRow, ACTOR_DEPTH_SLOT));
+               (*nextActorToDraw)->draw(spriteBatch, interpolation);
+
+               if(actorRowEnds.empty() || actorRowEnds.back().first != actorRow)
+               {
+                  actorRowEnds.push_back(std::make_pair(actorRow, 0u));
+               }
+
+               actorRowEnds.back().second = spriteBatch.getQuadCount();
             }
          }
 
-         for(int row = 0; row < mapHeight; ++row)
+         GraphicsUtil* graphics = GraphicsUtil::getInstance();
+         if(depthOrdering)
          {
-            // Draw all the sprites on the row
-            for(; nextActorToDraw != actors.end(); ++nextActorToDraw)
+            // The fully opaque pixels of the sprites and of each foreground layer
+            // are drawn first, in single batches, and the depths alone decide which
+            // of them end up on screen, as the row order did.
+            graphics->setBlendEnabled(false);
+            graphics->setAlphaTestOpaqueOnly(true);
+            graphics->setDepthTestEnabled(true);
             {
-               int nextActorTile = (*nextActorToDraw)->getLocation().y / TILE_SIZE;
-               if(nextActorTile > row) break;
-               (*nextActorToDraw)->draw();
+               TRACE_ZONE("Draw actors");
+               spriteBatch.draw(0, spriteBatch.getQuadCount());
             }
 
-            // Draw a row of the foreground layers, if the map exists
-            if(entityGrid.getMapData() != NULL)
             {
-               entityGrid.drawForeground(row);
+               TRACE_ZONE("Draw foreground");
+               entityGrid.drawForeground(visibleArea);
             }
+
+            // The translucent pixels must not hide anything drawn after them
+            graphics->setDepthWriteEnabled(false);
          }
+
+         {
+            TRACE_ZONE("Blend actors and foreground");
+            drawBlendedRows(visibleArea);
+         }
+
+         graphics->setDepthWriteEnabled(true);
+         graphics->setDepthTestEnabled(false);
+         spriteBatch.clear();
       }
    GraphicsUtil::getInstance()->resetOffset();
 }
 
-bool TileEngine::step()
+void TileEngine::drawBlendedRows(const shapes::Rectangle& visibleArea)
 {
-   long prevTime = time;
-   time = SDL_GetTicks();
+   GraphicsUtil* graphics = GraphicsUtil::getInstance();
+   graphics->setAlphaTestOpaqueOnly(false);
+   graphics->setBlendEnabled(true);
+
+   // Translucent pixels must be blended back to front, so the rows are drawn in order.
+   // With depth ordering, whatever is behind the opaque pixels drawn earlier fails
+   // the depth test, and the opaque pixels themselves are redrawn unchanged, so the
+   // result is the same as drawing every row in order without the depth test.
+   const int mapHeight = entityGrid.getMapBounds().getHeight();
+   std::vector<std::pair<int, unsigned int> >::const_iterator nextActorRow = actorRowEnds.begin();
+   unsigned int firstQuad = 0;
+   for(int row = std::max(0, visibleArea.top); row < mapHeight || nextActorRow != actorRowEnds.end(); ++row)
+   {
+      // The row's sprites must be drawn before the foreground covers them
+      for(; nextActorRow != actorRowEnds.end() && nextActorRow->first <= row; ++nextActorRow)
+      {
+         spriteBatch.draw(firstQuad, nextActorRow->second);
+         firstQuad = nextActorRow->second;
+      }
+
+      if(row < mapHeight)
+      {
+         entityGrid.drawForeground(row, visibleArea);
+      }
+   }
 
-   long timePassed = time - prevTime;
-   if(timePassed > 32)
+   graphics->setBlendEnabled(false);
+}
+
+unsigned int TileEngine::compareDrawOrders(RenderTexture& target)
+{
+   std::vector<unsigned char> pixels[2];
+   for(int i = 0; i < 2; ++i)
    {
-      timePassed = 32;
+      depthOrdering = (i == 0);
+      target.beginDrawing();
+      draw(1.0f);
+      target.endDrawing();
+      target.readPixels(pixels[i]);
    }
 
+   depthOrdering = true;
+
+   unsigned int differentPixels = 0;
+   for(unsigned int i = 0; i < pixels[0].size(); i += 4)
+   {
+      if(!std::equal(pixels[0].begin() + i, pixels[0].begin() + i + 4, pixels[1].begin() + i))
+      {
+         ++differentPixels;
+      }
+   }
+
+   return differentPixels;
+}
+
+bool TileEngine::step(long timePassed)
+{
+   // Remember where the actors were before this tick, so that drawing can smooth out their movement
+   for(NPCList::const_iterator iter = npcList.begin(); iter != npcList.end(); ++iter)
+   {
+      (*iter)->savePreviousLocation();
+   }
+
+   playerActor->savePreviousLocation();
+
    bool done = false;
-   scheduler.runThreads(timePassed);
+   {
+      FrameTelemetry::Scope schedulerScope(FrameTelemetry::SCHEDULER);
+      scheduler.runThreads(timePassed);
+   }
 
-   handleInputEvents(done);
+   {
+      FrameTelemetry::Scope inputScope(FrameTelemetry::INPUT);
+      handleInputEvents(done);
+   }
 
-   playerActor->step(timePassed);
+   {
+      FrameTelemetry::Scope playerScope(FrameTelemetry::PLAYER);
+      playerActor->step(timePassed);
+   }
 
-   entityGrid.step(timePassed);
+   {
+      FrameTelemetry::Scope gridScope(FrameTelemetry::ENTITY_GRID);
+      entityGrid.step(timePassed);
+   }
 
-   stepNPCs(timePassed);
+   {
+      FrameTelemetry::Scope npcScope(FrameTelemetry::NPCS);
+      stepNPCs(timePassed);
+   }
 
    return !done;
 }
@@ -323,7 +497,7 @@ void TileEngine::handleInputEvents(bool& finishState)
 {
    SDL_Event event;
 
-   while(SDL_PollEvent(&event))
+   while(InputBuffer::getInstance()->popEvent(event))
    {
       switch (event.type)
       {
@@ -403,10 +577,10 @@ void TileEngine::handleInputEvents(bool& finishState)
             break;
          }
       }
-   }
 
-   // If the tile engine didn't consume this event, then propagate to the generic input handling
-   handleEvent(event);
+      // If the tile engine didn't consume this event, then propagate to the generic input handling
+      handleEvent(event);
+   }
 }
 
 void TileEngine::action()
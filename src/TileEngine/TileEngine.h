@@ -14,8 +14,10 @@
 #include "EntityGrid.h"
 #include "Listener.h"
 #include "PlayerData.h"
+#include "NPCList.h"
+#include "Camera.h"
+#include "SpriteBatch.h"
 
-#include <map>
 #include <string>
 
 class NPC;
@@ -24,6 +26,7 @@ class PlayerCharacter;
 class Region;
 class DialogueController;
 class Task;
+class RenderTexture;
 
 namespace edwt
 {
@@ -41,9 +44,6 @@ namespace edwt
  */
 class TileEngine: public GameState, public messaging::Listener<MapExitMessage>
 {
-   /** Time since the first logic step of the TileEngine instance. */
-   unsigned long time;
-
    /** The current region that the player is in. */
    Region* currRegion;
    
@@ -70,14 +70,29 @@ class TileEngine: public GameState, public messaging::Listener<MapExitMessage>
    /** The actor representing the player character on the map */
    PlayerCharacter* playerActor;
 
-   /** A list of all NPCs in the map, identified by their names. */
-   std::map<std::string, NPC*> npcList;
+   /** A list of all NPCs in the map, addressed by handle or by name. */
+   NPCList npcList;
+
+   /** The camera that determines which part of the map is drawn. */
+   Camera camera;
+
+   /** The batch that actor sprites are collected in before they are drawn. */
+   SpriteBatch spriteBatch;
+
+   /** The actors on the map, kept in drawing order from frame to frame. */
+   std::vector<Actor*> drawList;
+
+   /** true iff NPCs were added or removed since the draw list was collected. */
+   bool drawListDirty;
 
-   /** The x-offset to draw elements of the map at. */
-   int xMapOffset;
+   /** true iff the player character was active when the draw list was collected. */
+   bool drawListHasPlayer;
 
-   /** The y-offset to draw elements of the map at. */
-   int yMapOffset;
+   /** The map row of each group of queued actor sprites, with the end of the group in the sprite batch. */
+   std::vector<std::pair<int, unsigned int> > actorRowEnds;
+
+   /** true iff the opaque actor and foreground pixels are ordered by the depth buffer instead of only by drawing order. */
+   bool depthOrdering;
    
    /**
     * Loads new player data.
@@ -99,10 +114,25 @@ class TileEngine: public GameState, public messaging::Listener<MapExitMessage>
    void toggleDebugConsole();
 
    /**
-    * Recalculate the camera offset (based on map and window dimensions)
-    * in order to center the map and its elements properly.
+    * Move the camera to follow the player character, if the player is on the map.
+    *
+    * @param interpolation How far (from 0 to 1) the drawn frame is between the last tick and the next one.
+    */
+   void updateCamera(float interpolation);
+
+   /**
+    * Recollect the draw list if the set of actors on the map changed, and
+    * restore its drawing order after the actors' movements.
     */
-   void recalculateMapOffsets();
+   void updateDrawList();
+
+   /**
+    * Draw the queued actor sprites and the foreground rows, blended and
+    * interleaved in row order (each row's actors before its foreground tiles).
+    *
+    * @param visibleArea The tiles that are visible on screen.
+    */
+   void drawBlendedRows(const shapes::Rectangle& visibleArea);
 
    /**
     * Handles input events specific to the tile engine.
@@ -126,19 +156,47 @@ class TileEngine: public GameState, public messaging::Listener<MapExitMessage>
        * Logic step.
        * Sends time passed to all controllers so that they can update accordingly.
        * Takes user input if there is any. 
+       *
+       * @param timePassed The length of the tick (in ms).
        */
-      bool step();
+      bool step(long timePassed);
 
       /**
        * Draw map tiles if a map is loaded in, and then coordinate the drawing
        * of all the controllers and widgets.
+       *
+       * @param interpolation How far (from 0 to 1) the drawn frame is between the last tick and the next one.
        */
-      void draw();
+      void draw(float interpolation);
 
    public:
       /** Tile size constant */
       static const int TILE_SIZE;
 
+      /** The depth slot of the actors within each map row. */
+      static const int ACTOR_DEPTH_SLOT;
+
+      /** The depth slot of the first foreground layer within each map row (later layers take the following slots). */
+      static const int FIRST_FOREGROUND_DEPTH_SLOT;
+
+      /** The number of depth slots in each map row. */
+      static const int DEPTH_SLOTS_PER_ROW;
+
+      /** The time (in ms) taken to cross-fade from one map to the next. */
+      static const int MAP_TRANSITION_TIME;
+
+      /**
+       * Get the depth to draw actors and foreground tiles at.
+       * Everything in a row is in front of everything in the rows above it,
+       * and higher slots are in front of lower slots within the same row.
+       *
+       * @param row The map row (in tiles) that the drawn element belongs to.
+       * @param slot The depth slot of the element within the row.
+       *
+       * @return The depth to draw at.
+       */
+      static float getDrawDepth(int row, int slot);
+
       /**
        * Constructor.
        *
@@ -219,9 +277,9 @@ class TileEngine: public GameState, public messaging::Listener<MapExitMessage>
        * @param npcLocation The location where we spawn the NPC
        * @param size The size of the new NPC
        *
-       * @return The created NPC (or NULL if it could not be placed in the map).
+       * @return A handle to the created NPC (or an invalid handle if it could not be placed in the map).
        */
-      NPC* addNPC(const std::string& npcName, const std::string& spritesheetName, const shapes::Point2D& npcLocation, const shapes::Size& size);
+      NPCHandle addNPC(const std::string& npcName, const std::string& spritesheetName, const shapes::Point2D& npcLocation, const shapes::Size& size);
 
       /**
        * @param npcName The name of the NPC to find.
@@ -230,11 +288,36 @@ class TileEngine: public GameState, public messaging::Listener<MapExitMessage>
        */
       NPC* getNPC(const std::string& npcName) const;
 
+      /**
+       * @param npcName The name of the NPC to find.
+       *
+       * @return A handle to the NPC in the current map with the specified name
+       *         (or an invalid handle if there is no such NPC).
+       */
+      NPCHandle findNPC(const std::string& npcName) const;
+
+      /**
+       * @param handle The handle of the NPC to get.
+       *
+       * @return The NPC referred to by the handle, or NULL if the NPC has since been removed.
+       */
+      NPC* getNPC(const NPCHandle& handle) const;
+
       /**
        * @return The player character in the tile engine.
        */
       PlayerCharacter* getPlayerCharacter() const;
 
+      /**
+       * Draw the current frame into a render texture twice, once with depth
+       * ordering and once in plain row order, and count the pixels that differ.
+       *
+       * @param target The render texture (with a depth buffer) to draw into.
+       *
+       * @return The number of pixels that differ between the two drawings.
+       */
+      unsigned int compareDrawOrders(RenderTexture& target);
+
       /**
        * Destructor.
        */
@@ -92,48 +92,86 @@ void Tileset::load(const std::string& path)
    }
 }
 
-void Tileset::draw(int destX, int destY, int tileNum, bool useAlphaTesting)
+void Tileset::getTexCoords(int tileNum, float& left, float& top, float& right, float& bottom) const
 {
    int tilesetX = tileNum % size.width;
    int tilesetY = tileNum / size.width;
 
+   float tileRight = float((tilesetX + 1) * TileEngine::TILE_SIZE - 1);
+   float tileBottom = float((tilesetY + 1) * TileEngine::TILE_SIZE - 1);
+
+   top = float(tilesetY) / size.height;
+   bottom = float(tileBottom) / (size.height * TileEngine::TILE_SIZE - 1);
+   left = float(tilesetX) / size.width;
+   right = float(tileRight) / (size.width * TileEngine::TILE_SIZE - 1);
+}
+
+void Tileset::draw(int destX, int destY, int tileNum, float depth, bool useAlphaTesting)
+{
    float destLeft = float(destX * TileEngine::TILE_SIZE);
    float destRight = float((destX + 1) * TileEngine::TILE_SIZE);
    float destTop = float(destY * TileEngine::TILE_SIZE);
    float destBottom = float((destY + 1) * TileEngine::TILE_SIZE);
 
-   float tileRight = float((tilesetX + 1) * TileEngine::TILE_SIZE - 1);
-   float tileBottom = float((tilesetY + 1) * TileEngine::TILE_SIZE - 1);
+   float left, top, right, bottom;
+   getTexCoords(tileNum, left, top, right, bottom);
 
-   float top = float(tilesetY) / size.height;
-   float bottom = float(tileBottom) / (size.height * TileEngine::TILE_SIZE - 1);
-   float left = float(tilesetX) / size.width;
-   float right = float(tileRight) / (size.width * TileEngine::TILE_SIZE - 1);
+   // NOTE: Alpha testing doesn't do transparency; it either draws a pixel or it doesn't
+   // If we want partial transparency, we would need to use alpha blending
+   GraphicsUtil::getInstance()->setAlphaTestEnabled(useAlphaTesting);
 
-   glPushAttrib(GL_COLOR_BUFFER_BIT);
+   texture->bind();
 
-   if(useAlphaTesting)
-   {
-      // NOTE: Alpha testing doesn't do transparency; it either draws a pixel or it doesn't
-      // If we want partial transparency, we would need to use alpha blending
+   glBegin(GL_QUADS);
+      glTexCoord2f(left, top); glVertex3f(destLeft, destTop, depth);
+      glTexCoord2f(right, top); glVertex3f(destRight, destTop, depth);
+      glTexCoord2f(right, bottom); glVertex3f(destRight, destBottom, depth);
+      glTexCoord2f(left, bottom); glVertex3f(destLeft, destBottom, depth);
+   glEnd();
+}
+
+void Tileset::addTile(int destX, int destY, int tileNum, float depth, std::vector<float>& vertices, std::vector<float>& texCoords) const
+{
+   float destLeft = float(destX * TileEngine::TILE_SIZE);
+   float destRight = float((destX + 1) * TileEngine::TILE_SIZE);
+   float destTop = float(destY * TileEngine::TILE_SIZE);
+   float destBottom = float((destY + 1) * TileEngine::TILE_SIZE);
 
-       // Enable alpha testing
-      glEnable(GL_ALPHA_TEST);
+   float left, top, right, bottom;
+   getTexCoords(tileNum, left, top, right, bottom);
 
-      // Set the alpha blending evaluation function
-      glAlphaFunc(GL_GREATER, 0.1f);
-   }
+   // Same vertex order as the immediate mode quads in draw()
+   const float quadVertices[] = { destLeft, destTop, depth, destRight, destTop, depth,
+                                  destRight, destBottom, depth, destLeft, destBottom, depth };
+   const float quadTexCoords[] = { left, top, right, top, right, bottom, left, bottom };
+
+   vertices.insert(vertices.end(), quadVertices, quadVertices + 12);
+   texCoords.insert(texCoords.end(), quadTexCoords, quadTexCoords + 8);
+}
 
+void Tileset::beginTiles(const std::vector<float>& vertices, const std::vector<float>& texCoords, bool useAlphaTesting)
+{
+   GraphicsUtil::getInstance()->setAlphaTestEnabled(useAlphaTesting);
    texture->bind();
 
-   glBegin(GL_QUADS);
-      glTexCoord2f(left, top); glVertex3f(destLeft, destTop, 0.0f);
-      glTexCoord2f(right, top); glVertex3f(destRight, destTop, 0.0f);
-      glTexCoord2f(right, bottom); glVertex3f(destRight, destBottom, 0.0f);
-      glTexCoord2f(left, bottom); glVertex3f(destLeft, destBottom, 0.0f);
-   glEnd();
+   glPushClientAttrib(GL_CLIENT_VERTEX_ARRAY_BIT);
 
-   glPopAttrib();
+   glEnableClientState(GL_VERTEX_ARRAY);
+   glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+   glVertexPointer(3, GL_FLOAT, 0, &vertices[0]);
+   glTexCoordPointer(2, GL_FLOAT, 0, &texCoords[0]);
+}
+
+void Tileset::drawTileRange(unsigned int firstTile, unsigned int numTiles)
+{
+   if(numTiles == 0) return;
+
+   glDrawArrays(GL_QUADS, firstTile * 4, numTiles * 4);
+}
+
+void Tileset::endTiles()
+{
+   glPopClientAttrib();
 }
 
 void Tileset::drawColorToTile(int destX, int destY, float r, float g, float b)
@@ -143,16 +181,18 @@ void Tileset::drawColorToTile(int destX, int destY, float r, float g, float b)
    float destTop = float(destY * TileEngine::TILE_SIZE);
    float destBottom = float((destY + 1) * TileEngine::TILE_SIZE);
 
+   GraphicsUtil* graphics = GraphicsUtil::getInstance();
+
    glPushAttrib(GL_ENABLE_BIT);
    glDisable(GL_TEXTURE_2D);
+   graphics->setColor(r, g, b);
    glBegin(GL_QUADS);
-      glColor3f(r, g, b);
       glVertex3f(destLeft, destTop, 0.0f);
       glVertex3f(destRight, destTop, 0.0f);
       glVertex3f(destRight, destBottom, 0.0f);
       glVertex3f(destLeft, destBottom, 0.0f);
-      glColor3f(1.0f, 1.0f, 1.0f);
    glEnd();
+   graphics->setColor(1.0f, 1.0f, 1.0f);
    glPopAttrib();
 }
 
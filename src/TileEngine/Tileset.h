@@ -32,6 +32,17 @@ class Tileset : public Resource
 
    void load(const std::string& path);
 
+   /**
+    * Get the texture coordinates of a tile in the tileset image.
+    *
+    * @param tileNum The index of the tile
+    * @param left Returned as the left texture coordinate of the tile
+    * @param top Returned as the top texture coordinate of the tile
+    * @param right Returned as the right texture coordinate of the tile
+    * @param bottom Returned as the bottom texture coordinate of the tile
+    */
+   void getTexCoords(int tileNum, float& left, float& top, float& right, float& bottom) const;
+
    public:
 
       /**
@@ -64,9 +75,47 @@ class Tileset : public Resource
        * @param destX The destination x-location (in tiles)
        * @param destY The destination y-location (in tiles)
        * @param tileNum The index of the tile to draw
+       * @param depth The depth to draw the tile at
        * @param useAlphaTesting true iff transparent parts of the tile shouldn't be drawn
        */
-      void draw(int destX, int destY, int tileNum, bool useAlphaTesting = false);
+      void draw(int destX, int destY, int tileNum, float depth, bool useAlphaTesting = false);
+
+      /**
+       * Appends a quad for the specified tile to a set of vertex arrays,
+       * so that it can later be drawn in a batch with drawTiles.
+       *
+       * @param destX The destination x-location (in tiles)
+       * @param destY The destination y-location (in tiles)
+       * @param tileNum The index of the tile to add
+       * @param depth The depth to draw the tile at
+       * @param vertices The vertex coordinate array to append the quad's 4 vertices to
+       * @param texCoords The texture coordinate array to append the quad's 4 texture coordinates to
+       */
+      void addTile(int destX, int destY, int tileNum, float depth, std::vector<float>& vertices, std::vector<float>& texCoords) const;
+
+      /**
+       * Prepares to draw ranges of tiles from a set of vertex arrays built with addTile,
+       * binding the tileset texture once for all of them.
+       * Each call must be followed by calls to drawTileRange, and then by a call to endTiles.
+       *
+       * @param vertices The vertex coordinate array of the tiles (must not be empty)
+       * @param texCoords The texture coordinate array of the tiles
+       * @param useAlphaTesting true iff transparent parts of the tiles shouldn't be drawn
+       */
+      void beginTiles(const std::vector<float>& vertices, const std::vector<float>& texCoords, bool useAlphaTesting = false);
+
+      /**
+       * Draws a range of tiles from the vertex arrays passed to beginTiles, in a single draw call.
+       *
+       * @param firstTile The index of the first tile to draw
+       * @param numTiles The number of tiles to draw
+       */
+      void drawTileRange(unsigned int firstTile, unsigned int numTiles);
+
+      /**
+       * Finishes drawing ranges of tiles after a call to beginTiles.
+       */
+      void endTiles();
 
       /**
        * Draws the specified color to the coordinates specified
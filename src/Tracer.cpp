@@ -0,0 +1,129 @@
+/*
+ *  This file is covered by the Ruby license. See LICENSE.txt for more details.
+ *
+ *  Copyright (C) 2007-2012 Noam Chitayat. All rights reserved.
+ */
+
+#include "Tracer.h"
+#include <stdio.h>
+
+#ifdef _WIN32
+   #include <windows.h>
+#else
+   #include <sys/time.h>
+#endif
+
+#include "DebugUtils.h"
+const int debugFlag = DEBUG_MAIN;
+
+Tracer::Event* Tracer::chunk = NULL;
+unsigned int Tracer::chunkEvents = 0;
+std::vector<Tracer::Event*> Tracer::fullChunks;
+bool Tracer::capturing = false;
+
+/** The path of the trace file. */
+static std::string tracePath;
+
+/** The clock time (in clock ticks) when the capture started, which the trace times are relative to. */
+static double clockStart = 0.0;
+
+/** The system time (in microseconds) when the capture started, for measuring the clock speed. */
+static double systemStart = 0.0;
+
+/** The shortest time (in microseconds) to measure the clock speed over. */
+static const double CLOCK_CALIBRATION_TIME = 20000.0;
+
+void Tracer::start(const std::string& path)
+{
+   if(capturing) return;
+
+#ifndef TRACE_MODE
+   DEBUG("The game was built without TRACE_MODE, so the trace will be empty.");
+#endif
+
+   DEBUG("Capturing trace to %s.", path.c_str());
+   tracePath = path;
+   chunk = new Event[CHUNK_SIZE];
+   chunkEvents = 0;
+
+   clockStart = now();
+   systemStart = getSystemTime();
+   capturing = true;
+}
+
+void Tracer::stop()
+{
+   if(!capturing) return;
+   capturing = false;
+
+   // The clock speed is measured over the whole capture, but at least long enough to be accurate
+   while(getSystemTime() - systemStart < CLOCK_CALIBRATION_TIME);
+   const double ticksPerMicrosecond = (now() - clockStart) / (getSystemTime() - systemStart);
+
+   fullChunks.push_back(chunk);
+   chunk = NULL;
+
+   FILE* traceFile = fopen(tracePath.c_str(), "w");
+   if(traceFile == NULL)
+   {
+      DEBUG("Unable to write trace file %s.", tracePath.c_str());
+   }
+   else
+   {
+      fprintf(traceFile, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+
+      // Every event is a "complete" event, since zones are always properly nested
+      const char* separator = "";
+      for(unsigned int chunkIndex = 0; chunkIndex < fullChunks.size(); ++chunkIndex)
+      {
+         const bool lastChunk = chunkIndex + 1 == fullChunks.size();
+         const unsigned int numEvents = lastChunk ? chunkEvents : CHUNK_SIZE;
+         for(unsigned int i = 0; i < numEvents; ++i)
+         {
+            const Event& event = fullChunks[chunkIndex][i];
+            fprintf(traceFile, "%s{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":%.3f,\"dur\":%.3f}",
+                    separator, event.name, (event.start - clockStart) / ticksPerMicrosecond,
+                    (event.end - event.start) / ticksPerMicrosecond);
+            separator = ",\n";
+         }
+      }
+
+      fprintf(traceFile, "\n]}\n");
+      fclose(traceFile);
+      DEBUG("Wrote trace file %s.", tracePath.c_str());
+   }
+
+   for(std::vector<Event*>::iterator iter = fullChunks.begin(); iter != fullChunks.end(); ++iter)
+   {
+      delete [] *iter;
+   }
+
+   fullChunks.clear();
+   chunkEvents = 0;
+}
+
+void Tracer::addChunk()
+{
+   fullChunks.push_back(chunk);
+   chunk = new Event[CHUNK_SIZE];
+   chunkEvents = 0;
+}
+
+double Tracer::getSystemTime()
+{
+#ifdef _WIN32
+   static LARGE_INTEGER frequency;
+   if(frequency.QuadPart == 0)
+   {
+      QueryPerformanceFrequency(&frequency);
+   }
+
+   LARGE_INTEGER counter;
+   QueryPerformanceCounter(&counter);
+   return double(counter.QuadPart) * 1000000.0 / double(frequency.QuadPart);
+#else
+   timeval time;
+   gettimeofday(&time, NULL);
+   return double(time.tv_sec) * 1000000.0 + double(time.tv_usec);
+#endif
+}
@@ -0,0 +1,181 @@
+/*
+ *  This file is covered by the Ruby license. See LICENSE.txt for more details.
+ *
+ *  Copyright (C) 2007-2012 Noam Chitayat. All rights reserved.
+ */
+
+#ifndef TRACER_H
+#define TRACER_H
+
+#include <string>
+#include <vector>
+
+// On x86, the zones are timed with the processor's time stamp counter, which is much
+// cheaper to read than the system clock
+#if defined(__i386__) || defined(__x86_64__) || defined(_M_IX86) || defined(_M_X64)
+   #define TRACER_USE_TSC
+   #ifdef _MSC_VER
+      #include <intrin.h>
+   #else
+      #include <x86intrin.h>
+   #endif
+#endif
+
+// Trace zones only exist in builds with TRACE_MODE defined; otherwise they compile to nothing.
+// The zone name must be a string literal, since only the pointer is kept until the trace is written.
+#ifdef TRACE_MODE
+   #define TRACE_ZONE_VARIABLE(line) traceZone ## line
+   #define TRACE_ZONE_AT_LINE(name, line) TraceZone TRACE_ZONE_VARIABLE(line)(name)
+   #define TRACE_ZONE_EXPAND(name, line) TRACE_ZONE_AT_LINE(name, line)
+   #define TRACE_ZONE(name) TRACE_ZONE_EXPAND(name, __LINE__)
+#else
+   #define TRACE_ZONE(name)
+#endif
+
+/**
+ * Captures a trace of the time spent in the trace zones of the game, and writes it as
+ * trace event JSON that can be opened in Chrome (about:tracing) or Perfetto.
+ *
+ * Recording a zone only reads the clock twice and copies an event into a buffer,
+ * so that traces can be captured from optimized builds without skewing them.
+ * The events stay in memory (in fixed-size chunks, so that the buffer never has
+ * to be copied as it grows) until the capture stops and the trace file is written.
+ * The buffer isn't shared safely between threads, so zones must only be placed
+ * in code that runs on the main thread (not in Jobs).
+ *
+ * @author Noam Chitayat
+ */
+class Tracer
+{
+   /** A completed trace zone. */
+   struct Event
+   {
+      /** The name of the zone. */
+      const char* name;
+
+      /** The time (in clock ticks) when the zone was entered. */
+      double start;
+
+      /** The time (in clock ticks) when the zone was left. */
+      double end;
+   };
+
+   /** The number of events in each chunk of the buffer. */
+   static const unsigned int CHUNK_SIZE = 16384;
+
+   /** The chunk that events are added to. */
+   static Event* chunk;
+
+   /** The number of events in the current chunk. */
+   static unsigned int chunkEvents;
+
+   /** The chunks that were filled before the current one, in order. */
+   static std::vector<Event*> fullChunks;
+
+   /** true iff a trace is being captured. */
+   static bool capturing;
+
+   /**
+    * Start a new chunk, once the current one is full.
+    */
+   static void addChunk();
+
+   /**
+    * @return The system time (in microseconds).
+    */
+   static double getSystemTime();
+
+   public:
+      /**
+       * Start capturing a trace, which replaces any trace already in the file once the capture stops.
+       * Does nothing if a trace is already being captured.
+       *
+       * @param path The path of the trace file.
+       */
+      static void start(const std::string& path);
+
+      /**
+       * Stop capturing the trace, and write the trace file.
+       */
+      static void stop();
+
+      /**
+       * @return true iff a trace is being captured.
+       */
+      static bool isCapturing()
+      {
+         return capturing;
+      }
+
+      /**
+       * @return The current time (in clock ticks) for timing trace zones.
+       */
+      static double now()
+      {
+#ifdef TRACER_USE_TSC
+         return double(__rdtsc());
+#else
+         return getSystemTime();
+#endif
+      }
+
+      /**
+       * Add a completed zone to the trace.
+       *
+       * @param name The name of the zone (a string literal).
+       * @param start The time (in clock ticks) when the zone was entered.
+       * @param end The time (in clock ticks) when the zone was left.
+       */
+      static void record(const char* name, double start, double end)
+      {
+         if(chunkEvents == CHUNK_SIZE)
+         {
+            addChunk();
+         }
+
+         Event& event = chunk[chunkEvents++];
+         event.name = name;
+         event.start = start;
+         event.end = end;
+      }
+};
+
+/**
+ * Adds the time from its construction to its destruction to the trace as a zone,
+ * if a trace is being captured. Use the TRACE_ZONE macro instead of using this class
+ * directly, so that the zones disappear from builds without TRACE_MODE.
+ *
+ * @author Noam Chitayat
+ */
+class TraceZone
+{
+   /** The name of the zone. */
+   const char* name;
+
+   /** The time (in clock ticks) when the zone was entered, or a negative time if no trace is being captured. */
+   double start;
+
+   public:
+      /**
+       * Constructor. Enters the zone.
+       *
+       * @param name The name of the zone (a string literal).
+       */
+      TraceZone(const char* name) : name(name), start(Tracer::isCapturing() ? Tracer::now() : -1.0)
+      {
+      }
+
+      /**
+       * Destructor. Leaves the zone.
+       */
+      ~TraceZone()
+      {
+         // Zones that were entered before the capture started are left out
+         if(start >= 0.0 && Tracer::isCapturing())
+         {
+            Tracer::record(name, start, Tracer::now());
+         }
+      }
+};
+
+#endif
@@ -0,0 +1,308 @@
+/*
+ *  This file is covered by the Ruby license. See LICENSE.txt for more details.
+ *
+ *  Copyright (C) 2007-2012 Noam Chitayat. All rights reserved.
+ */
+
+#include "DistanceFieldFont.h"
+#include "SDL_ttf.h"
+#include "SDL_opengl.h"
+
+#include "guichan/exception.hpp"
+#include "guichan/opengl/openglgraphics.hpp"
+
+#include <algorithm>
+#include <math.h>
+
+#include "DebugUtils.h"
+
+const int debugFlag = DEBUG_EDWT;
+
+namespace edwt
+{
+   std::map<std::string, DistanceFieldFont::Face*> DistanceFieldFont::faces;
+
+   // Large enough for crisp titles, small enough to keep the distance fields cheap to compute
+   const int DistanceFieldFont::REFERENCE_SIZE = 48;
+   const int DistanceFieldFont::SPREAD = 6;
+
+   /**
+    * Compute the signed distance field of a glyph's coverage.
+    * Texels inside the outline get values above 128 and texels outside get
+    * values below 128, scaled so that the spread covers the full range.
+    *
+    * @param inside The coverage of the glyph (one entry per texel, row-major).
+    * @param width The width of the glyph (in texels).
+    * @param height The height of the glyph (in texels).
+    * @param spread The distance (in texels) covered by the field on either side of the outline.
+    * @param field The distance field to fill (one byte per texel, row-major).
+    */
+   static void computeDistanceField(const std::vector<bool>& inside, int width, int height, int spread, std::vector<unsigned char>& field)
+   {
+      const int maxDistanceSquared = spread * spread;
+
+      for(int y = 0; y < height; ++y)
+      {
+         for(int x = 0; x < width; ++x)
+         {
+            const bool texelInside = inside[y * width + x];
+
+            // Find the nearest texel on the other side of the outline within the spread
+            int nearestSquared = maxDistanceSquared;
+            for(int dy = -spread; dy <= spread; ++dy)
+            {
+               const int sampleY = y + dy;
+               if(sampleY < 0 || sampleY >= height || dy * dy >= nearestSquared) continue;
+
+               for(int dx = -spread; dx <= spread; ++dx)
+               {
+                  const int sampleX = x + dx;
+                  if(sampleX < 0 || sampleX >= width) continue;
+
+                  const int distanceSquared = dx * dx + dy * dy;
+                  if(distanceSquared < nearestSquared && inside[sampleY * width + sampleX] != texelInside)
+                  {
+                     nearestSquared = distanceSquared;
+                  }
+               }
+            }
+
+            // The outline lies halfway between the two texel centers
+            float distance = sqrtf(float(nearestSquared)) - 0.5f;
+            if(!texelInside)
+            {
+               distance = -distance;
+            }
+
+            const float value = 128.0f + distance * 127.0f / spread;
+            field[y * width + x] = (unsigned char)std::max(0.0f, std::min(255.0f, value));
+         }
+      }
+   }
+
+   DistanceFieldFont::Face::Face() : font(NULL), references(0), atlas(true)
+   {
+      for(int i = 0; i < 256; ++i)
+      {
+         glyphs[i].measured = false;
+         glyphs[i].rasterized = false;
+      }
+   }
+
+   DistanceFieldFont::DistanceFieldFont(const std::string& filename, int size)
+      : filename(filename), scale(float(size) / REFERENCE_SIZE)
+   {
+      std::map<std::string, Face*>::iterator iter = faces.find(filename);
+      if(iter != faces.end())
+      {
+         face = iter->second;
+      }
+      else
+      {
+         TTF_Font* font = TTF_OpenFont(filename.c_str(), REFERENCE_SIZE);
+         if(font == NULL)
+         {
+            throw GCN_EXCEPTION("DistanceFieldFont::DistanceFieldFont. " + std::string(TTF_GetError()));
+         }
+
+         DEBUG("Loaded distance field face %s.", filename.c_str());
+         face = new Face();
+         face->font = font;
+         faces[filename] = face;
+      }
+
+      ++face->references;
+   }
+
+   const DistanceFieldFont::Glyph& DistanceFieldFont::getGlyph(unsigned char character) const
+   {
+      Glyph& glyph = face->glyphs[character];
+      if(!glyph.measured)
+      {
+         int minY, maxY;
+         if(TTF_GlyphMetrics(face->font, character, &glyph.minX, &glyph.maxX, &minY, &maxY, &glyph.advance) != 0)
+         {
+            DEBUG("No glyph metrics for character %d.", character);
+            glyph.minX = glyph.maxX = glyph.advance = 0;
+         }
+
+         glyph.measured = true;
+      }
+
+      return glyph;
+   }
+
+   const DistanceFieldFont::Glyph& DistanceFieldFont::getRasterizedGlyph(unsigned char character)
+   {
+      Glyph& glyph = face->glyphs[character];
+      getGlyph(character);
+
+      if(!glyph.rasterized)
+      {
+         const char glyphText[] = { char(character), '\0' };
+         SDL_Color white = { 255, 255, 255, 0 };
+         SDL_Surface* glyphSurface = TTF_RenderText_Blended(face->font, glyphText, white);
+
+         int glyphWidth = 0;
+         int glyphHeight = 0;
+         if(glyphSurface != NULL)
+         {
+            glyphWidth = glyphSurface->w;
+            glyphHeight = glyphSurface->h;
+         }
+
+         // Pad the glyph so that the field can fall off outside of the outline
+         glyph.width = glyphWidth + 2 * SPREAD;
+         glyph.height = glyphHeight + 2 * SPREAD;
+
+         std::vector<bool> inside(glyph.width * glyph.height, false);
+         if(glyphSurface != NULL)
+         {
+            SDL_LockSurface(glyphSurface);
+            const SDL_PixelFormat* format = glyphSurface->format;
+            for(int y = 0; y < glyphHeight; ++y)
+            {
+               const Uint32* row = (const Uint32*)((const Uint8*)glyphSurface->pixels + y * glyphSurface->pitch);
+               for(int x = 0; x < glyphWidth; ++x)
+               {
+                  const Uint8 alpha = (row[x] & format->Amask) >> format->Ashift;
+                  inside[(y + SPREAD) * glyph.width + x + SPREAD] = alpha >= 128;
+               }
+            }
+            SDL_UnlockSurface(glyphSurface);
+            SDL_FreeSurface(glyphSurface);
+         }
+
+         std::vector<unsigned char> field(glyph.width * glyph.height);
+         computeDistanceField(inside, glyph.width, glyph.height, SPREAD, field);
+
+         glyph.region = face->atlas.add(glyph.width, glyph.height, &field[0]);
+         glyph.rasterized = true;
+      }
+
+      return glyph;
+   }
+
+   int DistanceFieldFont::getWidth(const std::string& text) const
+   {
+      // Measure at the reference size the same way that SDL_ttf does, then scale
+      int penX = 0;
+      int minX = 0;
+      int maxX = 0;
+
+      for(std::string::size_type i = 0; i < text.size(); ++i)
+      {
+         const Glyph& glyph = getGlyph(text[i]);
+         minX = std::min(minX, penX + glyph.minX);
+         maxX = std::max(maxX, penX + std::max(glyph.advance, glyph.maxX));
+         penX += glyph.advance;
+      }
+
+      return int(ceilf((maxX - minX) * scale));
+   }
+
+   int DistanceFieldFont::getHeight() const
+   {
+      return int(ceilf(TTF_FontHeight(face->font) * scale));
+   }
+
+   void DistanceFieldFont::drawString(gcn::Graphics* graphics, const std::string& text, int x, int y)
+   {
+      if(text.empty()) return;
+
+      gcn::OpenGLGraphics* openGlGraphics = dynamic_cast<gcn::OpenGLGraphics*>(graphics);
+      if(openGlGraphics == NULL)
+      {
+         throw GCN_EXCEPTION("DistanceFieldFont::drawString. Graphics object not an OpenGL graphics object!");
+      }
+
+      // Lay out the quads at the reference size; they are scaled as they are drawn
+      const float top = float(-SPREAD);
+      const float bottom = float(TTF_FontHeight(face->font) + SPREAD);
+      int penX = -std::min(0, getGlyph(text[0]).minX);
+
+      for(std::string::size_type i = 0; i < text.size(); ++i)
+      {
+         const Glyph& glyph = getRasterizedGlyph(text[i]);
+
+         const float left = float(penX + std::min(0, glyph.minX) - SPREAD);
+         const float right = left + glyph.width;
+         const GlyphAtlas::Region& region = glyph.region;
+
+         const float quadVertices[] = { left, top, right, top, right, bottom, left, bottom };
+         const float quadTexCoords[] = { region.left, region.top, region.right, region.top,
+                                         region.right, region.bottom, region.left, region.bottom };
+
+         vertices.insert(vertices.end(), quadVertices, quadVertices + 8);
+         texCoords.insert(texCoords.end(), quadTexCoords, quadTexCoords + 8);
+
+         if(runs.empty() || runs.back().texture != region.texture)
+         {
+            Run newRun;
+            newRun.texture = region.texture;
+            newRun.numQuads = 0;
+            runs.push_back(newRun);
+         }
+
+         ++runs.back().numQuads;
+         penX += glyph.advance;
+      }
+
+      const gcn::ClipRectangle& clipArea = openGlGraphics->getCurrentClipArea();
+
+      glMatrixMode(GL_MODELVIEW);
+      glPushMatrix();
+      glTranslatef(float(x + clipArea.xOffset), float(y + clipArea.yOffset), 0.0f);
+      glScalef(scale, scale, 1.0f);
+
+      // Texels past the middle of the field are inside the outline. Alpha testing
+      // (rather than blending) keeps the outline sharp at any scale.
+      const gcn::Color col = openGlGraphics->getColor();
+      glPushAttrib(GL_COLOR_BUFFER_BIT);
+      glDisable(GL_BLEND);
+      glEnable(GL_ALPHA_TEST);
+      glAlphaFunc(GL_GREATER, 0.5f);
+      glColor4ub(col.r, col.g, col.b, 255);
+      glTexEnvf(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
+      glEnable(GL_TEXTURE_2D);
+
+      glPushClientAttrib(GL_CLIENT_VERTEX_ARRAY_BIT);
+      glEnableClientState(GL_VERTEX_ARRAY);
+      glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+      glVertexPointer(2, GL_FLOAT, 0, &vertices[0]);
+      glTexCoordPointer(2, GL_FLOAT, 0, &texCoords[0]);
+
+      unsigned int firstQuad = 0;
+      for(std::vector<Run>::const_iterator iter = runs.begin(); iter != runs.end(); ++iter)
+      {
+         glBindTexture(GL_TEXTURE_2D, iter->texture);
+         glDrawArrays(GL_QUADS, firstQuad * 4, iter->numQuads * 4);
+         firstQuad += iter->numQuads;
+      }
+
+      glPopClientAttrib();
+
+      glDisable(GL_TEXTURE_2D);
+      glTexEnvf(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_REPLACE);
+      glColor4ub(col.r, col.g, col.b, col.a);
+      glPopAttrib();
+
+      glPopMatrix();
+
+      // Clearing keeps the capacity, so drawing text stops allocating once it is warmed up
+      vertices.clear();
+      texCoords.clear();
+      runs.clear();
+   }
+
+   DistanceFieldFont::~DistanceFieldFont()
+   {
+      if(--face->references == 0)
+      {
+         DEBUG("Unloading distance field face %s.", filename.c_str());
+         TTF_CloseFont(face->font);
+         faces.erase(filename);
+         delete face;
+      }
+   }
+};
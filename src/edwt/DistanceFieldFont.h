@@ -0,0 +1,159 @@
+/*
+ *  This file is covered by the Ruby license. See LICENSE.txt for more details.
+ *
+ *  Copyright (C) 2007-2012 Noam Chitayat. All rights reserved.
+ */
+
+#ifndef DISTANCE_FIELD_FONT_H
+#define DISTANCE_FIELD_FONT_H
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "guichan/font.hpp"
+#include "GlyphAtlas.h"
+
+typedef struct _TTF_Font TTF_Font;
+
+namespace edwt
+{
+   /**
+    * A True Type Font that can be drawn at any size from a single set of glyphs.
+    * Each glyph is rasterized once at a reference size and stored as a signed
+    * distance field, in which every texel holds its distance to the glyph's outline.
+    * When a glyph is drawn scaled with linear filtering, an alpha test on the
+    * distance field recovers a sharp outline at any size. Only the
+    * fixed-function pipeline is used, so software OpenGL renders it as well.
+    *
+    * All the fonts loaded from the same file share the same glyphs, so the
+    * memory used for glyph textures does not grow with the number of sizes.
+    *
+    * NOTE: You must initialize the SDL_ttf library before using this class.
+    *
+    * @author Noam Chitayat
+    */
+   class DistanceFieldFont : public gcn::Font
+   {
+      /** The distance field and reference metrics of a glyph. */
+      struct Glyph
+      {
+         /** true iff the metrics of the glyph have been loaded. */
+         bool measured;
+
+         /** true iff the glyph's distance field has been added to the atlas. */
+         bool rasterized;
+
+         /** The leftmost extent of the glyph, relative to the pen position. */
+         int minX;
+
+         /** The rightmost extent of the glyph, relative to the pen position. */
+         int maxX;
+
+         /** The distance to move the pen after the glyph. */
+         int advance;
+
+         /** The width of the glyph's distance field (including the padding). */
+         int width;
+
+         /** The height of the glyph's distance field (including the padding). */
+         int height;
+
+         /** The location of the glyph's distance field in the atlas. */
+         GlyphAtlas::Region region;
+      };
+
+      /** A sequence of consecutive glyph quads drawn from the same atlas page. */
+      struct Run
+      {
+         /** The atlas page to draw the quads with. */
+         GLuint texture;
+
+         /** The number of quads in the run. */
+         unsigned int numQuads;
+      };
+
+      /** The glyphs of a font file, shared by all the fonts loaded from the file. */
+      struct Face
+      {
+         /** The font file, opened at the reference size. */
+         TTF_Font* font;
+
+         /** The number of fonts using the face. */
+         int references;
+
+         /** The glyphs of the face, indexed by (Latin-1) character. */
+         Glyph glyphs[256];
+
+         /** The distance fields of the glyphs. */
+         GlyphAtlas atlas;
+
+         /**
+          * Constructor.
+          */
+         Face();
+      };
+
+      /** The faces that are in use, keyed by font file name. */
+      static std::map<std::string, Face*> faces;
+
+      /** The size (in points) that glyphs are rasterized at. */
+      static const int REFERENCE_SIZE;
+
+      /** The distance (in pixels at the reference size) covered by the distance fields on either side of an outline. */
+      static const int SPREAD;
+
+      /** The font file the glyphs were loaded from. */
+      std::string filename;
+
+      /** The glyphs of the font file. */
+      Face* face;
+
+      /** The ratio between the size of this font and the reference size. */
+      float scale;
+
+      /** The vertex coordinates of the string being drawn (4 vertices per glyph). */
+      std::vector<float> vertices;
+
+      /** The texture coordinates of the string being drawn, parallel to the vertex coordinates. */
+      std::vector<float> texCoords;
+
+      /** The atlas page runs of the string being drawn. */
+      std::vector<Run> runs;
+
+      /**
+       * @param character The character to look up.
+       *
+       * @return The glyph of the character, with its reference metrics loaded.
+       */
+      const Glyph& getGlyph(unsigned char character) const;
+
+      /**
+       * @param character The character to look up.
+       *
+       * @return The glyph of the character, with its distance field in the atlas.
+       */
+      const Glyph& getRasterizedGlyph(unsigned char character);
+
+      public:
+         /**
+          * Constructor.
+          *
+          * @param filename The filename of the True Type Font.
+          * @param size The size (in points) to draw the font at.
+          */
+         DistanceFieldFont(const std::string& filename, int size);
+
+         // Inherited from Font
+         virtual int getWidth(const std::string& text) const;
+         virtual int getHeight() const;
+         virtual void drawString(gcn::Graphics* graphics, const std::string& text, int x, int y);
+
+         /**
+          * Destructor.
+          */
+         virtual ~DistanceFieldFont();
+   };
+};
+
+#endif
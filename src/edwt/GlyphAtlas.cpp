@@ -0,0 +1,115 @@
+/*
+ *  This file is covered by the Ruby license. See LICENSE.txt for more details.
+ *
+ *  Copyright (C) 2007-2012 Noam Chitayat. All rights reserved.
+ */
+
+#include "GlyphAtlas.h"
+#include "SDL_opengl.h"
+
+#include "DebugUtils.h"
+
+const int debugFlag = DEBUG_EDWT;
+
+namespace edwt
+{
+   const int GlyphAtlas::PAGE_SIZE = 512;
+
+   GlyphAtlas::GlyphAtlas(bool smooth) : shelfX(0), shelfY(0), shelfHeight(0), smooth(smooth)
+   {
+   }
+
+   void GlyphAtlas::addPage()
+   {
+      GLuint texture;
+      glGenTextures(1, &texture);
+      glBindTexture(GL_TEXTURE_2D, texture);
+
+      // Unless they are scaled, glyphs are drawn pixel for pixel, so no filtering is needed
+      const GLint filter = smooth ? GL_LINEAR : GL_NEAREST;
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter);
+      glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
+
+      const std::vector<unsigned char> transparent(PAGE_SIZE * PAGE_SIZE, 0);
+      glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+      glTexImage2D(GL_TEXTURE_2D, 0, GL_ALPHA, PAGE_SIZE, PAGE_SIZE, 0, GL_ALPHA, GL_UNSIGNED_BYTE, &transparent[0]);
+      glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+      pages.push_back(texture);
+      shelfX = 0;
+      shelfY = 0;
+      shelfHeight = 0;
+
+      DEBUG("Added glyph atlas page %d.", (int)pages.size());
+   }
+
+   GlyphAtlas::Region GlyphAtlas::add(int width, int height, const unsigned char* alpha)
+   {
+      if(width > PAGE_SIZE || height > PAGE_SIZE)
+      {
+         T_T("Image is too large for the glyph atlas.");
+      }
+
+      // Leave a pixel of padding between images so that they never bleed into each other
+      if(!pages.empty() && shelfX + width > PAGE_SIZE)
+      {
+         shelfY += shelfHeight + 1;
+         shelfX = 0;
+         shelfHeight = 0;
+      }
+
+      if(pages.empty() || shelfY + height > PAGE_SIZE)
+      {
+         addPage();
+      }
+      else
+      {
+         glBindTexture(GL_TEXTURE_2D, pages.back());
+      }
+
+      if(width > 0 && height > 0)
+      {
+         glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+         glTexSubImage2D(GL_TEXTURE_2D, 0, shelfX, shelfY, width, height, GL_ALPHA, GL_UNSIGNED_BYTE, alpha);
+         glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+      }
+
+      Region region;
+      region.texture = pages.back();
+      region.left = float(shelfX) / PAGE_SIZE;
+      region.top = float(shelfY) / PAGE_SIZE;
+      region.right = float(shelfX + width) / PAGE_SIZE;
+      region.bottom = float(shelfY + height) / PAGE_SIZE;
+
+      shelfX += width + 1;
+      if(height > shelfHeight)
+      {
+         shelfHeight = height;
+      }
+
+      return region;
+   }
+
+   void GlyphAtlas::clear()
+   {
+      if(!pages.empty())
+      {
+         glDeleteTextures(pages.size(), &pages[0]);
+         pages.clear();
+      }
+
+      shelfX = 0;
+      shelfY = 0;
+      shelfHeight = 0;
+   }
+
+   unsigned int GlyphAtlas::getPageCount() const
+   {
+      return pages.size();
+   }
+
+   GlyphAtlas::~GlyphAtlas()
+   {
+      clear();
+   }
+};
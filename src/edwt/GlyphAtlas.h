@@ -0,0 +1,110 @@
+/*
+ *  This file is covered by the Ruby license. See LICENSE.txt for more details.
+ *
+ *  Copyright (C) 2007-2012 Noam Chitayat. All rights reserved.
+ */
+
+#ifndef GLYPH_ATLAS_H
+#define GLYPH_ATLAS_H
+
+#include <vector>
+
+typedef unsigned int GLuint;
+
+namespace edwt
+{
+   /**
+    * Packs small alpha-only images (such as rasterized font glyphs) into
+    * shared textures, so that a whole string can be drawn from a handful
+    * of textures instead of uploading a new texture per string.
+    * Images are packed left to right in rows ("shelves") of equal height;
+    * once a texture page is full, a new page is started.
+    * Pages are either sampled pixel for pixel, or smoothly (for images that
+    * are drawn scaled).
+    *
+    * @author Noam Chitayat
+    */
+   class GlyphAtlas
+   {
+      public:
+         /** The location of a packed image inside the atlas. */
+         struct Region
+         {
+            /** The texture page holding the image. */
+            GLuint texture;
+
+            /** The texture coordinates of the image's left edge. */
+            float left;
+
+            /** The texture coordinates of the image's top edge. */
+            float top;
+
+            /** The texture coordinates of the image's right edge. */
+            float right;
+
+            /** The texture coordinates of the image's bottom edge. */
+            float bottom;
+         };
+
+      private:
+         /** The width and height (in pixels) of each texture page. */
+         static const int PAGE_SIZE;
+
+         /** The texture pages of the atlas. */
+         std::vector<GLuint> pages;
+
+         /** The x-location to pack the next image at on the current shelf. */
+         int shelfX;
+
+         /** The y-location of the current shelf. */
+         int shelfY;
+
+         /** The height of the tallest image on the current shelf. */
+         int shelfHeight;
+
+         /** true iff the pages are sampled with linear filtering. */
+         bool smooth;
+
+         /**
+          * Create a new, fully transparent texture page and start packing into it.
+          */
+         void addPage();
+
+      public:
+         /**
+          * Constructor. Texture pages are only created once images are added.
+          *
+          * @param smooth true iff the pages should be sampled with linear filtering
+          *               (for images that are drawn scaled).
+          */
+         GlyphAtlas(bool smooth = false);
+
+         /**
+          * Pack an image into the atlas.
+          *
+          * @param width The width of the image (in pixels).
+          * @param height The height of the image (in pixels).
+          * @param alpha The alpha values of the image, one byte per pixel, in row-major order.
+          *
+          * @return The location of the image in the atlas.
+          */
+         Region add(int width, int height, const unsigned char* alpha);
+
+         /**
+          * Remove all the images from the atlas and free its textures.
+          */
+         void clear();
+
+         /**
+          * @return The number of texture pages in use.
+          */
+         unsigned int getPageCount() const;
+
+         /**
+          * Destructor.
+          */
+         ~GlyphAtlas();
+   };
+};
+
+#endif
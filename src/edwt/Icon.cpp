@@ -39,5 +39,6 @@ namespace edwt
         mImage = NULL;
         mInternalImage = false;
         setSize(0, 0);
+        markDirty();
    }
 };
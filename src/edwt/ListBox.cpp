@@ -8,6 +8,7 @@
 #include "StringListModel.h"
 #include "Sound.h"
 #include <sstream>
+#include <algorithm>
 
 #include "DebugUtils.h"
 const int debugFlag = DEBUG_EDWT;
@@ -103,6 +104,7 @@ namespace edwt
       else
       {
          mColumnAlignments[column] = alignment;
+         markDirty();
       }
    }
    
@@ -151,7 +153,17 @@ namespace edwt
       gcn::Color base = getBaseColor();
       graphics->setColor(base);
 
-      for (i = 0; i < mListModel->getNumberOfElements(); ++i)
+      // Only draw the rows that can be seen through the clip area (such as a scroll area's view),
+      // so that the cost of drawing doesn't grow with the length of the list
+      const gcn::ClipRectangle& clipArea = graphics->getCurrentClipArea();
+      const int clipTop = clipArea.y - clipArea.yOffset;
+      const int clipBottom = clipTop + clipArea.height;
+
+      const int firstRow = std::max(0, (clipTop - y) / fontHeight);
+      const int endRow = std::min(mListModel->getNumberOfElements(), (clipBottom - y) / fontHeight + 1);
+      y += firstRow * fontHeight;
+
+      for (i = firstRow; i < endRow; ++i)
       {
          int columnBeginning = 0;
          std::string elementText = mListModel->getElementAt(i);
@@ -216,6 +228,7 @@ namespace edwt
    void ListBox::setRowPadding(unsigned int padding)
    {
       mRowPadding = padding;
+      markDirty();
    }
    
    unsigned int ListBox::getColumnPadding() const
@@ -226,6 +239,7 @@ namespace edwt
    void ListBox::setColumnPadding(unsigned int padding)
    {
       mColumnPadding = padding;
+      markDirty();
    }
 
    bool ListBox::isOpaque()
@@ -236,6 +250,7 @@ namespace edwt
    void ListBox::setOpaque(bool opaque)
    {
       mOpaque = opaque;
+      markDirty();
    }
 
    void ListBox::adjustWidth()
@@ -292,6 +307,9 @@ namespace edwt
 
       // Set the new total list box width
       setWidth(maxWidth);
+
+      // The columns may have moved even if the total width stayed the same
+      markDirty();
    }
    
    void ListBox::mouseMoved(gcn::MouseEvent& mouseEvent)
@@ -310,6 +328,7 @@ namespace edwt
    void ListBox::setHighlightColor(const gcn::Color& color)
    {
       highlightColor = color;
+      markDirty();
    }
    
    const gcn::Color& ListBox::getHighlightColor() const
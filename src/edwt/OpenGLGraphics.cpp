@@ -0,0 +1,58 @@
+/*
+ *  This file is covered by the Ruby license. See LICENSE.txt for more details.
+ *
+ *  Copyright (C) 2007-2012 Noam Chitayat. All rights reserved.
+ */
+
+#include "OpenGLGraphics.h"
+#include <SDL.h>
+#include "SDL_opengl.h"
+
+#include "DebugUtils.h"
+
+const int debugFlag = DEBUG_EDWT;
+
+static bool extensionLoaded = false;
+static PFNGLBLENDFUNCSEPARATEPROC blendFuncSeparate = NULL;
+
+namespace edwt
+{
+   bool OpenGLGraphics::isPremultipliedAlphaSupported()
+   {
+      if(!extensionLoaded)
+      {
+         extensionLoaded = true;
+
+         // The separate blend function is core in OpenGL 1.4, but older drivers only offer the extension
+         blendFuncSeparate = (PFNGLBLENDFUNCSEPARATEPROC)SDL_GL_GetProcAddress("glBlendFuncSeparate");
+         if(blendFuncSeparate == NULL)
+         {
+            blendFuncSeparate = (PFNGLBLENDFUNCSEPARATEPROC)SDL_GL_GetProcAddress("glBlendFuncSeparateEXT");
+         }
+
+         DEBUG("Premultiplied alpha GUI drawing %s.", blendFuncSeparate != NULL ? "enabled" : "disabled");
+      }
+
+      return blendFuncSeparate != NULL;
+   }
+
+   OpenGLGraphics::OpenGLGraphics() : premultipliedAlpha(false)
+   {
+   }
+
+   void OpenGLGraphics::setPremultipliedAlpha(bool enabled)
+   {
+      premultipliedAlpha = enabled;
+   }
+
+   void OpenGLGraphics::_beginDraw()
+   {
+      gcn::OpenGLGraphics::_beginDraw();
+
+      if(premultipliedAlpha)
+      {
+         // Blend colors as Guichan does, but let the destination alpha build up to the total coverage
+         blendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+      }
+   }
+};
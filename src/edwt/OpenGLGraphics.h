@@ -0,0 +1,58 @@
+/*
+ *  This file is covered by the Ruby license. See LICENSE.txt for more details.
+ *
+ *  Copyright (C) 2007-2012 Noam Chitayat. All rights reserved.
+ */
+
+#ifndef OPENGL_GRAPHICS_H
+#define OPENGL_GRAPHICS_H
+
+#include "guichan/opengl/openglgraphics.hpp"
+
+namespace edwt
+{
+   /**
+    * Extends the Guichan OpenGL graphics driver so that the GUI can be drawn
+    * into a texture and later drawn over the screen.
+    *
+    * When the GUI is drawn straight to the screen, the alpha that is written
+    * does not matter. When it is drawn into a texture, the texture's alpha has
+    * to record how much of the screen each pixel covers. In premultiplied alpha
+    * mode, blended colors are accumulated the usual way, while their alphas are
+    * accumulated so that the texture can be drawn with glBlendFunc(GL_ONE,
+    * GL_ONE_MINUS_SRC_ALPHA) and look exactly like the GUI drawn to the screen.
+    *
+    * @author Noam Chitayat
+    */
+   class OpenGLGraphics : public gcn::OpenGLGraphics
+   {
+      /** true iff the alpha channel is accumulated for drawing into a texture. */
+      bool premultipliedAlpha;
+
+      public:
+         /**
+          * Loads the separate blend function, if it hasn't been loaded yet.
+          *
+          * @return true iff the OpenGL implementation supports premultiplied alpha mode.
+          */
+         static bool isPremultipliedAlphaSupported();
+
+         /**
+          * Constructor.
+          */
+         OpenGLGraphics();
+
+         /**
+          * Enable or disable premultiplied alpha mode. Premultiplied alpha mode
+          * must only be enabled if isPremultipliedAlphaSupported() returns true.
+          *
+          * @param enabled true iff the GUI is being drawn into a texture.
+          */
+         void setPremultipliedAlpha(bool enabled);
+
+         // Inherited from gcn::OpenGLGraphics
+         virtual void _beginDraw();
+   };
+};
+
+#endif
@@ -74,7 +74,9 @@
 #include "guichan/platform.hpp"
 
 #include "guichan/opengl/openglgraphics.hpp"
-#include "guichan/opengl/openglimage.hpp"
+#include "SDL_opengl.h"
+
+#include <algorithm>
 
 #include "DebugUtils.h"
 
@@ -82,14 +84,42 @@ const int debugFlag = DEBUG_EDWT;
 
 namespace edwt
 {
+   // Enough for a few hundred typical labels per font
+   const unsigned int OpenGLTrueTypeFont::TEXT_RUN_BUDGET = 256 * 1024;
+
+   // About 5 seconds at 60 frames per second
+   const unsigned int OpenGLTrueTypeFont::TEXT_RUN_MAX_IDLE_FRAMES = 300;
+
+   // About 10 seconds at 60 frames per second
+   const unsigned int OpenGLTrueTypeFont::TEXT_RUN_REPORT_FRAMES = 600;
+
+   unsigned int OpenGLTrueTypeFont::sFrame = 0;
+
+   void OpenGLTrueTypeFont::finishFrame()
+   {
+      ++sFrame;
+   }
+
    OpenGLTrueTypeFont::OpenGLTrueTypeFont (const std::string& filename, int size)
    {
+      mTextRunBytes = 0;
+      mLastEvictionFrame = sFrame;
+      mLastReportFrame = sFrame;
+      mTextRunHits = 0;
+      mTextRunMisses = 0;
+
       mRowSpacing = 0;
       mGlyphSpacing = 0;
       mAntiAlias = true;        
       mFilename = filename;
       mFont = NULL;
 
+      for(int i = 0; i < 256; ++i)
+      {
+         mGlyphs[i].measured = false;
+         mGlyphs[i].rasterized = false;
+      }
+
       mFont = TTF_OpenFont(filename.c_str(), size);
 
       if (mFont == NULL)
@@ -100,15 +130,127 @@ namespace edwt
     
    OpenGLTrueTypeFont::~OpenGLTrueTypeFont()
    {
+      clearTextRuns();
       TTF_CloseFont(mFont);
    }
   
-   int OpenGLTrueTypeFont::getWidth(const std::string& text) const
+   const OpenGLTrueTypeFont::Glyph& OpenGLTrueTypeFont::getGlyph(unsigned char character) const
    {
-      int w, h;
-      TTF_SizeText(mFont, text.c_str(), &w, &h);
+      Glyph& glyph = mGlyphs[character];
+      if(!glyph.measured)
+      {
+         int minY, maxY;
+         if(TTF_GlyphMetrics(mFont, character, &glyph.minX, &glyph.maxX, &minY, &maxY, &glyph.advance) != 0)
+         {
+            DEBUG("No glyph metrics for character %d.", character);
+            glyph.minX = glyph.maxX = glyph.advance = 0;
+         }
 
-      return w;
+         glyph.measured = true;
+      }
+
+      return glyph;
+   }
+
+   const OpenGLTrueTypeFont::Glyph& OpenGLTrueTypeFont::getRasterizedGlyph(unsigned char character)
+   {
+      Glyph& glyph = mGlyphs[character];
+      getGlyph(character);
+
+      if(!glyph.rasterized)
+      {
+         // The glyph is rendered in white; the text color is applied when it is drawn
+         const char glyphText[] = { char(character), '\0' };
+         SDL_Color white = { 255, 255, 255, 0 };
+         SDL_Surface* glyphSurface = TTF_RenderText_Blended(mFont, glyphText, white);
+
+         int width = 0;
+         int height = 0;
+         std::vector<unsigned char> alpha(1, 0);
+
+         if(glyphSurface != NULL)
+         {
+            width = glyphSurface->w;
+            height = glyphSurface->h;
+            alpha.resize(width * height + 1);
+
+            SDL_LockSurface(glyphSurface);
+            const SDL_PixelFormat* format = glyphSurface->format;
+            for(int y = 0; y < height; ++y)
+            {
+               const Uint32* row = (const Uint32*)((const Uint8*)glyphSurface->pixels + y * glyphSurface->pitch);
+               for(int x = 0; x < width; ++x)
+               {
+                  Uint8 pixelAlpha = (row[x] & format->Amask) >> format->Ashift;
+
+                  // Without anti-aliasing, a pixel is either fully drawn or not at all
+                  if(!mAntiAlias)
+                  {
+                     pixelAlpha = pixelAlpha >= 128 ? 255 : 0;
+                  }
+
+                  alpha[y * width + x] = pixelAlpha;
+               }
+            }
+            SDL_UnlockSurface(glyphSurface);
+            SDL_FreeSurface(glyphSurface);
+         }
+
+         glyph.width = width;
+         glyph.region = mAtlas.add(width, height, &alpha[0]);
+         glyph.rasterized = true;
+      }
+
+      return glyph;
+   }
+
+   int OpenGLTrueTypeFont::getKerning(unsigned char previous, unsigned char next) const
+   {
+      const unsigned short pair = (previous << 8) | next;
+      std::map<unsigned short, int>::const_iterator iter = mKerning.find(pair);
+      if(iter != mKerning.end())
+      {
+         return iter->second;
+      }
+
+      // SDL_ttf does not expose kerning, so it is recovered from the difference between
+      // the width SDL_ttf measures for the pair and the width without kerning
+      const char pairText[] = { char(previous), char(next), '\0' };
+      int pairWidth, pairHeight;
+      TTF_SizeText(mFont, pairText, &pairWidth, &pairHeight);
+
+      const int kerning = pairWidth - measureWidth(pairText, false);
+      mKerning[pair] = kerning;
+      return kerning;
+   }
+
+   int OpenGLTrueTypeFont::measureWidth(const std::string& text, bool useKerning) const
+   {
+      int penX = 0;
+      int minX = 0;
+      int maxX = 0;
+
+      for(std::string::size_type i = 0; i < text.size(); ++i)
+      {
+         const unsigned char character = text[i];
+         const Glyph& glyph = getGlyph(character);
+
+         if(useKerning && i > 0)
+         {
+            penX += getKerning(text[i - 1], character);
+         }
+
+         minX = std::min(minX, penX + glyph.minX);
+         maxX = std::max(maxX, penX + std::max(glyph.advance, glyph.maxX));
+         penX += glyph.advance;
+      }
+
+      return maxX - minX;
+   }
+
+   int OpenGLTrueTypeFont::getWidth(const std::string& text) const
+   {
+      return measureWidth(text, true);
    }
 
    int OpenGLTrueTypeFont::getHeight() const
@@ -118,7 +260,12 @@ namespace edwt
     
    void OpenGLTrueTypeFont::drawString(gcn::Graphics* graphics, const std::string& text, const int x, const int y)
    {
-      if (text == "") return;
+      drawStringPrefix(graphics, text, x, y, text.size());
+   }
+
+   void OpenGLTrueTypeFont::drawStringPrefix(gcn::Graphics* graphics, const std::string& text, int x, int y, unsigned int numCharacters)
+   {
+      if (text == "" || numCharacters == 0) return;
 
       gcn::OpenGLGraphics *openGlGraphics = dynamic_cast<gcn::OpenGLGraphics *>(graphics);
 
@@ -128,33 +275,173 @@ namespace edwt
          return;
       }
         
+      const TextRun& textRun = getTextRun(text);
+      const gcn::ClipRectangle& clipArea = openGlGraphics->getCurrentClipArea();
+
       // This is needed for drawing the Glyph in the middle if we have spacing
       int yoffset = getRowSpacing() / 2;
-        
+
+      glMatrixMode(GL_MODELVIEW);
+      glPushMatrix();
+      glTranslatef(float(x + clipArea.xOffset), float(y + yoffset + clipArea.yOffset), 0.0f);
+
+      // The atlas only holds coverage, so the glyphs take their color from the
+      // current color (at full opacity, as the glyphs were before the atlas).
+      // The texture environment and enables are restored by the graphics object
+      // when it finishes drawing, but later drawing in this frame relies on them.
       gcn::Color col = openGlGraphics->getColor();
+      glColor4ub(col.r, col.g, col.b, 255);
+      glTexEnvf(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
+      glEnable(GL_TEXTURE_2D);
+      glEnable(GL_BLEND);
+
+      glPushClientAttrib(GL_CLIENT_VERTEX_ARRAY_BIT);
+      glEnableClientState(GL_VERTEX_ARRAY);
+      glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+      glVertexPointer(2, GL_FLOAT, 0, &textRun.vertices[0]);
+      glTexCoordPointer(2, GL_FLOAT, 0, &textRun.texCoords[0]);
+
+      // Each character has exactly one quad, so the prefix is the first numCharacters quads
+      unsigned int firstQuad = 0;
+      for(std::vector<Run>::const_iterator iter = textRun.runs.begin(); iter != textRun.runs.end() && firstQuad < numCharacters; ++iter)
+      {
+         const unsigned int numQuads = std::min(iter->numQuads, numCharacters - firstQuad);
+         glBindTexture(GL_TEXTURE_2D, iter->texture);
+         glDrawArrays(GL_QUADS, firstQuad * 4, numQuads * 4);
+         firstQuad += numQuads;
+      }
+
+      glPopClientAttrib();
+
+      glDisable(GL_TEXTURE_2D);
+      if(col.a == 255)
+      {
+         glDisable(GL_BLEND);
+      }
+      glTexEnvf(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_REPLACE);
+      glColor4ub(col.r, col.g, col.b, col.a);
+
+      glPopMatrix();
+   }
+
+   void OpenGLTrueTypeFont::buildTextRun(const std::string& text, TextRun& textRun)
+   {
+      const float top = 0.0f;
+      const float bottom = float(TTF_FontHeight(mFont));
+
+      // Like SDL_ttf, shift the string right if the first glyph reaches left of the pen
+      int penX = -std::min(0, getGlyph(text[0]).minX);
+
+      for(std::string::size_type i = 0; i < text.size(); ++i)
+      {
+         const unsigned char character = text[i];
+         const Glyph& glyph = getRasterizedGlyph(character);
+
+         if(i > 0)
+         {
+            penX += getKerning(text[i - 1], character);
+         }
+
+         const float left = float(penX + std::min(0, glyph.minX));
+         const float right = left + glyph.width;
+         const GlyphAtlas::Region& region = glyph.region;
+
+         const float quadVertices[] = { left, top, right, top, right, bottom, left, bottom };
+         const float quadTexCoords[] = { region.left, region.top, region.right, region.top,
+                                         region.right, region.bottom, region.left, region.bottom };
+
+         textRun.vertices.insert(textRun.vertices.end(), quadVertices, quadVertices + 8);
+         textRun.texCoords.insert(textRun.texCoords.end(), quadTexCoords, quadTexCoords + 8);
+
+         if(textRun.runs.empty() || textRun.runs.back().texture != region.texture)
+         {
+            Run newRun;
+            newRun.texture = region.texture;
+            newRun.numQuads = 0;
+            textRun.runs.push_back(newRun);
+         }
+
+         ++textRun.runs.back().numQuads;
+         penX += glyph.advance;
+      }
+
+      textRun.bytes = sizeof(TextRun) + text.size()
+            + (textRun.vertices.size() + textRun.texCoords.size()) * sizeof(float)
+            + textRun.runs.size() * sizeof(Run);
+   }
 
-      SDL_Color sdlCol;
-      sdlCol.r = col.r;
-      sdlCol.g = col.g;
-      sdlCol.b = col.b;
+   const OpenGLTrueTypeFont::TextRun& OpenGLTrueTypeFont::getTextRun(const std::string& text)
+   {
+      if(mLastEvictionFrame != sFrame)
+      {
+         evictIdleTextRuns();
+      }
 
-      SDL_Surface *textSurface;
-      if (mAntiAlias)
+      TextRunMap::iterator textRun = mTextRuns.find(text);
+      if(textRun != mTextRuns.end())
       {
-         textSurface = TTF_RenderText_Blended(mFont, text.c_str(), sdlCol);
+         ++mTextRunHits;
+         mTextRunUsage.splice(mTextRunUsage.begin(), mTextRunUsage, textRun->second.usagePosition);
       }
       else
       {
-         textSurface = TTF_RenderText_Solid(mFont, text.c_str(), sdlCol);
+         ++mTextRunMisses;
+         textRun = mTextRuns.insert(std::make_pair(text, TextRun())).first;
+         buildTextRun(text, textRun->second);
+         textRun->second.usagePosition = mTextRunUsage.insert(mTextRunUsage.begin(), textRun);
+         mTextRunBytes += textRun->second.bytes;
+
+         // Make room by dropping the least recently used runs (but never the new one)
+         while(mTextRunBytes > TEXT_RUN_BUDGET && mTextRunUsage.back() != textRun)
+         {
+            evictTextRun(mTextRunUsage.back());
+         }
       }
 
-      gcn::OpenGLImage *img = new gcn::OpenGLImage((unsigned int*)textSurface->pixels, textSurface->w, textSurface->h);
-      openGlGraphics->drawImage(img, 0, 0, x, y + yoffset, textSurface->w, textSurface->h);
-      delete img;
+      textRun->second.lastUsedFrame = sFrame;
+      return textRun->second;
+   }
 
-      SDL_FreeSurface(textSurface);
+   void OpenGLTrueTypeFont::evictTextRun(TextRunMap::iterator textRun)
+   {
+      mTextRunBytes -= textRun->second.bytes;
+      mTextRunUsage.erase(textRun->second.usagePosition);
+      mTextRuns.erase(textRun);
    }
-    
+
+   void OpenGLTrueTypeFont::evictIdleTextRuns()
+   {
+      mLastEvictionFrame = sFrame;
+
+      while(!mTextRunUsage.empty()
+            && mTextRunUsage.back()->second.lastUsedFrame + TEXT_RUN_MAX_IDLE_FRAMES < sFrame)
+      {
+         evictTextRun(mTextRunUsage.back());
+      }
+
+      if(sFrame - mLastReportFrame >= TEXT_RUN_REPORT_FRAMES)
+      {
+         const unsigned int lookups = mTextRunHits + mTextRunMisses;
+         if(lookups > 0)
+         {
+            DEBUG("Text run cache for %s: %u%% hit rate (%u hits, %u misses), %u runs using %u bytes.",
+                  mFilename.c_str(), mTextRunHits * 100 / lookups, mTextRunHits, mTextRunMisses,
+                  (unsigned int)mTextRuns.size(), mTextRunBytes);
+         }
+
+         mLastReportFrame = sFrame;
+         mTextRunHits = 0;
+         mTextRunMisses = 0;
+      }
+   }
+
+   void OpenGLTrueTypeFont::clearTextRuns()
+   {
+      mTextRuns.clear();
+      mTextRunUsage.clear();
+      mTextRunBytes = 0;
+   }
+
    void OpenGLTrueTypeFont::setRowSpacing(int spacing)
    {
       mRowSpacing = spacing;
@@ -177,7 +464,17 @@ namespace edwt
 
    void OpenGLTrueTypeFont::setAntiAlias(bool antiAlias)
    {
+      if(antiAlias == mAntiAlias) return;
+
       mAntiAlias = antiAlias;
+
+      // The rasterized glyphs no longer match, so they are rasterized again on demand
+      clearTextRuns();
+      mAtlas.clear();
+      for(int i = 0; i < 256; ++i)
+      {
+         mGlyphs[i].rasterized = false;
+      }
    }
 
    bool OpenGLTrueTypeFont::isAntiAlias()
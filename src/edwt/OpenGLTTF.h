@@ -63,17 +63,24 @@
 #ifndef GCN_SDLTRUETYPEFONT_HPP
 #define GCN_SDLTRUETYPEFONT_HPP
 
+#include <list>
 #include <map>
 #include <string>
+#include <vector>
 
 #include "SDL_ttf.h"
 #include "guichan/font.hpp"
+#include "GlyphAtlas.h"
 
 namespace edwt
 {
    /**
     * OpenGL True Type Font implementation of Font. It uses the SDL_ttf library
-    * and pipes the SDL display to an OpenGLImage texture.
+    * to rasterize each glyph once into a glyph atlas, and draws strings as
+    * textured quads out of the atlas. Glyph metrics and kerning are cached
+    * as well, so measuring a string does not go through SDL_ttf either.
+    * The quads of recently drawn strings are kept in a least-recently-used
+    * cache, so that static labels are not laid out again every frame.
     *
     * NOTE: You must initialize the SDL_ttf library before using this
     *       class. Also, remember to call the SDL_ttf libraries quit
@@ -147,6 +154,25 @@ namespace edwt
          virtual int getWidth(const std::string& text) const;
          virtual int getHeight() const;        
          virtual void drawString(gcn::Graphics* graphics, const std::string& text, int x, int y);
+
+         /**
+          * Draw the first characters of a string, exactly where they are drawn
+          * as part of the whole string. The whole string is laid out (and cached),
+          * so revealing a string a few characters at a time does not lay it out again.
+          *
+          * @param graphics The graphics object to draw with.
+          * @param text The whole string.
+          * @param x The x-location to draw the string at.
+          * @param y The y-location to draw the string at.
+          * @param numCharacters The number of characters at the start of the string to draw.
+          */
+         void drawStringPrefix(gcn::Graphics* graphics, const std::string& text, int x, int y, unsigned int numCharacters);
+
+         /**
+          * Mark the end of a frame. Cached text runs that have not been drawn
+          * for a while are evicted by each font as it draws the next frame.
+          */
+         static void finishFrame();
       
       protected:
          TTF_Font *mFont;
@@ -157,6 +183,179 @@ namespace edwt
 
          std::string mFilename;
          bool mAntiAlias;      
+
+      private:
+         /** The cached metrics of a glyph and its location in the glyph atlas. */
+         struct Glyph
+         {
+            /** true iff the metrics of the glyph have been loaded. */
+            bool measured;
+
+            /** true iff the glyph has been added to the atlas. */
+            bool rasterized;
+
+            /** The leftmost extent of the glyph, relative to the pen position. */
+            int minX;
+
+            /** The rightmost extent of the glyph, relative to the pen position. */
+            int maxX;
+
+            /** The distance to move the pen after the glyph. */
+            int advance;
+
+            /** The width of the glyph's image in the atlas. */
+            int width;
+
+            /** The location of the glyph's image in the atlas. */
+            GlyphAtlas::Region region;
+         };
+
+         /** A sequence of consecutive glyph quads drawn from the same atlas page. */
+         struct Run
+         {
+            /** The atlas page to draw the quads with. */
+            GLuint texture;
+
+            /** The number of quads in the run. */
+            unsigned int numQuads;
+         };
+
+         /** The glyphs of the font, indexed by (Latin-1) character. */
+         mutable Glyph mGlyphs[256];
+
+         /** The rasterized glyphs of the font. */
+         GlyphAtlas mAtlas;
+
+         /** The kerning between pairs of characters, keyed by (first character << 8 | second character). */
+         mutable std::map<unsigned short, int> mKerning;
+
+         struct TextRun;
+
+         /** The cached text runs, keyed by string. */
+         typedef std::map<std::string, TextRun> TextRunMap;
+
+         /** The cached text runs, from most to least recently used. */
+         typedef std::list<TextRunMap::iterator> TextRunList;
+
+         /** The laid out quads of a string, ready to be drawn. */
+         struct TextRun
+         {
+            /** The vertex coordinates of the glyphs (4 vertices per glyph), relative to the string's top-left corner. */
+            std::vector<float> vertices;
+
+            /** The texture coordinates of the glyphs, parallel to the vertex coordinates. */
+            std::vector<float> texCoords;
+
+            /** The atlas page runs of the glyphs. */
+            std::vector<Run> runs;
+
+            /** The approximate memory used by the text run (in bytes). */
+            unsigned int bytes;
+
+            /** The frame that the text run was last drawn in. */
+            unsigned int lastUsedFrame;
+
+            /** The position of the text run in the usage list. */
+            TextRunList::iterator usagePosition;
+         };
+
+         /** The maximum memory (in bytes) used by the cached text runs of a font. */
+         static const unsigned int TEXT_RUN_BUDGET;
+
+         /** The number of frames a text run stays cached without being drawn. */
+         static const unsigned int TEXT_RUN_MAX_IDLE_FRAMES;
+
+         /** The number of frames between reports of the cache hit rate. */
+         static const unsigned int TEXT_RUN_REPORT_FRAMES;
+
+         /** The number of frames finished so far. */
+         static unsigned int sFrame;
+
+         /** The cached text runs. */
+         TextRunMap mTextRuns;
+
+         /** The usage order of the cached text runs. */
+         TextRunList mTextRunUsage;
+
+         /** The memory (in bytes) used by the cached text runs. */
+         unsigned int mTextRunBytes;
+
+         /** The frame that idle text runs were last evicted in. */
+         unsigned int mLastEvictionFrame;
+
+         /** The frame that the cache hit rate was last reported in. */
+         unsigned int mLastReportFrame;
+
+         /** The number of strings drawn from the cache since the last report. */
+         unsigned int mTextRunHits;
+
+         /** The number of strings laid out since the last report. */
+         unsigned int mTextRunMisses;
+
+         /**
+          * Lay out the glyph quads of a string.
+          *
+          * @param text The string to lay out.
+          * @param textRun The text run to fill with the string's quads.
+          */
+         void buildTextRun(const std::string& text, TextRun& textRun);
+
+         /**
+          * @param text The string to draw.
+          *
+          * @return The cached text run of the string, which is laid out first if it isn't cached.
+          */
+         const TextRun& getTextRun(const std::string& text);
+
+         /**
+          * Remove a text run from the cache.
+          *
+          * @param textRun The position of the text run in the cache.
+          */
+         void evictTextRun(TextRunMap::iterator textRun);
+
+         /**
+          * Remove the text runs that have not been drawn for too long,
+          * and report the cache hit rate every once in a while.
+          */
+         void evictIdleTextRuns();
+
+         /**
+          * Remove all the text runs from the cache.
+          */
+         void clearTextRuns();
+
+         /**
+          * @param character The character to look up.
+          *
+          * @return The glyph of the character, with its metrics loaded.
+          */
+         const Glyph& getGlyph(unsigned char character) const;
+
+         /**
+          * @param character The character to look up.
+          *
+          * @return The glyph of the character, with its metrics loaded and its image in the atlas.
+          */
+         const Glyph& getRasterizedGlyph(unsigned char character);
+
+         /**
+          * @param previous The first character of the pair.
+          * @param next The second character of the pair.
+          *
+          * @return The adjustment (in pixels) to the pen position between the two characters.
+          */
+         int getKerning(unsigned char previous, unsigned char next) const;
+
+         /**
+          * Measure the width of a string the same way that SDL_ttf does.
+          *
+          * @param text The string to measure.
+          * @param useKerning true iff kerning should be applied between characters.
+          *
+          * @return The width (in pixels) of the rendered string.
+          */
+         int measureWidth(const std::string& text, bool useKerning) const;
    }; 
 }
 
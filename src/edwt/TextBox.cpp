@@ -9,6 +9,8 @@
 #include <SDL.h>
 #include "SDL_mixer.h"
 #include "StringListModel.h"
+#include "OpenGLTTF.h"
+#include <algorithm>
 
 const int debugFlag = DEBUG_EDWT;
 
@@ -34,12 +36,41 @@ namespace edwt
     
       graphics->setColor(getForegroundColor());
       graphics->setFont(getFont());
+
+      if (showingLayout)
+      {
+         drawLayout(graphics);
+         return;
+      }
    
       for (unsigned int i = 0; i < mTextRows.size(); i++)
       {
          graphics->drawText(mTextRows[i], determineX(mTextRows[i]), i * getFont()->getHeight());
       }
    }
+
+   void TextBox::drawLayout(gcn::Graphics* graphics)
+   {
+      OpenGLTrueTypeFont* trueTypeFont = dynamic_cast<OpenGLTrueTypeFont*>(getFont());
+      const int rowHeight = getFont()->getHeight();
+
+      for (unsigned int i = 0; i < layout.rows.size() && layout.rowStarts[i] < revealedLength; ++i)
+      {
+         const std::string& row = layout.rows[i];
+         const unsigned int numCharacters = std::min((unsigned int)row.size(), revealedLength - layout.rowStarts[i]);
+         const int x = determineX(layout.rowWidths[i]);
+
+         if (trueTypeFont != NULL)
+         {
+            // Draw part of the whole row, so that the row keeps its final position and its laid out glyphs
+            trueTypeFont->drawStringPrefix(graphics, row, x, i * rowHeight, numCharacters);
+         }
+         else
+         {
+            graphics->drawText(row.substr(0, numCharacters), x, i * rowHeight);
+         }
+      }
+   }
    
    void TextBox::adjustSize()
    {
@@ -60,16 +91,21 @@ namespace edwt
    }
    
    int TextBox::determineX(const std::string& text)
+   {
+      return determineX(getFont()->getWidth(text));
+   }
+
+   int TextBox::determineX(int textWidth)
    {
       switch(align)
       {
          case CENTER:
          {
-            return (getWidth() - getFont()->getWidth(text)) / 2;
+            return (getWidth() - textWidth) / 2;
          }
          case RIGHT:
          {
-            return (getWidth() - getFont()->getWidth(text)) - 1;
+            return (getWidth() - textWidth) - 1;
          }
          case LEFT:
          default:
@@ -92,10 +128,101 @@ namespace edwt
    void TextBox::setAlignment(TextAlignment alignment)
    {
       align = alignment;
+      markDirty();
    }
    
    TextAlignment TextBox::getAlignment()
    {
       return align;
    }
+
+   void TextBox::setText(const std::string& text)
+   {
+      showingLayout = false;
+      gcn::TextBox::setText(text);
+   }
+
+   void TextBox::layOutText(const std::string& text, TextLayout& textLayout)
+   {
+      textLayout.rows.clear();
+      textLayout.rowStarts.clear();
+      textLayout.rowWidths.clear();
+
+      gcn::Font* font = getFont();
+
+      // Text is drawn a pixel in from either edge
+      const int maxWidth = getWidth() - 2;
+
+      std::string::size_type rowStart = 0;
+      for (;;)
+      {
+         // A row ends at the next newline (or the end of the text), unless it is too wide
+         std::string::size_type rowEnd = text.find('\n', rowStart);
+         if (rowEnd == std::string::npos)
+         {
+            rowEnd = text.size();
+         }
+
+         std::string::size_type nextRowStart = rowEnd + 1;
+
+         if (font->getWidth(text.substr(rowStart, rowEnd - rowStart)) > maxWidth)
+         {
+            // Find the first character that doesn't fit (every row gets at least one character)
+            std::string::size_type fitEnd = rowStart + 1;
+            while (fitEnd < rowEnd && font->getWidth(text.substr(rowStart, fitEnd + 1 - rowStart)) <= maxWidth)
+            {
+               ++fitEnd;
+            }
+
+            // Break at the last space that fits, dropping the space; a word
+            // that is wider than the text box is broken wherever it stops fitting
+            std::string::size_type space = text.rfind(' ', fitEnd);
+            if (space != std::string::npos && space > rowStart)
+            {
+               rowEnd = space;
+               nextRowStart = space + 1;
+            }
+            else
+            {
+               rowEnd = fitEnd;
+               nextRowStart = fitEnd;
+            }
+         }
+
+         const std::string row = text.substr(rowStart, rowEnd - rowStart);
+         textLayout.rows.push_back(row);
+         textLayout.rowStarts.push_back(rowStart);
+         textLayout.rowWidths.push_back(font->getWidth(row));
+
+         if (nextRowStart > text.size())
+         {
+            break;
+         }
+
+         rowStart = nextRowStart;
+      }
+   }
+
+   void TextBox::setLayout(const TextLayout& textLayout)
+   {
+      layout = textLayout;
+      showingLayout = true;
+      revealedLength = 0;
+
+      mCaretColumn = 0;
+      mCaretRow = 0;
+      mTextRows = layout.rows;
+
+      markDirty();
+      adjustSize();
+   }
+
+   void TextBox::setRevealedLength(unsigned int length)
+   {
+      if (length != revealedLength)
+      {
+         revealedLength = length;
+         markDirty();
+      }
+   }
 };
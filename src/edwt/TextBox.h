@@ -9,11 +9,14 @@
 
 #include "guichan.hpp"
 #include "TextAlignment.h"
+#include "TextLayout.h"
 
 namespace edwt
 {
    /**
     * Overrides the original Guichan Text Box to add text alignment (LEFT, CENTER, RIGHT).
+    * The text box can also show word-wrapped text that was laid out ahead of time,
+    * revealing it a few characters at a time without laying it out again.
     *
     * @author Noam Chitayat
     */
@@ -26,9 +29,28 @@ namespace edwt
          /** The text color of the TextBox */
          gcn::Color textColor;
 
+         /** true iff the text box is showing laid out text (rather than text set with setText). */
+         bool showingLayout;
+
+         /** The laid out text being shown. */
+         TextLayout layout;
+
+         /** The number of characters of the laid out text that are shown. */
+         unsigned int revealedLength;
+
          /** Determine the point in the x-axis where the text begins */
          int determineX(const std::string& text);
 
+         /** Determine the point in the x-axis where text of the given width (in pixels) begins */
+         int determineX(int textWidth);
+
+         /**
+          * Draw the revealed part of the laid out text.
+          *
+          * @param graphics The graphics driver to draw with.
+          */
+         void drawLayout(gcn::Graphics* graphics);
+
       protected:
          /**
           * Size adjustment is overridden to retain current width.
@@ -44,7 +66,38 @@ namespace edwt
           *
           * Text is left-aligned by default.
           */
-         TextBox() : align(LEFT) {}
+         TextBox() : align(LEFT), showingLayout(false), revealedLength(0) {}
+
+         /**
+          * Set the text of the text box, replacing any laid out text.
+          *
+          * @param text The text to show, with rows separated by newlines.
+          */
+         void setText(const std::string& text);
+
+         /**
+          * Break text into rows that fit the current width of the text box
+          * (breaking at spaces where possible, and always at newlines) and
+          * measure the rows with the current font.
+          *
+          * @param text The text to lay out.
+          * @param textLayout The layout to fill with the rows of the text.
+          */
+         void layOutText(const std::string& text, TextLayout& textLayout);
+
+         /**
+          * Show laid out text, with none of its characters revealed yet.
+          *
+          * @param textLayout Text that was laid out for this text box by layOutText.
+          */
+         void setLayout(const TextLayout& textLayout);
+
+         /**
+          * Reveal the start of the laid out text.
+          *
+          * @param length The number of characters (counted in the original text) to show.
+          */
+         void setRevealedLength(unsigned int length);
 
          /**
           * Scroll to the bottom row of the text box.
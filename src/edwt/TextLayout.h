@@ -0,0 +1,35 @@
+/*
+ *  This file is covered by the Ruby license. See LICENSE.txt for more details.
+ *
+ *  Copyright (C) 2007-2012 Noam Chitayat. All rights reserved.
+ */
+
+#ifndef TEXT_LAYOUT_H
+#define TEXT_LAYOUT_H
+
+#include <string>
+#include <vector>
+
+namespace edwt
+{
+   /**
+    * A string of text broken into rows that fit a text box, along with the
+    * measurements needed to draw it. Text is laid out once (with TextBox::layOutText)
+    * and can then be shown any number of times, in whole or in part.
+    *
+    * @author Noam Chitayat
+    */
+   struct TextLayout
+   {
+      /** The rows of the text, without the spaces and newlines that they were broken at. */
+      std::vector<std::string> rows;
+
+      /** The index in the original text of the first character of each row. */
+      std::vector<unsigned int> rowStarts;
+
+      /** The width (in pixels) of each row. */
+      std::vector<int> rowWidths;
+   };
+};
+
+#endif
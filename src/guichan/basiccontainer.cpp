@@ -63,6 +63,8 @@ namespace gcn
 
     void BasicContainer::moveToTop(Widget* widget)
     {
+        markDirty();
+
         WidgetListIterator iter;
         for (iter = mWidgets.begin(); iter != mWidgets.end(); iter++)
         {
@@ -79,6 +81,8 @@ namespace gcn
 
     void BasicContainer::moveToBottom(Widget* widget)
     {
+        markDirty();
+
         WidgetListIterator iter;
         iter = find(mWidgets.begin(), mWidgets.end(), widget);
 
@@ -92,6 +96,8 @@ namespace gcn
 
     void BasicContainer::death(const Event& event)
     {
+        markDirty();
+
         WidgetListIterator iter;
         iter = find(mWidgets.begin(), mWidgets.end(), event.getSource());
 
@@ -227,6 +233,8 @@ namespace gcn
 
     void BasicContainer::add(Widget* widget)
     {
+        markDirty();
+
         mWidgets.push_back(widget);
 
         if (mInternalFocusHandler == NULL)
@@ -244,6 +252,8 @@ namespace gcn
 
     void BasicContainer::remove(Widget* widget)
     {
+        markDirty();
+
         WidgetListIterator iter;
         for (iter = mWidgets.begin(); iter != mWidgets.end(); iter++)
         {
@@ -262,6 +272,8 @@ namespace gcn
 
     void BasicContainer::clear()
     {
+        markDirty();
+
         WidgetListIterator iter;
 
         for (iter = mWidgets.begin(); iter != mWidgets.end(); iter++)
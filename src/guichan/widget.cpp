@@ -82,7 +82,8 @@ namespace gcn
               mTabIn(true),
               mTabOut(true),
               mEnabled(true),
-              mCurrentFont(NULL)
+              mCurrentFont(NULL),
+              mDirty(true)
     {
         mWidgets.push_back(this);
     }
@@ -128,6 +129,8 @@ namespace gcn
 
     void Widget::_setParent(Widget* parent)
     {
+        markDirty();
+
         mParent = parent;
     }
 
@@ -205,18 +208,22 @@ namespace gcn
         if (mDimension.width != oldDimension.width
             || mDimension.height != oldDimension.height)
         {
+            markDirty();
             distributeResizedEvent();
         }
 
         if (mDimension.x != oldDimension.x
             || mDimension.y != oldDimension.y)
         {
+            markDirty();
             distributeMovedEvent();
         }
     }
 
     void Widget::setFrameSize(unsigned int frameSize)
     {
+        markDirty();
+
         mFrameSize = frameSize;
     }
 
@@ -225,6 +232,25 @@ namespace gcn
         return mFrameSize;
     }
 
+    void Widget::markDirty()
+    {
+        // Whatever contains a changed widget has to be redrawn as well
+        for (Widget* widget = this; widget != NULL; widget = widget->mParent)
+        {
+            widget->mDirty = true;
+        }
+    }
+
+    bool Widget::isDirty() const
+    {
+        return mDirty;
+    }
+
+    void Widget::clearDirty()
+    {
+        mDirty = false;
+    }
+
     const Rectangle& Widget::getDimension() const
     {
         return mDimension;
@@ -267,6 +293,8 @@ namespace gcn
 
     void Widget::requestFocus()
     {
+        markDirty();
+
         if (mFocusHandler == NULL)
         {
             throw GCN_EXCEPTION("No focushandler set (did you add the widget to the gui?).");
@@ -296,6 +324,8 @@ namespace gcn
 
     void Widget::setVisible(bool visible)
     {
+        markDirty();
+
         if (!visible && isFocused())
         {
             mFocusHandler->focusNone();
@@ -327,6 +357,8 @@ namespace gcn
 
     void Widget::setBaseColor(const Color& color)
     {
+        markDirty();
+
         mBaseColor = color;
     }
 
@@ -337,6 +369,8 @@ namespace gcn
 
     void Widget::setForegroundColor(const Color& color)
     {
+        markDirty();
+
         mForegroundColor = color;
     }
 
@@ -347,6 +381,8 @@ namespace gcn
 
     void Widget::setBackgroundColor(const Color& color)
     {
+        markDirty();
+
         mBackgroundColor = color;
     }
 
@@ -357,6 +393,8 @@ namespace gcn
 
     void Widget::setSelectionColor(const Color& color)
     {
+        markDirty();
+
         mSelectionColor = color;
     }
 
@@ -495,6 +533,8 @@ namespace gcn
 
     void Widget::setFont(Font* font)
     {
+        markDirty();
+
         mCurrentFont = font;
         fontChanged();
     }
@@ -546,6 +586,8 @@ namespace gcn
 
     void Widget::setEnabled(bool enabled)
     {
+        markDirty();
+
         mEnabled = enabled;
     }
 
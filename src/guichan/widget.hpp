@@ -440,6 +440,36 @@ namespace gcn
          */
         virtual void requestFocus();
 
+        /**
+         * Marks the widget as changed since it was last drawn. Every
+         * ancestor of the widget is marked as well, so that a cached
+         * drawing of the top widget can tell that it needs to be redrawn.
+         *
+         * Widgets mark themselves whenever one of their properties that
+         * affects their appearance changes. Code that changes what a widget
+         * displays behind its back (such as the contents of a list model)
+         * must mark the widget itself.
+         *
+         * @see isDirty, clearDirty
+         */
+        void markDirty();
+
+        /**
+         * Checks if the widget (or one of its children) has changed since
+         * the dirty flag was last cleared.
+         *
+         * @return True if the widget has changed, false otherwise.
+         * @see markDirty
+         */
+        bool isDirty() const;
+
+        /**
+         * Clears the dirty flag of the widget, once it has been drawn.
+         *
+         * @see markDirty
+         */
+        void clearDirty();
+
         /**
          * Requests a move to the top in the parent widget.
          */
@@ -1174,6 +1204,11 @@ namespace gcn
          */
         Font* mCurrentFont;
 
+        /**
+         * True if the widget has changed since it was last drawn.
+         */
+        bool mDirty;
+
         /**
          * Holds the default font used by the widget.
          */
@@ -91,6 +91,8 @@ namespace gcn
 
     void Button::setCaption(const std::string& caption)
     {
+        markDirty();
+
         mCaption = caption;
     }
 
@@ -101,6 +103,8 @@ namespace gcn
 
     void Button::setAlignment(Graphics::Alignment alignment)
     {
+        markDirty();
+
         mAlignment = alignment;
     }
 
@@ -111,6 +115,8 @@ namespace gcn
 
     void Button::setSpacing(unsigned int spacing)
     {
+        markDirty();
+
         mSpacing = spacing;
     }
 
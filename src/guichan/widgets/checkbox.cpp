@@ -134,6 +134,8 @@ namespace gcn
 
     void CheckBox::setSelected(bool selected)
     {
+        markDirty();
+
         mSelected = selected;
     }
 
@@ -144,6 +146,8 @@ namespace gcn
 
     void CheckBox::setCaption(const std::string& caption)
     {
+        markDirty();
+
         mCaption = caption;
     }
 
@@ -76,6 +76,8 @@ namespace gcn
 
     void Container::setOpaque(bool opaque)
     {
+        markDirty();
+
         mOpaque = opaque;
     }
 
@@ -280,6 +280,8 @@ namespace gcn
 
     void DropDown::setSelected(int selected)
     {
+        markDirty();
+
         if (selected >= 0)
         {
             mListBox->setSelected(selected);
@@ -389,6 +391,8 @@ namespace gcn
 
     void DropDown::setListModel(ListModel *listModel)
     {
+        markDirty();
+
         mListBox->setListModel(listModel);
 
         if (mListBox->getSelected() < 0)
@@ -88,6 +88,8 @@ namespace gcn
 
     void ImageButton::setImage(const Image* image)
     {
+        markDirty();
+
         if (mInternalImage)
         {
             delete mImage;
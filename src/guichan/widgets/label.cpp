@@ -74,11 +74,15 @@ namespace gcn
 
     void Label::setCaption(const std::string& caption)
     {
+        markDirty();
+
         mCaption = caption;
     }
 
     void Label::setAlignment(Graphics::Alignment alignment)
     {
+        markDirty();
+
         mAlignment = alignment;
     }
 
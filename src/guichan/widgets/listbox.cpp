@@ -165,6 +165,8 @@ namespace gcn
 
     void ListBox::setSelected(int selected)
     {
+        markDirty();
+
         if (mListModel == NULL)
         {
             mSelected = -1;
@@ -294,6 +296,8 @@ namespace gcn
 
     void ListBox::setListModel(ListModel *listModel)
     {
+        markDirty();
+
         mSelected = -1;
         mListModel = listModel;
         adjustSize();
@@ -319,6 +323,8 @@ namespace gcn
 
     void ListBox::setWrappingEnabled(bool wrappingEnabled)
     {
+        markDirty();
+
         mWrappingEnabled = wrappingEnabled;
     }
         
@@ -199,6 +199,8 @@ namespace gcn
 
     void RadioButton::setSelected(bool selected)
     {
+        markDirty();
+
         if (selected && mGroup != "")
         {
             GroupIterator iter, iterEnd;
@@ -225,6 +227,8 @@ namespace gcn
 
     void RadioButton::setCaption(const std::string caption)
     {
+        markDirty();
+
         mCaption = caption;
     }
 
@@ -129,6 +129,8 @@ namespace gcn
 
     void ScrollArea::setContent(Widget* widget)
     {
+        markDirty();
+
         if (widget != NULL)
         {
             clear();
@@ -155,6 +157,8 @@ namespace gcn
 
     void ScrollArea::setHorizontalScrollPolicy(ScrollPolicy hPolicy)
     {
+        markDirty();
+
         mHPolicy = hPolicy;
         checkPolicies();
     }
@@ -166,6 +170,8 @@ namespace gcn
 
     void ScrollArea::setVerticalScrollPolicy(ScrollPolicy vPolicy)
     {
+        markDirty();
+
         mVPolicy = vPolicy;
         checkPolicies();
     }
@@ -185,6 +191,7 @@ namespace gcn
     void ScrollArea::setVerticalScrollAmount(int vScroll)
     {
         int max = getVerticalMaxScroll();
+        int oldVScroll = mVScroll;
 
         mVScroll = vScroll;
 
@@ -197,6 +204,13 @@ namespace gcn
         {
             mVScroll = 0;
         }
+
+        // logic() clamps the scroll amounts every frame, so only mark
+        // the scroll area as dirty if it actually scrolled
+        if (mVScroll != oldVScroll)
+        {
+            markDirty();
+        }
     }
 
     int ScrollArea::getVerticalScrollAmount() const
@@ -207,6 +221,7 @@ namespace gcn
     void ScrollArea::setHorizontalScrollAmount(int hScroll)
     {
         int max = getHorizontalMaxScroll();
+        int oldHScroll = mHScroll;
 
         mHScroll = hScroll;
 
@@ -218,6 +233,11 @@ namespace gcn
         {
             mHScroll = 0;
         }
+
+        if (mHScroll != oldHScroll)
+        {
+            markDirty();
+        }
     }
 
     int ScrollArea::getHorizontalScrollAmount() const
@@ -275,6 +295,8 @@ namespace gcn
 
     void ScrollArea::setScrollbarWidth(int width)
     {
+        markDirty();
+
         if (width > 0)
         {
             mScrollbarWidth = width;
@@ -1231,6 +1253,8 @@ namespace gcn
 
     void ScrollArea::setOpaque(bool opaque)
     {
+        markDirty();
+
         mOpaque = opaque;
     }
 
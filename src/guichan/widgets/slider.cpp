@@ -91,6 +91,8 @@ namespace gcn
 
     void Slider::setScale(double scaleStart, double scaleEnd)
     {
+        markDirty();
+
         mScaleStart = scaleStart;
         mScaleEnd = scaleEnd;
     }
@@ -102,6 +104,8 @@ namespace gcn
 
     void Slider::setScaleStart(double scaleStart)
     {
+        markDirty();
+
         mScaleStart = scaleStart;
     }
 
@@ -112,6 +116,8 @@ namespace gcn
 
     void Slider::setScaleEnd(double scaleEnd)
     {
+        markDirty();
+
         mScaleEnd = scaleEnd;
     }
 
@@ -214,6 +220,8 @@ namespace gcn
 
     void Slider::setValue(double value)
     {
+        markDirty();
+
         if (value > getScaleEnd())
         {
             mValue = getScaleEnd();
@@ -241,6 +249,8 @@ namespace gcn
 
     void Slider::setMarkerLength(int length)
     {
+        markDirty();
+
         mMarkerLength = length;
     }
 
@@ -282,6 +292,8 @@ namespace gcn
 
     void Slider::setOrientation(Slider::Orientation orientation)
     {
+        markDirty();
+
         mOrientation = orientation;
     }
 
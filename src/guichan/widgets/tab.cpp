@@ -94,6 +94,8 @@ namespace gcn
 
     void Tab::setCaption(const std::string& caption)
     {
+        markDirty();
+
         mLabel->setCaption(caption);
         mLabel->adjustSize();
         adjustSize();
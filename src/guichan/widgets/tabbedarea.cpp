@@ -212,6 +212,8 @@ namespace gcn
 
     void TabbedArea::setSelectedTab(Tab* tab)
     {
+        markDirty();
+
         unsigned int i;
         for (i = 0; i < mTabs.size(); i++)
         {
@@ -252,6 +254,8 @@ namespace gcn
 
     void TabbedArea::setOpaque(bool opaque)
     {
+        markDirty();
+
         mOpaque = opaque;
     }
 
@@ -89,6 +89,8 @@ namespace gcn
 
     void TextBox::setText(const std::string& text)
     {
+        markDirty();
+
         mCaretColumn = 0;
         mCaretRow = 0;
 
@@ -350,6 +352,8 @@ namespace gcn
 
     void TextBox::setCaretPosition(unsigned int position)
     {
+        markDirty();
+
         int row;
 
         for (row = 0; row < (int)mTextRows.size(); row++)
@@ -391,6 +395,8 @@ namespace gcn
 
     void TextBox::setCaretRow(int row)
     {
+        markDirty();
+
         mCaretRow = row;
 
         if (mCaretRow >= (int)mTextRows.size())
@@ -413,6 +419,8 @@ namespace gcn
 
     void TextBox::setCaretColumn(int column)
     {
+        markDirty();
+
         mCaretColumn = column;
 
         if (mCaretColumn > (int)mTextRows[mCaretRow].size())
@@ -438,6 +446,8 @@ namespace gcn
 
     void TextBox::setTextRow(int row, const std::string& text)
     {
+        markDirty();
+
         mTextRows[row] = text;
 
         if (mCaretRow == row)
@@ -491,6 +501,8 @@ namespace gcn
 
     void TextBox::setEditable(bool editable)
     {
+        markDirty();
+
         mEditable = editable;
     }
 
@@ -501,6 +513,8 @@ namespace gcn
 
     void TextBox::addRow(const std::string row)
     {
+        markDirty();
+
         mTextRows.push_back(row);
         adjustSize();
     }
@@ -512,6 +526,8 @@ namespace gcn
 
     void TextBox::setOpaque(bool opaque)
     {
+        markDirty();
+
         mOpaque = opaque;
     }
 }
@@ -81,6 +81,8 @@ namespace gcn
 
     void TextField::setText(const std::string& text)
     {
+        markDirty();
+
         if(text.size() < mCaretPosition )
         {
             mCaretPosition = text.size();
@@ -251,6 +253,8 @@ namespace gcn
 
     void TextField::setCaretPosition(unsigned int position)
     {
+        markDirty();
+
         if (position > mText.size())
         {
             mCaretPosition = mText.size();
@@ -85,6 +85,8 @@ namespace gcn
 
     void Window::setPadding(unsigned int padding)
     {
+        markDirty();
+
         mPadding = padding;
     }
 
@@ -95,6 +97,8 @@ namespace gcn
 
     void Window::setTitleBarHeight(unsigned int height)
     {
+        markDirty();
+
         mTitleBarHeight = height;
     }
 
@@ -105,6 +109,8 @@ namespace gcn
 
     void Window::setCaption(const std::string& caption)
     {
+        markDirty();
+
         mCaption = caption;
     }
 
@@ -115,6 +121,8 @@ namespace gcn
 
     void Window::setAlignment(Graphics::Alignment alignment)
     {
+        markDirty();
+
         mAlignment = alignment;
     }
 
@@ -277,6 +285,8 @@ namespace gcn
 
     void Window::setOpaque(bool opaque)
     {
+        markDirty();
+
         mOpaque = opaque;
     }
 
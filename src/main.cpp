@@ -5,39 +5,395 @@
  */
 
 #include "GraphicsUtil.h"
+#include "RenderTexture.h"
+#include "InputBuffer.h"
+#include "InputRecording.h"
+#include "FrameTelemetry.h"
+#include "Job.h"
+#include "JobSystem.h"
+#include "Tracer.h"
 #include "ScriptEngine.h"
 #include "ExecutionStack.h"
 #include "MainMenu.h"
+#include "TileEngine.h"
+#include "Actor.h"
 #include "ResourceLoader.h"
 #include "guichan.hpp"
 #include <iostream>
 #include <fstream>
+#include <stdlib.h>
+#include <time.h>
 
 #include "SDL.h"
 
 #include "DebugUtils.h"
 const int debugFlag = DEBUG_MAIN;
 
+/**
+ * Simulate a chapter in the tile engine without a display, audio or OpenGL context.
+ * Prints how long the simulation took and where each actor ended up. Given the same
+ * chapter, input and number of ticks, the actors always end up in the same places, so the
+ * output of different builds can be compared to catch regressions.
+ *
+ * @param chapterName The name of the chapter to simulate.
+ * @param playerDataPath The path of the saved game to start from (empty if none).
+ * @param numTicks The number of logic ticks to simulate.
+ */
+static void simulateChapter(const std::string& chapterName, const std::string& playerDataPath, unsigned long numTicks)
+{
+   GraphicsUtil::setHeadless(true);
+
+   // Only the timer is needed, to measure how long the simulation takes
+   SDL_Init(SDL_INIT_TIMER);
+
+   ExecutionStack stack;
+   TileEngine* tileEngine = new TileEngine(stack, chapterName, playerDataPath);
+   stack.pushState(tileEngine);
+
+   const Uint32 startTime = SDL_GetTicks();
+   const unsigned long ticksRun = stack.simulate(numTicks);
+   const Uint32 simulationTime = SDL_GetTicks() - startTime;
+
+   std::cout << "Simulated " << ticksRun << " ticks in " << simulationTime << " ms." << std::endl;
+
+   // The tile engine is popped (and deleted) if the simulation finished it
+   if(!stack.isEmpty())
+   {
+      const std::vector<Actor*> actors = tileEngine->collectActors();
+      for(std::vector<Actor*>::const_iterator iter = actors.begin(); iter != actors.end(); ++iter)
+      {
+         const shapes::Point2D& location = (*iter)->getLocation();
+         std::cout << (*iter)->getName() << " " << location.x << " " << location.y << std::endl;
+      }
+   }
+}
+
+/**
+ * Play a chapter in the tile engine on screen, skipping the title screen.
+ *
+ * @param chapterName The name of the chapter to play.
+ * @param playerDataPath The path of the saved game to start from (empty if none).
+ *
+ * @return The number of logic ticks that the session ran for.
+ */
+static unsigned long playChapter(const std::string& chapterName, const std::string& playerDataPath)
+{
+   GraphicsUtil::getInstance();
+   ExecutionStack stack;
+   stack.pushState(new TileEngine(stack, chapterName, playerDataPath));
+   stack.execute();
+
+   return stack.getTickCount();
+}
+
+/**
+ * Simulate a chapter in the tile engine and, after every tick, draw the frame off-screen
+ * both with depth ordering and in plain row order, comparing the pixels of the two drawings.
+ * Prints the ticks whose drawings differ.
+ *
+ * @param chapterName The name of the chapter to simulate.
+ * @param numTicks The number of logic ticks to simulate.
+ *
+ * @return true iff the two drawings matched on every tick.
+ */
+static bool compareDrawOrders(const std::string& chapterName, unsigned long numTicks)
+{
+   GraphicsUtil::getInstance();
+   if(!RenderTexture::isSupported())
+   {
+      std::cout << "Render textures are not supported, so the drawings can't be compared." << std::endl;
+      return false;
+   }
+
+   ExecutionStack stack;
+   TileEngine* tileEngine = new TileEngine(stack, chapterName);
+   stack.pushState(tileEngine);
+
+   // Big enough to hold the whole screen
+   RenderTexture target(shapes::Size(1024, 1024), true);
+
+   unsigned long ticksCompared = 0;
+   unsigned long ticksDiffering = 0;
+   while(ticksCompared < numTicks)
+   {
+      // The tile engine is popped (and deleted) if the simulation finished it
+      if(stack.simulate(1) == 0 || stack.isEmpty()) break;
+
+      const unsigned int differentPixels = tileEngine->compareDrawOrders(target);
+      if(differentPixels > 0)
+      {
+         std::cout << "Tick " << ticksCompared << ": " << differentPixels << " pixels differ." << std::endl;
+         ++ticksDiffering;
+      }
+
+      ++ticksCompared;
+   }
+
+   std::cout << "Compared " << ticksCompared << " ticks; " << ticksDiffering << " differed." << std::endl;
+   return ticksDiffering == 0;
+}
+
+/**
+ * A job with no work, used to measure the cost of scheduling a job.
+ *
+ * @author Noam Chitayat
+ */
+class EmptyJob : public Job
+{
+   protected:
+      /**
+       * Does nothing.
+       */
+      void run()
+      {
+      }
+};
+
+/**
+ * A job that keeps the processor busy for a fixed number of iterations,
+ * used to measure how the job system scales with the number of workers.
+ *
+ * @author Noam Chitayat
+ */
+class BusyJob : public Job
+{
+   /** The number of iterations to run. */
+   const unsigned long numIterations;
+
+   protected:
+      /**
+       * Run the iterations, keeping the result so that they can't be optimized away.
+       */
+      void run()
+      {
+         unsigned long value = result;
+         for(unsigned long i = 0; i < numIterations; ++i)
+         {
+            value = value * 1664525UL + 1013904223UL;
+         }
+
+         result = value;
+      }
+
+   public:
+      /** The result of the iterations. */
+      unsigned long result;
+
+      /**
+       * Constructor.
+       *
+       * @param numIterations The number of iterations to run.
+       */
+      BusyJob(unsigned long numIterations) : numIterations(numIterations), result(0)
+      {
+      }
+};
+
+/**
+ * Microbenchmarks of the job system, printing the results. Measures:
+ * - the overhead of starting a single job and waiting for it (including its completion),
+ * - the throughput of many jobs started at once and joined by a barrier,
+ * - the time taken by a fixed amount of work, split between one to (workers + 1) threads.
+ *
+ * @param numJobs The number of empty jobs to run in the overhead and throughput benchmarks.
+ */
+static void benchmarkJobSystem(unsigned long numJobs)
+{
+   GraphicsUtil::setHeadless(true);
+
+   // Only the timer (and threads) are needed
+   SDL_Init(SDL_INIT_TIMER);
+
+   JobSystem* jobSystem = JobSystem::getInstance();
+   const unsigned int numWorkers = jobSystem->getWorkerCount();
+   std::cout << "Benchmarking " << numWorkers << " job workers." << std::endl;
+
+   Uint32 startTime = SDL_GetTicks();
+   for(unsigned long i = 0; i < numJobs; ++i)
+   {
+      Job* job = new EmptyJob();
+      jobSystem->start(job);
+      jobSystem->wait(job);
+      jobSystem->runContinuations();
+   }
+
+   Uint32 elapsedTime = SDL_GetTicks() - startTime;
+   std::cout << "Start and wait: " << numJobs << " jobs in " << elapsedTime << " ms ("
+             << elapsedTime * 1000.0 / numJobs << " us per job)." << std::endl;
+
+   startTime = SDL_GetTicks();
+   BarrierJob* barrier = new BarrierJob();
+   for(unsigned long i = 0; i < numJobs; ++i)
+   {
+      Job* job = new EmptyJob();
+      barrier->addDependency(job);
+      jobSystem->start(job);
+   }
+
+   jobSystem->start(barrier);
+   jobSystem->wait(barrier);
+   jobSystem->runContinuations();
+
+   elapsedTime = SDL_GetTicks() - startTime;
+   std::cout << "Barrier fan-out: " << numJobs << " jobs in " << elapsedTime << " ms ("
+             << elapsedTime * 1000.0 / numJobs << " us per job)." << std::endl;
+
+   // Split the same work between more and more threads, up to every worker plus the main thread
+   const unsigned long TOTAL_ITERATIONS = 200000000UL;
+   Uint32 serialTime = 0;
+   for(unsigned int numThreads = 1; numThreads <= numWorkers + 1; ++numThreads)
+   {
+      startTime = SDL_GetTicks();
+      std::vector<BusyJob*> busyJobs;
+      for(unsigned int i = 0; i < numThreads; ++i)
+      {
+         BusyJob* job = new BusyJob(TOTAL_ITERATIONS / numThreads);
+         busyJobs.push_back(job);
+         jobSystem->start(job, false);
+      }
+
+      unsigned long result = 0;
+      for(std::vector<BusyJob*>::iterator iter = busyJobs.begin(); iter != busyJobs.end(); ++iter)
+      {
+         jobSystem->wait(*iter);
+         result += (*iter)->result;
+         delete *iter;
+      }
+
+      elapsedTime = SDL_GetTicks() - startTime;
+      if(numThreads == 1)
+      {
+         serialTime = elapsedTime;
+      }
+
+      std::cout << "Scaling: " << numThreads << " threads in " << elapsedTime << " ms (speedup "
+                << (elapsedTime > 0 ? double(serialTime) / elapsedTime : 0.0) << ", result " << result << ")." << std::endl;
+   }
+}
+
 /**
  * The main function.
  * Creates the graphics utilities, pushes a title screen onto the ExecutionStack,
  * and executes it. Afterwards, destroys graphics utilities and we're done.
+ *
+ * Other ways to run the game:
+ * - "--headless <chapter> <ticks>" simulates a chapter without a display.
+ * - "--record <recording> <chapter> [<saved game>]" plays a chapter and records the session's input.
+ * - "--replay <recording>" plays a recorded session back on screen, at real speed.
+ * - "--replay-headless <recording>" plays a recorded session back as fast as possible, without a display.
+ * - "--bench-jobs <jobs>" runs microbenchmarks of the job system's overhead and scaling.
+ * - "--compare-draw <chapter> <ticks>" checks that depth ordering draws the same pixels as row order,
+ *   exiting with an error if it doesn't.
+ *
+ * Any of these can be preceded by these options:
+ * - "--telemetry <file>" dumps the frame telemetry to a CSV file (or a JSON file,
+ *   if the file name ends in ".json") when the game exits.
+ * - "--trace <file>" captures a trace of the trace zones, which can be opened
+ *   in Chrome or Perfetto. Builds without TRACE_MODE have no trace zones.
  */
 int main (int argc, char *argv[])
 {  
+   // Write debug output on its own thread, so that it doesn't slow down the game
+   DebugUtils::startLogThread();
+
+   int exitCode = 0;
    try
    {
-      GraphicsUtil::getInstance();
-      DEBUG("Initializing execution stack.");
-      ExecutionStack stack;
-      DEBUG("Pushing Main Menu state.");
-      stack.pushState(new MainMenu(stack));
-      DEBUG("Beginning game execution.");
-      stack.execute();
+      while(argc > 2)
+      {
+         const std::string option = argv[1];
+         if(option == "--telemetry")
+         {
+            FrameTelemetry::getInstance()->setDumpPath(argv[2]);
+         }
+         else if(option == "--trace")
+         {
+            Tracer::start(argv[2]);
+         }
+         else
+         {
+            break;
+         }
+
+         argc -= 2;
+         argv += 2;
+      }
+
+      const std::string mode = argc > 1 ? argv[1] : "";
+      if(mode == "--headless" && argc == 4)
+      {
+         DEBUG("Simulating chapter %s without a display.", argv[2]);
+         simulateChapter(argv[2], "", strtoul(argv[3], NULL, 10));
+      }
+      else if(mode == "--record" && (argc == 4 || argc == 5))
+      {
+         // Every session gets a different random seed, which the recording remembers
+         const unsigned int seed = (unsigned int)time(NULL);
+         srand(seed);
+
+         InputRecording recording(argv[3], argc == 5 ? argv[4] : "", seed);
+         InputBuffer::getInstance()->startRecording(&recording);
+         DEBUG("Recording chapter %s to %s.", argv[3], argv[2]);
+         recording.setTickCount(playChapter(recording.getChapterName(), recording.getPlayerDataPath()));
+         InputBuffer::getInstance()->startRecording(NULL);
+
+         recording.save(argv[2]);
+      }
+      else if((mode == "--replay" || mode == "--replay-headless") && argc == 3)
+      {
+         InputRecording recording(argv[2]);
+         srand(recording.getSeed());
+
+         InputBuffer::getInstance()->startReplay(&recording);
+         DEBUG("Replaying %s.", argv[2]);
+         if(mode == "--replay")
+         {
+            playChapter(recording.getChapterName(), recording.getPlayerDataPath());
+         }
+         else
+         {
+            simulateChapter(recording.getChapterName(), recording.getPlayerDataPath(), recording.getTickCount());
+         }
+         InputBuffer::getInstance()->startReplay(NULL);
+      }
+      else if(mode == "--bench-jobs" && argc == 3)
+      {
+         benchmarkJobSystem(strtoul(argv[2], NULL, 10));
+      }
+      else if(mode == "--compare-draw" && argc == 4)
+      {
+         DEBUG("Comparing the draw orders of chapter %s.", argv[2]);
+         if(!compareDrawOrders(argv[2], strtoul(argv[3], NULL, 10)))
+         {
+            exitCode = 1;
+         }
+      }
+      else
+      {
+         GraphicsUtil::getInstance();
+         DEBUG("Initializing execution stack.");
+         ExecutionStack stack;
+         DEBUG("Pushing Main Menu state.");
+         stack.pushState(new MainMenu(stack));
+         DEBUG("Beginning game execution.");
+         stack.execute();
+      }
 
       DEBUG("Game is finished. Freeing resources and destroying singletons.");
       ResourceLoader::freeAll();
-      GraphicsUtil::destroy();
+      InputBuffer::destroy();
+      JobSystem::destroy();
+      if(GraphicsUtil::isHeadless())
+      {
+         SDL_Quit();
+      }
+      else
+      {
+         GraphicsUtil::destroy();
+      }
+
+      FrameTelemetry::destroy();
+      Tracer::stop();
    }
    catch (gcn::Exception& e)
    {
@@ -60,5 +416,5 @@ int main (int argc, char *argv[])
       return 1;
    }
 
-	return 0;
+	return exitCode;
 }